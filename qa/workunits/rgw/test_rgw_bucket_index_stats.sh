@@ -0,0 +1,5 @@
+#!/bin/sh -e
+
+ceph_test_rgw_bucket_index_stats
+
+exit 0
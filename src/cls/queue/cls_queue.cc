@@ -120,6 +120,44 @@ static int cls_queue_remove_entries(cls_method_context_t hctx, bufferlist *in, b
   return queue_write_head(hctx, head);
 }
 
+static int cls_queue_dequeue(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
+{
+  auto in_iter = in->cbegin();
+  cls_queue_dequeue_op op;
+  try {
+    decode(op, in_iter);
+  } catch (ceph::buffer::error& err) {
+    CLS_LOG(5, "ERROR: cls_queue_dequeue: failed to decode input data\n");
+    return -EINVAL;
+  }
+  if (op.max == 0) {
+    // listing always returns at least one chunk, which would then be removed
+    CLS_LOG(5, "ERROR: cls_queue_dequeue: max entries must be positive\n");
+    return -EINVAL;
+  }
+
+  cls_queue_head head;
+  auto ret = queue_read_head(hctx, head);
+  if (ret < 0) {
+    return ret;
+  }
+
+  cls_queue_list_ret op_ret;
+  ret = queue_dequeue(hctx, op, op_ret, head);
+  if (ret < 0) {
+    return ret;
+  }
+  if (!op_ret.entries.empty()) {
+    ret = queue_write_head(hctx, head);
+    if (ret < 0) {
+      return ret;
+    }
+  }
+
+  encode(op_ret, *out);
+  return 0;
+}
+
 CLS_INIT(queue)
 {
   CLS_LOG(1, "Loaded queue class!");
@@ -130,6 +168,7 @@ CLS_INIT(queue)
   cls_method_handle_t h_queue_enqueue;
   cls_method_handle_t h_queue_list_entries;
   cls_method_handle_t h_queue_remove_entries;
+  cls_method_handle_t h_queue_dequeue;
  
   cls_register(QUEUE_CLASS, &h_class);
 
@@ -139,6 +178,7 @@ CLS_INIT(queue)
   cls_register_cxx_method(h_class, QUEUE_ENQUEUE, CLS_METHOD_RD | CLS_METHOD_WR, cls_queue_enqueue, &h_queue_enqueue);
   cls_register_cxx_method(h_class, QUEUE_LIST_ENTRIES, CLS_METHOD_RD, cls_queue_list_entries, &h_queue_list_entries);
   cls_register_cxx_method(h_class, QUEUE_REMOVE_ENTRIES, CLS_METHOD_RD | CLS_METHOD_WR, cls_queue_remove_entries, &h_queue_remove_entries);
+  cls_register_cxx_method(h_class, QUEUE_DEQUEUE, CLS_METHOD_RD | CLS_METHOD_WR, cls_queue_dequeue, &h_queue_dequeue);
 
   return;
 }
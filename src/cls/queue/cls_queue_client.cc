@@ -86,3 +86,32 @@ void cls_queue_remove_entries(ObjectWriteOperation& op, const string& end_marker
   encode(rem_op, in);
   op.exec(QUEUE_CLASS, QUEUE_REMOVE_ENTRIES, in);
 }
+
+int cls_queue_dequeue(IoCtx& io_ctx, const string& oid, uint32_t max,
+                      vector<cls_queue_entry>& entries, bool *truncated)
+{
+  bufferlist in, out;
+  cls_queue_dequeue_op op;
+  op.max = max;
+  encode(op, in);
+
+  ObjectWriteOperation wop;
+  int rval = 0;
+  wop.exec(QUEUE_CLASS, QUEUE_DEQUEUE, in, &out, &rval);
+  int r = io_ctx.operate(oid, &wop, librados::OPERATION_RETURNVEC);
+  if (r < 0)
+    return r;
+
+  cls_queue_list_ret ret;
+  auto iter = out.cbegin();
+  try {
+    decode(ret, iter);
+  } catch (buffer::error& err) {
+    return -EIO;
+  }
+
+  entries = std::move(ret.entries);
+  *truncated = ret.is_truncated;
+
+  return 0;
+}
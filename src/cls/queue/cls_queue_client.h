@@ -12,5 +12,8 @@ void cls_queue_enqueue(librados::ObjectWriteOperation& op, uint32_t expiration_s
 int cls_queue_list_entries(librados::IoCtx& io_ctx, const std::string& oid, const std::string& marker, uint32_t max,
                     std::vector<cls_queue_entry>& entries, bool *truncated, std::string& next_marker);
 void cls_queue_remove_entries(librados::ObjectWriteOperation& op, const std::string& end_marker);
+// list and remove up to max entries from the front of the queue in a single op
+int cls_queue_dequeue(librados::IoCtx& io_ctx, const std::string& oid, uint32_t max,
+                    std::vector<cls_queue_entry>& entries, bool *truncated);
 
 #endif
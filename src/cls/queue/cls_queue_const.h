@@ -8,5 +8,6 @@
 #define QUEUE_ENQUEUE "queue_enqueue"
 #define QUEUE_LIST_ENTRIES "queue_list_entries"
 #define QUEUE_REMOVE_ENTRIES "queue_remove_entries"
+#define QUEUE_DEQUEUE "queue_dequeue"
 
 #endif
\ No newline at end of file
@@ -117,6 +117,25 @@ struct cls_queue_remove_op {
 };
 WRITE_CLASS_ENCODER(cls_queue_remove_op)
 
+struct cls_queue_dequeue_op {
+  uint64_t max{0};
+
+  cls_queue_dequeue_op() {}
+
+  void encode(ceph::buffer::list& bl) const {
+    ENCODE_START(1, 1, bl);
+    encode(max, bl);
+    ENCODE_FINISH(bl);
+  }
+
+  void decode(ceph::buffer::list::const_iterator& bl) {
+    DECODE_START(1, bl);
+    decode(max, bl);
+    DECODE_FINISH(bl);
+  }
+};
+WRITE_CLASS_ENCODER(cls_queue_dequeue_op)
+
 struct cls_queue_get_capacity_ret {
   uint64_t queue_capacity;
 
@@ -183,6 +183,35 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
     return -ENOSPC;
   }
 
+  // Entries that land back to back are gathered and written with a
+  // single write, so a batch costs one write per contiguous run (two
+  // at most, when it wraps around) rather than one per entry.
+  bufferlist pending;
+  uint64_t pending_offset = 0;
+  auto flush_pending = [&] {
+    if (pending.length() == 0) {
+      return 0;
+    }
+    CLS_LOG(5, "INFO: queue_enqueue: Writing %u bytes at offset: %lu", pending.length(), pending_offset);
+    const auto len = pending.length();
+    auto ret = cls_cxx_write2(hctx, pending_offset, len, &pending, CEPH_OSD_OP_FLAG_FADVISE_SEQUENTIAL);
+    pending.clear();
+    return ret;
+  };
+  auto write_at = [&] (uint64_t offset, bufferlist& bl) {
+    if (pending.length() > 0 && pending_offset + pending.length() != offset) {
+      auto ret = flush_pending();
+      if (ret < 0) {
+        return ret;
+      }
+    }
+    if (pending.length() == 0) {
+      pending_offset = offset;
+    }
+    pending.claim_append(bl);
+    return 0;
+  };
+
   for (auto& bl_data : op.bl_data_vec) {
     bufferlist bl;
     uint16_t entry_start = QUEUE_ENTRY_START;
@@ -198,11 +227,12 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
       if ((head.tail.offset + bl.length()) <= head.queue_size) {
         CLS_LOG(5, "INFO: queue_enqueue: Writing data size and data: offset: %s, size: %u", head.tail.to_str().c_str(), bl.length());
         //write data size and data at tail offset
-        auto ret = cls_cxx_write2(hctx, head.tail.offset, bl.length(), &bl, CEPH_OSD_OP_FLAG_FADVISE_SEQUENTIAL);
+        const auto len = bl.length();
+        auto ret = write_at(head.tail.offset, bl);
         if (ret < 0) {
           return ret;
         }
-        head.tail.offset += bl.length();
+        head.tail.offset += len;
       } else {
         uint64_t free_space_available = (head.queue_size - head.tail.offset) + (head.front.offset - head.max_head_size);
         //Split data if there is free space available
@@ -212,7 +242,7 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
           bl.splice(0, size_before_wrap, &bl_data_before_wrap);
           //write spliced (data size and data) at tail offset
           CLS_LOG(5, "INFO: queue_enqueue: Writing spliced data at offset: %s and data size: %u", head.tail.to_str().c_str(), bl_data_before_wrap.length());
-          auto ret = cls_cxx_write2(hctx, head.tail.offset, bl_data_before_wrap.length(), &bl_data_before_wrap, CEPH_OSD_OP_FLAG_FADVISE_SEQUENTIAL);
+          auto ret = write_at(head.tail.offset, bl_data_before_wrap);
           if (ret < 0) {
             return ret;
           }
@@ -220,11 +250,12 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
           head.tail.gen += 1;
           //write remaining data at tail offset after wrapping around
           CLS_LOG(5, "INFO: queue_enqueue: Writing remaining data at offset: %s and data size: %u", head.tail.to_str().c_str(), bl.length());
-          ret = cls_cxx_write2(hctx, head.tail.offset, bl.length(), &bl, CEPH_OSD_OP_FLAG_FADVISE_SEQUENTIAL);
+          const auto len = bl.length();
+          ret = write_at(head.tail.offset, bl);
           if (ret < 0) {
             return ret;
           }
-          head.tail.offset += bl.length();
+          head.tail.offset += len;
         } else {
           CLS_LOG(0, "ERROR: No space left in queue\n");
           // return queue full error
@@ -235,11 +266,12 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
       if ((head.tail.offset + bl.length()) <= head.front.offset) {
         CLS_LOG(5, "INFO: queue_enqueue: Writing data size and data: offset: %s, size: %u", head.tail.to_str().c_str(), bl.length());
         //write data size and data at tail offset
-        auto ret = cls_cxx_write2(hctx, head.tail.offset, bl.length(), &bl, CEPH_OSD_OP_FLAG_FADVISE_SEQUENTIAL);
+        const auto len = bl.length();
+        auto ret = write_at(head.tail.offset, bl);
         if (ret < 0) {
           return ret;
         }
-        head.tail.offset += bl.length();
+        head.tail.offset += len;
       } else {
         CLS_LOG(0, "ERROR: No space left in queue");
         // return queue full error
@@ -254,7 +286,7 @@ int queue_enqueue(cls_method_context_t hctx, cls_queue_enqueue_op& op, cls_queue
     CLS_LOG(20, "INFO: queue_enqueue: New tail offset: %s", head.tail.to_str().c_str());
   } //end - for
 
-  return 0;
+  return flush_pending();
 }
 
 int queue_list_entries(cls_method_context_t hctx, const cls_queue_list_op& op, cls_queue_list_ret& op_ret, cls_queue_head& head)
@@ -281,7 +313,11 @@ int queue_list_entries(cls_method_context_t hctx, const cls_queue_list_op& op, c
   }
 
   op_ret.is_truncated = true;
+  // Start small so that listing a few entries stays cheap, and double
+  // the read size as we go so that long listings don't cost a read
+  // per KiB.
   uint64_t chunk_size = 1024;
+  constexpr uint64_t max_chunk_size = 128 * 1024;
   uint64_t contiguous_data_size = 0, size_to_read = 0;
   bool wrap_around = false;
 
@@ -427,6 +463,7 @@ int queue_list_entries(cls_method_context_t hctx, const cls_queue_list_op& op, c
     //Calculate new start_offset and contiguous data size
     start_offset += size_to_read;
     contiguous_data_size -= size_to_read;
+    chunk_size = std::min(chunk_size * 2, max_chunk_size);
     if (contiguous_data_size == 0) {
       if (wrap_around) {
         start_offset = head.max_head_size;
@@ -519,3 +556,27 @@ int queue_remove_entries(cls_method_context_t hctx, const cls_queue_remove_op& o
 
   return 0;
 }
+
+int queue_dequeue(cls_method_context_t hctx, const cls_queue_dequeue_op& op, cls_queue_list_ret& op_ret, cls_queue_head& head)
+{
+  cls_queue_list_op list_op;
+  list_op.max = op.max;
+  auto ret = queue_list_entries(hctx, list_op, op_ret, head);
+  if (ret < 0) {
+    return ret;
+  }
+  if (op_ret.entries.empty()) {
+    return 0;
+  }
+
+  cls_queue_remove_op remove_op;
+  remove_op.end_marker = op_ret.next_marker;
+  ret = queue_remove_entries(hctx, remove_op, head);
+  if (ret < 0) {
+    return ret;
+  }
+
+  CLS_LOG(20, "INFO: queue_dequeue: dequeued %zu entries, front is now %s", op_ret.entries.size(), head.front.to_str().c_str());
+
+  return 0;
+}
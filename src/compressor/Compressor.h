@@ -96,6 +96,19 @@ public:
   // alignment with decode methods
   virtual int decompress(ceph::bufferlist::const_iterator &p, size_t compressed_len, ceph::bufferlist &out, boost::optional<int32_t> compressor_message) = 0;
 
+  // Compress/decompress using `dict` as raw-content dictionary.  The
+  // dictionary is not part of the output, so the decompressing side has
+  // to supply the very same bytes.  Only some algorithms can do this.
+  virtual bool supports_dict() const {
+    return false;
+  }
+  virtual int compress_with_dict(const ceph::bufferlist &in, ceph::bufferlist &out, std::string_view dict) {
+    return -EOPNOTSUPP;
+  }
+  virtual int decompress_with_dict(const ceph::bufferlist &in, ceph::bufferlist &out, std::string_view dict) {
+    return -EOPNOTSUPP;
+  }
+
   static CompressorRef create(CephContext *cct, const std::string &type);
   static CompressorRef create(CephContext *cct, int alg);
 
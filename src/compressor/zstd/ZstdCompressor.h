@@ -100,6 +100,90 @@ class ZstdCompressor : public Compressor {
     dst.append(dstptr, 0, outbuf.pos);
     return 0;
   }
+
+  bool supports_dict() const override {
+    return true;
+  }
+
+  int compress_with_dict(const ceph::buffer::list &src, ceph::buffer::list &dst, std::string_view dict) override {
+    // callers (the messenger) compress many small buffers back to back;
+    // keep one context per thread instead of paying for a new one each time
+    static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>
+      cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    ZSTD_CCtx *s = cctx.get();
+    ZSTD_CCtx_reset(s, ZSTD_reset_session_and_parameters);
+    ZSTD_CCtx_setParameter(s, ZSTD_c_compressionLevel, cct->_conf->compressor_zstd_level);
+    ZSTD_CCtx_setPledgedSrcSize(s, src.length());
+    // a prefix only applies to the next frame, so set it every time
+    ZSTD_CCtx_refPrefix(s, dict.data(), dict.size());
+
+    auto p = src.begin();
+    size_t left = src.length();
+    ceph::buffer::ptr outptr = ceph::buffer::create_small_page_aligned(ZSTD_compressBound(left));
+    ZSTD_outBuffer_s outbuf;
+    outbuf.dst = outptr.c_str();
+    outbuf.size = outptr.length();
+    outbuf.pos = 0;
+
+    do {
+      struct ZSTD_inBuffer_s inbuf;
+      inbuf.pos = 0;
+      inbuf.size = p.get_ptr_and_advance(left, (const char**)&inbuf.src);
+      left -= inbuf.size;
+      ZSTD_EndDirective const zed = (left==0) ? ZSTD_e_end : ZSTD_e_continue;
+      size_t r = ZSTD_compressStream2(s, &outbuf, &inbuf, zed);
+      if (ZSTD_isError(r)) {
+	return -EINVAL;
+      }
+    } while (left);
+
+    ceph::encode((uint32_t)src.length(), dst);
+    dst.append(outptr, 0, outbuf.pos);
+    return 0;
+  }
+
+  int decompress_with_dict(const ceph::buffer::list &src, ceph::buffer::list &dst, std::string_view dict) override {
+    static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)>
+      dctx(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    ZSTD_DCtx *s = dctx.get();
+    size_t compressed_len = src.length();
+    if (compressed_len < 4) {
+      return -1;
+    }
+    compressed_len -= 4;
+    auto p = src.begin();
+    uint32_t dst_len;
+    ceph::decode(dst_len, p);
+
+    ZSTD_DCtx_reset(s, ZSTD_reset_session_only);
+    ZSTD_DCtx_refPrefix(s, dict.data(), dict.size());
+    ceph::buffer::ptr dstptr(dst_len);
+    ZSTD_outBuffer_s outbuf;
+    outbuf.dst = dstptr.c_str();
+    outbuf.size = dstptr.length();
+    outbuf.pos = 0;
+    while (compressed_len > 0) {
+      if (p.end()) {
+	return -1;
+      }
+      ZSTD_inBuffer_s inbuf;
+      inbuf.pos = 0;
+      inbuf.size = p.get_ptr_and_advance(compressed_len,
+					 (const char**)&inbuf.src);
+      size_t r = ZSTD_decompressStream(s, &outbuf, &inbuf);
+      if (ZSTD_isError(r)) {
+	return -EINVAL;
+      }
+      compressed_len -= inbuf.size;
+    }
+    if (outbuf.pos != dst_len) {
+      return -EINVAL;
+    }
+
+    dst.append(dstptr, 0, outbuf.pos);
+    return 0;
+  }
+
  private:
   CephContext *const cct;
 };
@@ -247,6 +247,52 @@ int ErasureCode::decode(const set<int> &want_to_read,
   return _decode(want_to_read, chunks, decoded);
 }
 
+int ErasureCode::encode_stripes(const set<int> &want_to_encode,
+                                const bufferlist &in,
+                                unsigned int chunk_size,
+                                map<int, bufferlist> *encoded)
+{
+  unsigned stripe_width = get_data_chunk_count() * chunk_size;
+  ceph_assert(in.length() % stripe_width == 0);
+  for (unsigned off = 0; off < in.length(); off += stripe_width) {
+    bufferlist stripe;
+    stripe.substr_of(in, off, stripe_width);
+    map<int, bufferlist> stripe_encoded;
+    int r = encode(want_to_encode, stripe, &stripe_encoded);
+    if (r)
+      return r;
+    for (auto& [shard, bl] : stripe_encoded) {
+      ceph_assert(bl.length() == chunk_size);
+      (*encoded)[shard].claim_append(bl);
+    }
+  }
+  return 0;
+}
+
+int ErasureCode::decode_stripes(const set<int> &want_to_read,
+                                const map<int, bufferlist> &chunks,
+                                unsigned int chunk_size,
+                                map<int, bufferlist> *decoded)
+{
+  unsigned total = chunks.begin()->second.length();
+  ceph_assert(total % chunk_size == 0);
+  for (unsigned off = 0; off < total; off += chunk_size) {
+    map<int, bufferlist> stripe_chunks;
+    for (auto& [shard, bl] : chunks) {
+      stripe_chunks[shard].substr_of(bl, off, chunk_size);
+    }
+    map<int, bufferlist> stripe_decoded;
+    int r = decode(want_to_read, stripe_chunks, &stripe_decoded, chunk_size);
+    if (r)
+      return r;
+    for (auto shard : want_to_read) {
+      ceph_assert(stripe_decoded[shard].length() == chunk_size);
+      (*decoded)[shard].claim_append(stripe_decoded[shard]);
+    }
+  }
+  return 0;
+}
+
 int ErasureCode::parse(const ErasureCodeProfile &profile,
 		       ostream *ss)
 {
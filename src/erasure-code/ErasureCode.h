@@ -83,6 +83,16 @@ namespace ceph {
                 const std::map<int, bufferlist> &chunks,
                 std::map<int, bufferlist> *decoded, int chunk_size) override;
 
+    int encode_stripes(const std::set<int> &want_to_encode,
+                       const bufferlist &in,
+                       unsigned int chunk_size,
+                       std::map<int, bufferlist> *encoded) override;
+
+    int decode_stripes(const std::set<int> &want_to_read,
+                       const std::map<int, bufferlist> &chunks,
+                       unsigned int chunk_size,
+                       std::map<int, bufferlist> *decoded) override;
+
     virtual int _decode(const std::set<int> &want_to_read,
 			const std::map<int, bufferlist> &chunks,
 			std::map<int, bufferlist> *decoded);
@@ -370,6 +370,31 @@ namespace ceph {
     virtual int encode_chunks(const std::set<int> &want_to_encode,
                               std::map<int, bufferlist> *encoded) = 0;
 
+    /**
+     * Encode **in**, made of consecutive stripes of
+     * get_data_chunk_count() * **chunk_size** bytes each, and store
+     * in **encoded** the concatenation, stripe after stripe, of the
+     * chunks that encode() would produce for every stripe.
+     *
+     * Plugins whose codes work byte by byte (or word by word within
+     * an aligned chunk) may encode all the stripes with a single
+     * call to the underlying library instead of one call per stripe.
+     *
+     * **chunk_size** must be the value returned by get_chunk_size()
+     * for one stripe and the length of **in** must be a multiple of
+     * the stripe width.
+     *
+     * @param [in] want_to_encode chunk indexes to be encoded
+     * @param [in] in stripes to be encoded
+     * @param [in] chunk_size size of the chunks of one stripe
+     * @param [out] encoded map chunk indexes to chunk data
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int encode_stripes(const std::set<int> &want_to_encode,
+                               const bufferlist &in,
+                               unsigned int chunk_size,
+                               std::map<int, bufferlist> *encoded) = 0;
+
     /**
      * Decode the **chunks** and store at least **want_to_read**
      * chunks in **decoded**.
@@ -412,6 +437,26 @@ namespace ceph {
                               const std::map<int, bufferlist> &chunks,
                               std::map<int, bufferlist> *decoded) = 0;
 
+    /**
+     * Decode **chunks** holding the concatenation of the chunks of
+     * several stripes, as produced by encode_stripes(), and store at
+     * least **want_to_read** in **decoded**, with the same layout.
+     *
+     * This is equivalent to calling decode() for every **chunk_size**
+     * slice and appending the results, but plugins may recover all
+     * the stripes with a single call to the underlying library.
+     *
+     * @param [in] want_to_read chunk indexes to be decoded
+     * @param [in] chunks map chunk indexes to chunk data
+     * @param [in] chunk_size size of the chunks of one stripe
+     * @param [out] decoded map chunk indexes to chunk data
+     * @return **0** on success or a negative errno on error.
+     */
+    virtual int decode_stripes(const std::set<int> &want_to_read,
+                               const std::map<int, bufferlist> &chunks,
+                               unsigned int chunk_size,
+                               std::map<int, bufferlist> *decoded) = 0;
+
     /**
      * Return the ordered list of chunks or an empty vector
      * if no remapping is necessary.
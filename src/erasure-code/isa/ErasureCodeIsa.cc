@@ -116,6 +116,64 @@ int ErasureCodeIsa::decode_chunks(const set<int> &want_to_read,
 
 // -----------------------------------------------------------------------------
 
+int ErasureCodeIsa::encode_stripes(const set<int> &want_to_encode,
+                                   const bufferlist &in,
+                                   unsigned int chunk_size,
+                                   map<int, bufferlist> *encoded)
+{
+  // ec_encode_data and region_xor work byte by byte, so the chunks of
+  // consecutive stripes can be laid out back to back and encoded with
+  // a single call using the shared encoding tables
+  unsigned stripe_width = k * chunk_size;
+  if (!chunk_mapping.empty() ||
+      chunk_size % get_alignment() ||
+      in.length() % stripe_width)
+    return ErasureCode::encode_stripes(want_to_encode, in, chunk_size, encoded);
+
+  unsigned stripes = in.length() / stripe_width;
+  unsigned blocksize = stripes * chunk_size;
+  dout(20) << "encode_stripes: " << stripes << " stripes of "
+           << stripe_width << " bytes in one pass" << dendl;
+  if (blocksize == 0)
+    return 0;
+
+  char *chunks[k + m];
+  for (int i = 0; i < k + m; i++) {
+    bufferptr ptr(buffer::create_aligned(blocksize, SIMD_ALIGN));
+    chunks[i] = ptr.c_str();
+    (*encoded)[i].push_back(std::move(ptr));
+  }
+  auto p = in.begin();
+  for (unsigned s = 0; s < stripes; s++) {
+    for (int i = 0; i < k; i++) {
+      p.copy(chunk_size, chunks[i] + s * chunk_size);
+    }
+  }
+  isa_encode(&chunks[0], &chunks[k], blocksize);
+  for (int i = 0; i < k + m; i++) {
+    if (want_to_encode.count(i) == 0)
+      encoded->erase(i);
+  }
+  return 0;
+}
+
+int ErasureCodeIsa::decode_stripes(const set<int> &want_to_read,
+                                   const map<int, bufferlist> &chunks,
+                                   unsigned int chunk_size,
+                                   map<int, bufferlist> *decoded)
+{
+  // same as above: recover every stripe at once, which also means a
+  // single decoding table lookup for the whole run
+  if (!chunk_mapping.empty() ||
+      chunk_size % get_alignment())
+    return ErasureCode::decode_stripes(want_to_read, chunks, chunk_size,
+                                       decoded);
+  ceph_assert(chunks.begin()->second.length() % chunk_size == 0);
+  return _decode(want_to_read, chunks, decoded);
+}
+
+// -----------------------------------------------------------------------------
+
 void
 ErasureCodeIsaDefault::isa_encode(char **data,
                                   char **coding,
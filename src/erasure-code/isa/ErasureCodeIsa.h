@@ -80,6 +80,16 @@ public:
                             const std::map<int, ceph::buffer::list> &chunks,
                             std::map<int, ceph::buffer::list> *decoded) override;
 
+  int encode_stripes(const std::set<int> &want_to_encode,
+                     const ceph::buffer::list &in,
+                     unsigned int chunk_size,
+                     std::map<int, ceph::buffer::list> *encoded) override;
+
+  int decode_stripes(const std::set<int> &want_to_read,
+                     const std::map<int, ceph::buffer::list> &chunks,
+                     unsigned int chunk_size,
+                     std::map<int, ceph::buffer::list> *decoded) override;
+
   int init(ceph::ErasureCodeProfile &profile, std::ostream *ss) override;
 
   virtual void isa_encode(char **data,
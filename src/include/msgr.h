@@ -52,6 +52,8 @@
 
 DEFINE_MSGR2_FEATURE(0, 1, REVISION_1)   // msgr2.1
 DEFINE_MSGR2_FEATURE(1, 1, COMPRESSION)  // on-wire compression
+DEFINE_MSGR2_FEATURE(2, 1, COMPRESSION_DICT)  // history window as dictionary
+DEFINE_MSGR2_FEATURE(3, 1, CONNECT_ANON)  // unregistered lossy client sessions
 
 /*
  * Features supported.  Should be everything above.
@@ -59,6 +61,8 @@ DEFINE_MSGR2_FEATURE(1, 1, COMPRESSION)  // on-wire compression
 #define CEPH_MSGR2_SUPPORTED_FEATURES \
 	(CEPH_MSGR2_FEATURE_REVISION_1 | \
 	 CEPH_MSGR2_FEATURE_COMPRESSION | \
+	 CEPH_MSGR2_FEATURE_COMPRESSION_DICT | \
+	 CEPH_MSGR2_FEATURE_CONNECT_ANON | \
 	 0ULL)
 
 #define CEPH_MSGR2_REQUIRED_FEATURES (0ULL)
@@ -158,6 +162,7 @@ struct ceph_msg_connect_reply {
 } __attribute__ ((packed));
 
 #define CEPH_MSG_CONNECT_LOSSY  1  /* messages i send may be safely dropped */
+#define CEPH_MSG_CONNECT_ANON   2  /* anonymous connection, do not register */
 
 
 /*
@@ -195,6 +195,13 @@ inline namespace v14_2_0 {
     AioCompletion(AioCompletionImpl *pc_) : pc(pc_) {}
     ~AioCompletion();
     int set_complete_callback(void *cb_arg, callback_t cb);
+    /**
+     * Like set_complete_callback(), but with librados_aio_direct_callbacks
+     * enabled the callback may be called right from the thread that
+     * completed the op instead of from the librados finisher. It must
+     * return quickly and never block, e.g. just post to an executor.
+     */
+    int set_complete_callback_direct(void *cb_arg, callback_t cb);
     int set_safe_callback(void *cb_arg, callback_t cb)
       __attribute__ ((deprecated));
     int wait_for_complete();
@@ -7,6 +7,7 @@
 #include <ostream>
 #include <set>
 #include <map>
+#include <optional>
 #include <string>
 #include <boost/scoped_ptr.hpp>
 #include "include/encoding.h"
@@ -123,6 +124,21 @@ public:
       const std::string &end        ///< [in] The start bound of remove keys
       ) = 0;
 
+    /// Removes keys like rm_range_keys(), but covers the range with a
+    /// single range tombstone as soon as it holds @threshold keys, rather
+    /// than at the store's own (much larger) limit. Meant for bulk trimming
+    /// of log-like key ranges. Returns true if a range tombstone was used,
+    /// so the caller can get the range compacted once it has committed.
+    virtual bool rm_range_keys_trim(
+      const std::string &prefix,    ///< [in] Prefix by which to remove keys
+      const std::string &start,     ///< [in] The start bound of remove keys
+      const std::string &end,       ///< [in] The end bound of remove keys
+      uint64_t threshold            ///< [in] Keys that warrant a range tombstone
+      ) {
+      rm_range_keys(prefix, start, end);
+      return false;
+    }
+
     /// Merge value into key
     virtual void merge(
       const std::string &prefix,   ///< [in] Prefix/CF ==> MUST match some established merge operator
@@ -324,8 +340,19 @@ private:
 public:
   typedef uint32_t IteratorOpts;
   static const uint32_t ITERATOR_NOCACHE = 1;
+
+  /// Key range [lower_bound, upper_bound) the caller is going to look at.
+  /// This is only a hint that lets the backend skip data (and, for a
+  /// sharded prefix, shards) outside the range; keys beyond the bounds may
+  /// still be returned, so callers have to keep checking for themselves.
+  struct IteratorBounds {
+    std::optional<std::string> lower_bound;
+    std::optional<std::string> upper_bound;
+  };
+
   virtual WholeSpaceIterator get_wholespace_iterator(IteratorOpts opts = 0) = 0;
-  virtual Iterator get_iterator(const std::string &prefix, IteratorOpts opts = 0) {
+  virtual Iterator get_iterator(const std::string &prefix, IteratorOpts opts = 0,
+				IteratorBounds bounds = IteratorBounds()) {
     return std::make_shared<PrefixIteratorImpl>(
       prefix,
       get_wholespace_iterator(opts));
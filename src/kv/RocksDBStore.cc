@@ -1211,6 +1211,11 @@ int RocksDBStore::do_open(ostream &out,
   plb.add_time_avg(l_rocksdb_write_delay_time, "rocksdb_write_delay_time", "Rocksdb write delay time");
   plb.add_time_avg(l_rocksdb_write_pre_and_post_process_time, 
       "rocksdb_write_pre_and_post_time", "total time spent on writing a record, excluding write process");
+  plb.add_u64_counter(l_rocksdb_delete_range, "delete_range", "Key ranges removed with a range tombstone");
+  plb.add_u64_avg(l_rocksdb_iter_seek_tombstones, "iter_seek_tombstones",
+      "Deleted keys skipped per iterator seek (needs rocksdb_perf)");
+  plb.add_u64_avg(l_rocksdb_iter_seek_range_reseeks, "iter_seek_range_reseeks",
+      "Reseeks over range tombstones per iterator seek (needs rocksdb_perf)");
   logger = plb.create_perf_counters();
   cct->get_perfcounters_collection()->add(logger);
 
@@ -1683,6 +1688,7 @@ void RocksDBStore::RocksDBTransactionImpl::rmkeys_by_prefix(const string &prefix
 	bat.DeleteRange(db->default_cf,
                         combine_strings(prefix, string()),
                         combine_strings(endprefix, string()));
+	db->logger->inc(l_rocksdb_delete_range);
     } else {
       bat.PopSavePoint();
     }
@@ -1699,6 +1705,7 @@ void RocksDBStore::RocksDBTransactionImpl::rmkeys_by_prefix(const string &prefix
 	bat.RollbackToSavePoint();
 	string endprefix = "\xff\xff\xff\xff";  // FIXME: this is cheating...
 	bat.DeleteRange(cf, string(), endprefix);
+	db->logger->inc(l_rocksdb_delete_range);
       } else {
 	bat.PopSavePoint();
       }
@@ -1710,9 +1717,18 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
                                                          const string &start,
                                                          const string &end)
 {
+  rm_range_keys_trim(prefix, start, end, db->delete_range_threshold);
+}
+
+bool RocksDBStore::RocksDBTransactionImpl::rm_range_keys_trim(const string &prefix,
+							      const string &start,
+							      const string &end,
+							      uint64_t threshold)
+{
+  bool ranged = false;
   auto p_iter = db->cf_handles.find(prefix);
   if (p_iter == db->cf_handles.end()) {
-    uint64_t cnt = db->delete_range_threshold;
+    uint64_t cnt = threshold;
     bat.SetSavePoint();
     auto it = db->get_iterator(prefix);
     for (it->lower_bound(start);
@@ -1725,30 +1741,43 @@ void RocksDBStore::RocksDBTransactionImpl::rm_range_keys(const string &prefix,
       bat.DeleteRange(db->default_cf,
 		      rocksdb::Slice(combine_strings(prefix, start)),
 		      rocksdb::Slice(combine_strings(prefix, end)));
+      ranged = true;
     } else {
       bat.PopSavePoint();
     }
   } else {
     ceph_assert(p_iter->second.handles.size() >= 1);
-    for (auto cf : p_iter->second.handles) {
-      uint64_t cnt = db->delete_range_threshold;
+    // a range within the hashed part of the key lives in a single shard
+    std::vector<rocksdb::ColumnFamilyHandle*> bounded;
+    const auto* shards = &p_iter->second.handles;
+    if (auto cf = db->get_bounded_shard(p_iter->second,
+					IteratorBounds{start, end}); cf) {
+      bounded.push_back(cf);
+      shards = &bounded;
+    }
+    rocksdb::Slice upper(end);
+    for (auto cf : *shards) {
+      uint64_t cnt = threshold;
       bat.SetSavePoint();
-      rocksdb::Iterator* it = db->new_shard_iterator(cf);
+      rocksdb::Iterator* it = db->new_shard_iterator(cf, &upper);
       ceph_assert(it != nullptr);
-      for (it->Seek(start);
-	   it->Valid() && db->comparator->Compare(it->key(), end) < 0 && (--cnt) != 0;
-	   it->Next()) {
+      for (it->Seek(start); it->Valid() && (--cnt) != 0; it->Next()) {
 	bat.Delete(cf, it->key());
       }
       if (cnt == 0) {
 	bat.RollbackToSavePoint();
 	bat.DeleteRange(cf, rocksdb::Slice(start), rocksdb::Slice(end));
+	ranged = true;
       } else {
 	bat.PopSavePoint();
       }
       delete it;
     }
   }
+  if (ranged) {
+    db->logger->inc(l_rocksdb_delete_range);
+  }
+  return ranged;
 }
 
 void RocksDBStore::RocksDBTransactionImpl::merge(
@@ -2032,6 +2061,11 @@ void RocksDBStore::compact_range(const string& start, const string& end)
 			    const std::string& end) {
     rocksdb::Slice cstart(start);
     rocksdb::Slice cend(end);
+    if (auto cf = get_bounded_shard(column_it->second,
+				    IteratorBounds{start, end}); cf) {
+      db->CompactRange(options, cf, &cstart, &cend);
+      return;
+    }
     for (const auto& shard_it : column_it->second.handles) {
       db->CompactRange(options, shard_it, &cstart, &cend);
     }
@@ -2190,19 +2224,91 @@ string RocksDBStore::past_prefix(const string &prefix)
   return limit;
 }
 
+// Read options for iterating over a column family.
+//
+// A column may have a prefix_extractor (set through the sharding
+// definition) to get prefix bloom filters. With it rocksdb turns Seek()
+// into a prefix seek by default, while our iterators walk across
+// prefixes; so ask for total order, or let rocksdb decide from the upper
+// bound whether the prefix filter can be used.
+// ReadOptions only points at the bounds, so keep them here for as long as
+// the iterators created with these options live.
+struct BoundedReadOptions {
+  KeyValueDB::IteratorBounds bounds;
+  rocksdb::Slice lower, upper;
+  rocksdb::ReadOptions opts;
+
+  BoundedReadOptions(KeyValueDB::IteratorOpts iopts,
+		     KeyValueDB::IteratorBounds&& b)
+    : bounds(std::move(b)) {
+    if (iopts & KeyValueDB::ITERATOR_NOCACHE) {
+      opts.fill_cache = false;
+    }
+    if (bounds.lower_bound) {
+      lower = rocksdb::Slice(*bounds.lower_bound);
+      opts.iterate_lower_bound = &lower;
+    }
+    if (bounds.upper_bound) {
+      upper = rocksdb::Slice(*bounds.upper_bound);
+      opts.iterate_upper_bound = &upper;
+      opts.auto_prefix_mode = true;
+    } else {
+      opts.total_order_seek = true;
+    }
+  }
+  BoundedReadOptions(const BoundedReadOptions&) = delete;
+  BoundedReadOptions& operator=(const BoundedReadOptions&) = delete;
+};
+
+// Accounts for the tombstones rocksdb stepped over while serving one
+// iterator seek. This reads the thread-local perf context, so it only
+// does anything with rocksdb_perf enabled.
+class SeekTombstoneTracker {
+  const RocksDBStore* db;
+  uint64_t deletes = 0;
+  uint64_t reseeks = 0;
+public:
+  explicit SeekTombstoneTracker(const RocksDBStore* store)
+    : db(store->cct->_conf->rocksdb_perf ? store : nullptr) {
+    if (db) {
+      if (rocksdb::GetPerfLevel() < rocksdb::PerfLevel::kEnableCount) {
+	rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+      }
+      auto ctx = rocksdb::get_perf_context();
+      deletes = ctx->internal_delete_skipped_count;
+      reseeks = ctx->internal_range_del_reseek_count;
+    }
+  }
+  ~SeekTombstoneTracker() {
+    if (db) {
+      auto ctx = rocksdb::get_perf_context();
+      db->logger->inc(l_rocksdb_iter_seek_tombstones,
+		      ctx->internal_delete_skipped_count - deletes);
+      db->logger->inc(l_rocksdb_iter_seek_range_reseeks,
+		      ctx->internal_range_del_reseek_count - reseeks);
+    }
+  }
+};
+
 class CFIteratorImpl : public KeyValueDB::IteratorImpl {
 protected:
+  const RocksDBStore* db;
   string prefix;
+  std::unique_ptr<BoundedReadOptions> read_opts;
   rocksdb::Iterator *dbiter;
 public:
-  explicit CFIteratorImpl(const std::string& p,
-				 rocksdb::Iterator *iter)
-    : prefix(p), dbiter(iter) { }
+  CFIteratorImpl(const RocksDBStore* db,
+		 const std::string& p,
+		 rocksdb::ColumnFamilyHandle* cf,
+		 std::unique_ptr<BoundedReadOptions> ro)
+    : db(db), prefix(p), read_opts(std::move(ro)),
+      dbiter(db->db->NewIterator(read_opts->opts, cf)) { }
   ~CFIteratorImpl() {
     delete dbiter;
   }
 
   int seek_to_first() override {
+    SeekTombstoneTracker tracker(db);
     dbiter->SeekToFirst();
     return dbiter->status().ok() ? 0 : -1;
   }
@@ -2218,6 +2324,7 @@ public:
     return dbiter->status().ok() ? 0 : -1;
   }
   int lower_bound(const string &to) override {
+    SeekTombstoneTracker tracker(db);
     rocksdb::Slice slice_bound(to);
     dbiter->Seek(slice_bound);
     return dbiter->status().ok() ? 0 : -1;
@@ -2729,16 +2836,18 @@ private:
   const RocksDBStore* db;
   KeyLess keyless;
   string prefix;
+  std::unique_ptr<BoundedReadOptions> read_opts;
   std::vector<rocksdb::Iterator*> iters;
 public:
   explicit ShardMergeIteratorImpl(const RocksDBStore* db,
 				  const std::string& prefix,
-				  const std::vector<rocksdb::ColumnFamilyHandle*>& shards)
-    : db(db), keyless(db->comparator), prefix(prefix)
+				  const std::vector<rocksdb::ColumnFamilyHandle*>& shards,
+				  std::unique_ptr<BoundedReadOptions> ro)
+    : db(db), keyless(db->comparator), prefix(prefix), read_opts(std::move(ro))
   {
     iters.reserve(shards.size());
     for (auto& s : shards) {
-      iters.push_back(db->db->NewIterator(rocksdb::ReadOptions(), s));
+      iters.push_back(db->db->NewIterator(read_opts->opts, s));
     }
   }
   ~ShardMergeIteratorImpl() {
@@ -2747,6 +2856,7 @@ public:
     }
   }
   int seek_to_first() override {
+    SeekTombstoneTracker tracker(db);
     for (auto& it : iters) {
       it->SeekToFirst();
       if (!it->status().ok()) {
@@ -2787,6 +2897,7 @@ public:
     return 0;
   }
   int upper_bound(const string &after) override {
+    SeekTombstoneTracker tracker(db);
     rocksdb::Slice slice_bound(after);
     for (auto& it : iters) {
       it->Seek(slice_bound);
@@ -2801,6 +2912,7 @@ public:
     return 0;
   }
   int lower_bound(const string &to) override {
+    SeekTombstoneTracker tracker(db);
     rocksdb::Slice slice_bound(to);
     for (auto& it : iters) {
       it->Seek(slice_bound);
@@ -2909,28 +3021,65 @@ public:
   }
 };
 
-KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix, IteratorOpts opts)
+rocksdb::ColumnFamilyHandle* RocksDBStore::get_bounded_shard(
+  const prefix_shards& column,
+  const IteratorBounds& bounds)
+{
+  if (column.handles.size() == 1) {
+    return column.handles[0];
+  }
+  if (!bounds.lower_bound || !bounds.upper_bound) {
+    return nullptr;
+  }
+  // Every key in [lower, upper) starts with the common prefix of the two
+  // bounds. If that covers the hashed characters, they all share a shard.
+  const auto& lower = *bounds.lower_bound;
+  const auto& upper = *bounds.upper_bound;
+  if (lower.size() < column.hash_h || upper.size() < column.hash_h ||
+      lower.compare(0, column.hash_h, upper, 0, column.hash_h) != 0) {
+    return nullptr;
+  }
+  uint32_t hash = ceph_str_hash_rjenkins(&lower[column.hash_l],
+					 column.hash_h - column.hash_l);
+  return column.handles[hash % column.handles.size()];
+}
+
+KeyValueDB::Iterator RocksDBStore::get_iterator(const std::string& prefix,
+						IteratorOpts opts,
+						IteratorBounds bounds)
 {
   auto cf_it = cf_handles.find(prefix);
   if (cf_it != cf_handles.end()) {
-    if (cf_it->second.handles.size() == 1) {
+    auto cf = get_bounded_shard(cf_it->second, bounds);
+    auto read_opts = std::make_unique<BoundedReadOptions>(opts, std::move(bounds));
+    if (cf) {
       return std::make_shared<CFIteratorImpl>(
+        this,
         prefix,
-        db->NewIterator(rocksdb::ReadOptions(), cf_it->second.handles[0]));
+        cf,
+        std::move(read_opts));
     } else {
       return std::make_shared<ShardMergeIteratorImpl>(
         this,
         prefix,
-        cf_it->second.handles);
+        cf_it->second.handles,
+        std::move(read_opts));
     }
   } else {
     return KeyValueDB::get_iterator(prefix, opts);
   }
 }
 
-rocksdb::Iterator* RocksDBStore::new_shard_iterator(rocksdb::ColumnFamilyHandle* cf)
+rocksdb::Iterator* RocksDBStore::new_shard_iterator(rocksdb::ColumnFamilyHandle* cf,
+						   const rocksdb::Slice* upper)
 {
-  return db->NewIterator(rocksdb::ReadOptions(), cf);
+  rocksdb::ReadOptions opt;
+  // see BoundedReadOptions
+  opt.total_order_seek = true;
+  // stop at the bound instead of stepping over whatever follows it,
+  // tombstones included
+  opt.iterate_upper_bound = upper;
+  return db->NewIterator(opt, cf);
 }
 
 RocksDBStore::WholeSpaceIterator RocksDBStore::get_wholespace_iterator(IteratorOpts opts)
@@ -3224,8 +3373,10 @@ int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::r
 			    const std::string& fixed_prefix)
   {
     dout(5) << " column=" << (void*)handle << " prefix=" << fixed_prefix << dendl;
-    std::unique_ptr<rocksdb::Iterator> it{
-      db->NewIterator(rocksdb::ReadOptions(), handle)};
+    rocksdb::ReadOptions ro;
+    // see BoundedReadOptions
+    ro.total_order_seek = true;
+    std::unique_ptr<rocksdb::Iterator> it{db->NewIterator(ro, handle)};
     ceph_assert(it);
 
     rocksdb::WriteBatch bat;
@@ -3239,7 +3390,7 @@ int RocksDBStore::reshard(const std::string& new_sharding, const RocksDBStore::r
 	bytes_per_iterator = 0;
 	keys_per_iterator = 0;
 	std::string raw_key_str = raw_key.ToString();
-	it.reset(db->NewIterator(rocksdb::ReadOptions(), handle));
+	it.reset(db->NewIterator(ro, handle));
 	ceph_assert(it);
 	it->Seek(raw_key_str);
 	ceph_assert(it->Valid());
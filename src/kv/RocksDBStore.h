@@ -42,6 +42,9 @@ enum {
   l_rocksdb_write_memtable_time,
   l_rocksdb_write_delay_time,
   l_rocksdb_write_pre_and_post_process_time,
+  l_rocksdb_delete_range,
+  l_rocksdb_iter_seek_tombstones,
+  l_rocksdb_iter_seek_range_reseeks,
   l_rocksdb_last,
 };
 
@@ -84,6 +87,8 @@ class RocksDBStore : public KeyValueDB {
   bool set_cache_flag = false;
   friend class ShardMergeIteratorImpl;
   friend class WholeMergeIteratorImpl;
+  friend class CFIteratorImpl;
+  friend class SeekTombstoneTracker;
   /*
    *  See RocksDB's definition of a column family(CF) and how to use it.
    *  The interfaces of KeyValueDB is extended, when a column family is created.
@@ -308,6 +313,11 @@ public:
       const std::string &prefix,
       const std::string &start,
       const std::string &end) override;
+    bool rm_range_keys_trim(
+      const std::string &prefix,
+      const std::string &start,
+      const std::string &end,
+      uint64_t threshold) override;
     void merge(
       const std::string& prefix,
       const std::string& k,
@@ -366,10 +376,15 @@ public:
     size_t value_size() override;
   };
 
-  Iterator get_iterator(const std::string& prefix, IteratorOpts opts = 0) override;
+  Iterator get_iterator(const std::string& prefix, IteratorOpts opts = 0,
+			IteratorBounds bounds = IteratorBounds()) override;
 private:
   /// this iterator spans single cf
-  rocksdb::Iterator* new_shard_iterator(rocksdb::ColumnFamilyHandle* cf);
+  rocksdb::Iterator* new_shard_iterator(rocksdb::ColumnFamilyHandle* cf,
+				       const rocksdb::Slice* upper = nullptr);
+  /// the only shard of a column that can hold keys within the bounds, if any
+  rocksdb::ColumnFamilyHandle* get_bounded_shard(const prefix_shards& column,
+						 const IteratorBounds& bounds);
 public:
   /// Utility
   static std::string combine_strings(const std::string &prefix, const std::string &value) {
@@ -33,6 +33,8 @@ struct librados::AioCompletionImpl {
 
   rados_callback_t callback_complete = nullptr, callback_safe = nullptr;
   void *callback_complete_arg = nullptr, *callback_safe_arg = nullptr;
+  // callbacks don't block and may run in the thread completing the op
+  bool callback_direct = false;
 
   // for read
   bool is_read = false;
@@ -46,10 +48,12 @@ struct librados::AioCompletionImpl {
 
   AioCompletionImpl() : aio_write_list_item(this) { }
 
-  int set_complete_callback(void *cb_arg, rados_callback_t cb) {
+  int set_complete_callback(void *cb_arg, rados_callback_t cb,
+                            bool direct = false) {
     std::scoped_lock l{lock};
     callback_complete = cb;
     callback_complete_arg = cb_arg;
+    callback_direct = direct;
     return 0;
   }
   int set_safe_callback(void *cb_arg, rados_callback_t cb) {
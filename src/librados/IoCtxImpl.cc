@@ -1996,9 +1996,15 @@ void librados::IoCtxImpl::C_aio_Complete::finish(int r)
     }
   }
 
+  std::optional<CB_AioComplete> direct;
   if (c->callback_complete ||
       c->callback_safe) {
-    boost::asio::defer(c->io->client->finish_strand, CB_AioComplete(c));
+    if (c->callback_direct && c->io->client->aio_direct_callbacks) {
+      // skip the hop through finish_strand; run it once we drop the lock
+      direct.emplace(c);
+    } else {
+      boost::asio::defer(c->io->client->finish_strand, CB_AioComplete(c));
+    }
   }
 
   if (c->aio_write_seq) {
@@ -2009,6 +2015,9 @@ void librados::IoCtxImpl::C_aio_Complete::finish(int r)
   OID_EVENT_TRACE(oid.name.c_str(), "RADOS_OP_COMPLETE");
 #endif
   c->put_unlock();
+  if (direct) {
+    (*direct)();
+  }
 }
 
 void librados::IoCtxImpl::object_list_slice(
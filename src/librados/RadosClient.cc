@@ -237,6 +237,7 @@ int librados::RadosClient::connect()
   common_init_finish(cct);
 
   poolctx.start(cct->_conf.get_val<std::uint64_t>("librados_thread_count"));
+  aio_direct_callbacks = cct->_conf.get_val<bool>("librados_aio_direct_callbacks");
 
   // get monmap
   err = monclient.build_initial_monmap();
@@ -97,6 +97,8 @@ private:
 
 public:
   boost::asio::io_context::strand finish_strand{poolctx.get_io_context()};
+  // librados_aio_direct_callbacks
+  bool aio_direct_callbacks = false;
 
   explicit RadosClient(CephContext *cct);
   ~RadosClient() override;
@@ -84,8 +84,11 @@ struct AsyncOp : Invoker<Result> {
   template <typename Executor1, typename CompletionHandler>
   static auto create(const Executor1& ex1, CompletionHandler&& handler) {
     auto p = Completion::create(ex1, std::move(handler));
-    p->user_data.aio_completion.reset(
-        Rados::aio_create_completion(p.get(), aio_dispatch));
+    // aio_dispatch() only hands the result over to the handler's executor,
+    // so it is safe to call without going through the librados finisher
+    p->user_data.aio_completion.reset(Rados::aio_create_completion());
+    p->user_data.aio_completion->set_complete_callback_direct(p.get(),
+                                                              aio_dispatch);
     return p;
   }
 };
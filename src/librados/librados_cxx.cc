@@ -1036,6 +1036,12 @@ int librados::AioCompletion::AioCompletion::set_complete_callback(void *cb_arg,
   return c->set_complete_callback(cb_arg, cb);
 }
 
+int librados::AioCompletion::AioCompletion::set_complete_callback_direct(void *cb_arg, rados_callback_t cb)
+{
+  AioCompletionImpl *c = (AioCompletionImpl *)pc;
+  return c->set_complete_callback(cb_arg, cb, true);
+}
+
 int librados::AioCompletion::AioCompletion::set_safe_callback(void *cb_arg, rados_callback_t cb)
 {
   AioCompletionImpl *c = (AioCompletionImpl *)pc;
@@ -15,6 +15,7 @@
 #ifndef CEPH_CONNECTION_H
 #define CEPH_CONNECTION_H
 
+#include <atomic>
 #include <stdlib.h>
 #include <ostream>
 
@@ -51,6 +52,7 @@ struct Connection : public RefCountedObjectSafe {
   bool anon = false;  ///< anonymous outgoing connection
 private:
   uint64_t features = 0;
+  std::atomic<uint64_t> peer_msgr2_features = 0;  ///< CEPH_MSGR2_FEATURE_*
 public:
   bool is_loopback = false;
   bool failed = false; // true if we are a lossy connection that has failed.
@@ -102,6 +104,15 @@ public:
     return anon;
   }
 
+  /// msgr2 features the peer advertised in its banner; 0 before the
+  /// banner exchange and for msgr1 connections
+  uint64_t get_peer_msgr2_features() const {
+    return peer_msgr2_features;
+  }
+  void set_peer_msgr2_features(uint64_t f) {
+    peer_msgr2_features = f;
+  }
+
   Messenger *get_messenger() {
     return msgr;
   }
@@ -297,6 +297,7 @@ ssize_t AsyncConnection::read_bulk(char *buf, unsigned len)
                               << cs.fd() << dendl;
     return -1;
   }
+  io_bytes.fetch_add(nread, std::memory_order_relaxed);
   return nread;
 }
 
@@ -335,6 +336,7 @@ ssize_t AsyncConnection::_try_send(bool more)
 
   ldout(async_msgr->cct, 10) << __func__ << " sent bytes " << r
                              << " remaining bytes " << outgoing_bl.length() << dendl;
+  io_bytes.fetch_add(r, std::memory_order_relaxed);
 
   if (!open_write && is_queued()) {
     center->create_file_event(cs.fd(), EVENT_WRITABLE, write_handler);
@@ -364,6 +366,10 @@ void AsyncConnection::inject_delay() {
 
 void AsyncConnection::process() {
   std::lock_guard<std::mutex> l(lock);
+  if (!center->in_thread()) {
+    // stale event queued before we migrated to another worker
+    return;
+  }
   last_active = ceph::coarse_mono_clock::now();
   recv_start_time = ceph::mono_clock::now();
 
@@ -704,11 +710,20 @@ void AsyncConnection::mark_down()
 void AsyncConnection::handle_write()
 {
   ldout(async_msgr->cct, 10) << __func__ << dendl;
+  {
+    std::lock_guard<std::mutex> l(write_lock);
+    if (!center->in_thread()) {
+      return;
+    }
+  }
   protocol->write_event();
 }
 
 void AsyncConnection::handle_write_callback() {
   std::lock_guard<std::mutex> l(lock);
+  if (!center->in_thread()) {
+    return;
+  }
   last_active = ceph::coarse_mono_clock::now();
   recv_start_time = ceph::mono_clock::now();
   write_lock.lock();
@@ -784,3 +799,78 @@ void AsyncConnection::tick(uint64_t id)
     }
   }
 }
+
+void AsyncConnection::migrate_to(Worker *new_worker)
+{
+  // The handover takes three steps so that nothing runs concurrently on
+  // both workers: the old worker drops its events and switches pointers,
+  // then drains whatever was already queued for us on the old center (such
+  // events notice they are no longer in their owner thread and bail out),
+  // and only then the new worker registers the socket.
+  AsyncConnectionRef conn(this);
+  EventCenter *old_center;
+  {
+    std::lock_guard<std::mutex> l(lock);
+    old_center = center;
+  }
+  old_center->submit_to(old_center->get_id(), [this, conn, new_worker]() {
+    EventCenter *from;
+    {
+      std::lock_guard<std::mutex> l(lock);
+      std::lock_guard<std::mutex> wl(write_lock);
+      if (!center->in_thread() ||
+          worker == new_worker ||
+          state != STATE_CONNECTION_ESTABLISHED ||
+          !protocol->is_connected() ||
+          delay_state ||
+          !register_time_events.empty() ||
+          !cs) {
+        ldout(async_msgr->cct, 10) << __func__ << " to worker "
+                                   << new_worker->id << " skipped" << dendl;
+        return;
+      }
+      ldout(async_msgr->cct, 5) << __func__ << " worker " << worker->id
+                                << " -> " << new_worker->id << dendl;
+      center->delete_file_event(cs.fd(), EVENT_READABLE | EVENT_WRITABLE);
+      if (last_tick_id) {
+        center->delete_time_event(last_tick_id);
+        last_tick_id = 0;
+      }
+      logger->inc(l_msgr_migrated_out_connections);
+      logger->dec(l_msgr_active_connections);
+      worker->references--;
+      new_worker->references++;
+      from = center;
+      worker = new_worker;
+      center = &new_worker->center;
+      logger = new_worker->get_perf_counter();
+      logger->inc(l_msgr_migrated_in_connections);
+      logger->inc(l_msgr_active_connections);
+    }
+
+    auto attach = [this, conn]() {
+      {
+        std::lock_guard<std::mutex> l(lock);
+        if (state != STATE_CONNECTION_ESTABLISHED || !cs) {
+          // closed while in flight, _stop() already cleaned up here
+          return;
+        }
+        center->create_file_event(cs.fd(), EVENT_READABLE, read_handler);
+        std::lock_guard<std::mutex> wl(write_lock);
+        if (open_write) {
+          center->create_file_event(cs.fd(), EVENT_WRITABLE, write_handler);
+        }
+        last_tick_id = center->create_time_event(inactive_timeout_us,
+                                                 tick_handler);
+      }
+      // replay whatever the stale events on the old worker dropped
+      center->dispatch_event_external(read_handler);
+      center->dispatch_event_external(write_handler);
+      center->dispatch_event_external(write_callback_handler);
+    };
+    EventCenter *to = center;
+    from->submit_to(from->get_id(), [to, attach=std::move(attach)]() mutable {
+      to->submit_to(to->get_id(), std::move(attach), true);
+    }, true);
+  }, true);
+}
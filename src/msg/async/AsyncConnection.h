@@ -144,6 +144,18 @@ public:
     return unregistered;
   }
 
+  Worker *get_worker() {
+    std::lock_guard<std::mutex> l(lock);
+    return worker;
+  }
+  // bytes moved over the socket since the last call
+  uint64_t take_io_bytes() {
+    return io_bytes.exchange(0, std::memory_order_relaxed);
+  }
+  // hand an established connection over to another worker; connections
+  // that are connecting, faulted or have pending timers are left alone
+  void migrate_to(Worker *new_worker);
+
   void unregister() {
     unregistered = true;
   }
@@ -202,6 +214,7 @@ private:
   ceph::coarse_mono_clock::time_point last_active;
   ceph::mono_clock::time_point recv_start_time;
   uint64_t last_tick_id = 0;
+  std::atomic<uint64_t> io_bytes = {0};
   const uint64_t connect_timeout_us;
   const uint64_t inactive_timeout_us;
 
@@ -247,14 +247,81 @@ void Processor::stop()
 }
 
 
+/**
+ * Moves established connections between the workers of one NetworkStack.
+ *
+ * The workers are shared by every AsyncMessenger in the process that uses
+ * the same transport, so one rebalancer per stack looks at the connections
+ * of all registered messengers.  It runs on worker 0; msgrs and the
+ * sampling state are only touched from that thread.
+ */
+class ConnectionRebalancer {
+  class C_tick : public EventCallback {
+    ConnectionRebalancer *r;
+  public:
+    explicit C_tick(ConnectionRebalancer *r) : r(r) {}
+    void do_request(uint64_t id) override {
+      r->rebalance();
+    }
+  };
+
+  CephContext *cct;
+  NetworkStack *stack;
+  Worker *worker;
+  EventCallbackRef tick_handler;
+  uint64_t tick_id = 0;
+  std::set<AsyncMessenger*> msgrs;
+  ceph::mono_time last_rebalance;
+  std::vector<utime_t> last_worker_busy;
+
+  void schedule(uint64_t us) {
+    tick_id = worker->center.create_time_event(us, tick_handler);
+  }
+  void rebalance();
+
+public:
+  ConnectionRebalancer(CephContext *c, NetworkStack *s)
+    : cct(c), stack(s), worker(s->get_worker(0)),
+      tick_handler(new C_tick(this)) {}
+  ~ConnectionRebalancer() {
+    delete tick_handler;
+  }
+
+  void add(AsyncMessenger *m) {
+    worker->center.submit_to(worker->center.get_id(), [this, m] {
+      msgrs.insert(m);
+      if (!tick_id) {
+	rebalance();
+      }
+    }, true);
+  }
+  /// blocks until the rebalancer no longer references the messenger
+  void remove(AsyncMessenger *m) {
+    worker->center.submit_to(worker->center.get_id(), [this, m] {
+      msgrs.erase(m);
+      if (msgrs.empty() && tick_id) {
+	worker->center.delete_time_event(tick_id);
+	tick_id = 0;
+	last_worker_busy.clear();
+      }
+    });
+  }
+};
+
 struct StackSingleton {
   CephContext *cct;
   std::shared_ptr<NetworkStack> stack;
+  std::unique_ptr<ConnectionRebalancer> rebalancer;
 
   explicit StackSingleton(CephContext *c): cct(c) {}
   void ready(std::string &type) {
-    if (!stack)
+    if (!stack) {
       stack = NetworkStack::create(cct, type);
+      if (stack->support_connection_migration() &&
+	  stack->get_num_worker() > 1) {
+	rebalancer = std::make_unique<ConnectionRebalancer>(cct, stack.get());
+      }
+    }
   }
   ~StackSingleton() {
     stack->stop();
@@ -293,6 +360,7 @@ AsyncMessenger::AsyncMessenger(CephContext *cct, entity_name_t name,
     "AsyncMessenger::NetworkStack::" + transport_type, true, cct);
   single->ready(transport_type);
   stack = single->stack.get();
+  rebalancer = single->rebalancer.get();
   stack->start();
   local_worker = stack->get_worker();
   local_connection = ceph::make_ref<AsyncConnection>(cct, this, &dispatch_queue,
@@ -335,6 +403,10 @@ void AsyncMessenger::ready()
   for (auto &&p : processors)
     p->start();
   dispatch_queue.start();
+
+  if (rebalancer) {
+    rebalancer->add(this);
+  }
 }
 
 int AsyncMessenger::shutdown()
@@ -342,6 +414,9 @@ int AsyncMessenger::shutdown()
   ldout(cct,10) << __func__ << " " << get_myaddrs() << dendl;
 
   // done!  clean up.
+  if (rebalancer) {
+    rebalancer->remove(this);
+  }
   for (auto &&p : processors)
     p->stop();
   mark_down_all();
@@ -844,7 +919,7 @@ int AsyncMessenger::accept_conn(const AsyncConnectionRef& conn)
   std::lock_guard l{lock};
   if (conn->policy.server &&
       conn->policy.lossy &&
-      !conn->policy.register_lossy_clients) {
+      (!conn->policy.register_lossy_clients || conn->anon)) {
     anon_conns.insert(conn);
     conn->get_perf_counter()->inc(l_msgr_active_connections);
     return 0;
@@ -942,3 +1017,97 @@ void AsyncMessenger::reap_dead()
     deleted_conns.clear();
   }
 }
+
+#undef dout_prefix
+#define dout_prefix *_dout << "-- ConnectionRebalancer "
+
+void ConnectionRebalancer::rebalance()
+{
+  ceph_assert(worker->center.in_thread());
+  tick_id = 0;
+  if (msgrs.empty()) {
+    return;
+  }
+  auto interval = cct->_conf.get_val<std::chrono::seconds>(
+    "ms_async_rebalance_interval");
+  if (interval.count() == 0) {
+    // disabled for now; look at the option again later
+    schedule(60 * 1000000);
+    last_worker_busy.clear();
+    return;
+  }
+
+  unsigned num_workers = stack->get_num_worker();
+  auto now = ceph::mono_clock::now();
+  double elapsed = std::chrono::duration<double>(now - last_rebalance).count();
+  last_rebalance = now;
+  bool first = last_worker_busy.empty();
+  last_worker_busy.resize(num_workers);
+
+  Worker *hot = nullptr, *cold = nullptr;
+  double hot_ratio = 0, cold_ratio = 0;
+  for (unsigned i = 0; i < num_workers; ++i) {
+    Worker *w = stack->get_worker(i);
+    utime_t busy = w->get_perf_counter()->tget(l_msgr_running_total_time);
+    double ratio = elapsed > 0 ?
+      (double)(busy - last_worker_busy[i]) / elapsed : 0;
+    last_worker_busy[i] = busy;
+    if (!hot || ratio > hot_ratio) {
+      hot = w;
+      hot_ratio = ratio;
+    }
+    if (!cold || ratio < cold_ratio) {
+      cold = w;
+      cold_ratio = ratio;
+    }
+  }
+
+  // sample (and reset) per-connection traffic for this interval, across
+  // every messenger whose connections live on these workers
+  std::vector<std::pair<AsyncConnectionRef, uint64_t>> candidates;
+  uint64_t hot_bytes = 0, cold_bytes = 0;
+  for (auto msgr : msgrs) {
+    std::lock_guard l{msgr->lock};
+    auto sample = [&](const AsyncConnectionRef& c) {
+      uint64_t bytes = c->take_io_bytes();
+      Worker *w = c->get_worker();
+      if (w == hot) {
+	hot_bytes += bytes;
+	if (bytes)
+	  candidates.emplace_back(c, bytes);
+      } else if (w == cold) {
+	cold_bytes += bytes;
+      }
+    };
+    for (const auto& [addrs, c] : msgr->conns)
+      sample(c);
+    for (const auto& c : msgr->anon_conns)
+      sample(c);
+  }
+
+  ldout(cct, 20) << __func__ << " busiest worker " << hot->id
+		 << " ratio " << hot_ratio << " (" << candidates.size()
+		 << " active conns), idlest worker " << cold->id
+		 << " ratio " << cold_ratio << dendl;
+  if (!first && hot != cold && candidates.size() > 1 &&
+      hot_ratio - cold_ratio >
+        cct->_conf.get_val<double>("ms_async_rebalance_threshold")) {
+    // move the connection that best evens out the traffic of the two
+    // workers; moving the single heaviest one would just move the hotspot
+    uint64_t target = hot_bytes > cold_bytes ? (hot_bytes - cold_bytes) / 2 : 0;
+    auto best = std::min_element(
+      candidates.begin(), candidates.end(),
+      [target](const auto& a, const auto& b) {
+	auto da = a.second > target ? a.second - target : target - a.second;
+	auto db = b.second > target ? b.second - target : target - b.second;
+	return da < db;
+      });
+    ldout(cct, 5) << __func__ << " moving " << best->first << " ("
+		  << best->second << " bytes) from worker " << hot->id
+		  << " to worker " << cold->id << dendl;
+    best->first->migrate_to(cold);
+  }
+
+  schedule(std::chrono::duration_cast<std::chrono::microseconds>(
+    interval).count());
+}
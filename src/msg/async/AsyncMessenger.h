@@ -37,6 +37,7 @@
 #include "include/ceph_assert.h"
 
 class AsyncMessenger;
+class ConnectionRebalancer;
 
 /**
  * If the Messenger binds to a specific address, the Processor runs
@@ -212,6 +213,7 @@ private:
   NetworkStack *stack;
   std::vector<Processor*> processors;
   friend class Processor;
+  friend class ConnectionRebalancer;
   DispatchQueue dispatch_queue;
 
   // the worker run messenger's cron jobs
@@ -289,6 +291,10 @@ private:
 
   EventCallbackRef reap_handler;
 
+  /// moves connections between the stack's workers; shared with every other
+  /// messenger on the same stack, null if the stack can't migrate them
+  ConnectionRebalancer *rebalancer = nullptr;
+
   /// internal cluster protocol version, if any, for talking to entities of the same type.
   int cluster_protocol = 0;
 
@@ -145,6 +145,8 @@ int EventCenter::init(int nevent, unsigned center_id, const std::string &type)
   if (!driver->need_wakeup())
     return 0;
 
+  busy_poll_us = cct->_conf.get_val<uint64_t>("ms_async_busy_poll_us");
+
   int fds[2];
 
   #ifdef _WIN32
@@ -405,7 +407,11 @@ int EventCenter::process_events(unsigned timeout_microseconds,  ceph::timespan *
 
   ldout(cct, 30) << __func__ << " wait second " << tv.tv_sec << " usec " << tv.tv_usec << dendl;
   std::vector<FiredFileEvent> fired_events;
-  numevents = driver->event_wait(fired_events, &tv);
+  if (blocking && busy_poll_us) {
+    numevents = busy_wait(fired_events, &tv);
+  } else {
+    numevents = driver->event_wait(fired_events, &tv);
+  }
   auto working_start = ceph::mono_clock::now();
   for (int event_id = 0; event_id < numevents; event_id++) {
     int rfired = 0;
@@ -441,7 +447,17 @@ int EventCenter::process_events(unsigned timeout_microseconds,  ceph::timespan *
     std::deque<EventCallbackRef> cur_process;
     cur_process.swap(external_events);
     external_num_events.store(0);
+    auto wakeup_stamp = std::move(external_wakeup_stamp);
+    external_wakeup_stamp.reset();
+    bool wakeup_polled = external_wakeup_polled;
     external_lock.unlock();
+    if (wakeup_stamp && wakeup_logger) {
+      auto lat = ceph::mono_clock::now() - *wakeup_stamp;
+      wakeup_logger->hinc(
+        wakeup_hist_idx,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(lat).count(),
+        wakeup_polled);
+    }
     numevents += cur_process.size();
     while (!cur_process.empty()) {
       EventCallbackRef e = cur_process.front();
@@ -471,9 +487,50 @@ void EventCenter::dispatch_event_external(EventCallbackRef e)
     }
     external_events.push_back(e);
     num = ++external_num_events;
+    if (num == 1 && !in_thread()) {
+      external_wakeup_stamp = ceph::mono_clock::now();
+      external_wakeup_polled = polling.load();
+    }
   }
-  if (num == 1 && !in_thread())
+  // a spinning owner picks the event up by itself, spare the write
+  if (num == 1 && !in_thread() && !polling.load())
     wakeup();
 
   ldout(cct, 30) << __func__ << " " << e << " pending " << num << dendl;
 }
+
+int EventCenter::busy_wait(std::vector<FiredFileEvent> &fired_events,
+                           struct timeval *tv)
+{
+  // Spin for up to busy_poll_us (never beyond the caller's deadline)
+  // before falling back to a blocking wait.  While we spin, producers
+  // see `polling` and don't bother writing to the notify pipe.
+  uint64_t timeout_us = tv->tv_sec * 1000000ull + tv->tv_usec;
+  auto start = ceph::mono_clock::now();
+  auto spin_end = start + std::chrono::microseconds(
+    std::min(busy_poll_us, timeout_us));
+  struct timeval zero = {0, 0};
+  int numevents = 0;
+
+  polling.store(true);
+  do {
+    numevents = driver->event_wait(fired_events, &zero);
+    if (numevents != 0 || external_num_events.load())
+      break;
+  } while (ceph::mono_clock::now() < spin_end);
+  polling.store(false);
+
+  // a producer that still saw `polling` set skipped notify(), but its
+  // event is visible to us now that we cleared it
+  if (numevents != 0 || external_num_events.load())
+    return numevents;
+
+  uint64_t spent_us = std::chrono::duration_cast<std::chrono::microseconds>(
+    ceph::mono_clock::now() - start).count();
+  if (spent_us >= timeout_us)
+    return 0;
+  struct timeval rest;
+  rest.tv_sec = (timeout_us - spent_us) / 1000000;
+  rest.tv_usec = (timeout_us - spent_us) % 1000000;
+  return driver->event_wait(fired_events, &rest);
+}
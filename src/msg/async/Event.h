@@ -39,10 +39,12 @@
 
 #include <atomic>
 #include <mutex>
+#include <optional>
 #include <condition_variable>
 
 #include "common/ceph_time.h"
 #include "common/dout.h"
+#include "common/perf_counters.h"
 #include "net_handler.h"
 
 #define EVENT_NONE 0
@@ -160,6 +162,15 @@ class EventCenter {
   std::mutex external_lock;
   std::atomic_ulong external_num_events;
   std::deque<EventCallbackRef> external_events;
+  // when the first external event was queued from another thread, and
+  // whether we were spinning at that point (protected by external_lock)
+  std::optional<ceph::mono_time> external_wakeup_stamp;
+  bool external_wakeup_polled = false;
+  // set while the owner spins in busy_wait(); producers skip notify()
+  std::atomic_bool polling = {false};
+  uint64_t busy_poll_us = 0;
+  PerfCounters *wakeup_logger = nullptr;
+  int wakeup_hist_idx = 0;
   std::vector<FileEvent> file_events;
   EventDriver *driver;
   std::multimap<clock_type::time_point, TimeEvent> time_events;
@@ -177,6 +188,7 @@ class EventCenter {
   AssociatedCenters *global_centers = nullptr;
 
   int process_time_events();
+  int busy_wait(std::vector<FiredFileEvent> &fired_events, struct timeval *tv);
   FileEvent *_get_file_event(int fd) {
     ceph_assert(fd < nevent);
     return &file_events[fd];
@@ -198,6 +210,11 @@ class EventCenter {
   unsigned get_id() const { return center_id; }
 
   EventDriver *get_driver() { return driver; }
+  /// record wakeup latency of external events into histogram idx of l
+  void set_wakeup_histogram(PerfCounters *l, int idx) {
+    wakeup_logger = l;
+    wakeup_hist_idx = idx;
+  }
 
   // Used by internal thread
   int create_file_event(int fd, int mask, EventCallbackRef ctxt);
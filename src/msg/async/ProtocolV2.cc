@@ -85,6 +85,7 @@ if(connection->interceptor) { \
 ProtocolV2::ProtocolV2(AsyncConnection *connection)
     : Protocol(2, connection),
       state(NONE),
+      supported_features(0),
       peer_supported_features(0),
       client_cookie(0),
       server_cookie(0),
@@ -564,6 +565,7 @@ ssize_t ProtocolV2::write_message(Message *m, bool more) {
   } else {
     connection->logger->inc(
         l_msgr_send_bytes, total_send_size - connection->outgoing_bl.length());
+    update_compression_stats();
     ldout(cct, 10) << __func__ << " sending " << m
                    << (rc ? " continuely." : " done.") << dendl;
   }
@@ -626,11 +628,48 @@ void ProtocolV2::handle_message_ack(uint64_t seq) {
 void ProtocolV2::reset_compression() {
   ldout(cct, 5) << __func__ << dendl;
 
+  update_compression_stats();
+  if (session_compression_handlers.tx) {
+    const auto tx = session_compression_handlers.tx->get_total_stats();
+    const auto rx = session_compression_handlers.rx->get_total_stats();
+    ldout(cct, 10) << __func__ << " dict=" << comp_meta.is_dict()
+                   << " tx frames=" << tx.frames << " ratio=" << tx.get_ratio()
+                   << " time=" << tx.time
+                   << " rx frames=" << rx.frames << " ratio=" << rx.get_ratio()
+                   << " time=" << rx.time << dendl;
+  }
   comp_meta = CompConnectionMeta{};
   session_compression_handlers.rx.reset(nullptr);
   session_compression_handlers.tx.reset(nullptr);
 }
 
+bool ProtocolV2::is_compress_dict_supported() const {
+  return HAVE_MSGR2_FEATURE(supported_features, COMPRESSION_DICT) &&
+         HAVE_MSGR2_FEATURE(peer_supported_features, COMPRESSION_DICT);
+}
+
+void ProtocolV2::update_compression_stats() {
+  auto& [rx, tx] = session_compression_handlers;
+  if (tx) {
+    const auto s = tx->take_stats();
+    if (s.time != ceph::timespan::zero()) {
+      connection->logger->inc(l_msgr_compress_frames, s.frames);
+      connection->logger->inc(l_msgr_compress_raw_bytes, s.raw_bytes);
+      connection->logger->inc(l_msgr_compress_wire_bytes, s.wire_bytes);
+      connection->logger->tinc(l_msgr_compress_time, s.time);
+    }
+  }
+  if (rx) {
+    const auto s = rx->take_stats();
+    if (s.time != ceph::timespan::zero()) {
+      connection->logger->inc(l_msgr_decompress_frames, s.frames);
+      connection->logger->inc(l_msgr_decompress_raw_bytes, s.raw_bytes);
+      connection->logger->inc(l_msgr_decompress_wire_bytes, s.wire_bytes);
+      connection->logger->tinc(l_msgr_decompress_time, s.time);
+    }
+  }
+}
+
 void ProtocolV2::write_event() {
   ldout(cct, 10) << __func__ << dendl;
   ssize_t r = 0;
@@ -835,9 +874,14 @@ CtPtr ProtocolV2::_banner_exchange(CtRef callback) {
   ldout(cct, 20) << __func__ << dendl;
   bannerExchangeCallback = &callback;
 
+  supported_features = CEPH_MSGR2_SUPPORTED_FEATURES;
+  if (!messenger->comp_registry.get_is_compress_dict()) {
+    supported_features &= ~CEPH_MSGR2_FEATURE_COMPRESSION_DICT;
+  }
+
   ceph::bufferlist banner_payload;
   using ceph::encode;
-  encode((uint64_t)CEPH_MSGR2_SUPPORTED_FEATURES, banner_payload, 0);
+  encode(supported_features, banner_payload, 0);
   encode((uint64_t)CEPH_MSGR2_REQUIRED_FEATURES, banner_payload, 0);
 
   ceph::bufferlist bl;
@@ -925,7 +969,6 @@ CtPtr ProtocolV2::_handle_peer_banner_payload(rx_buffer_t &&buffer, int r) {
 
   // Check feature bit compatibility
 
-  uint64_t supported_features = CEPH_MSGR2_SUPPORTED_FEATURES;
   uint64_t required_features = CEPH_MSGR2_REQUIRED_FEATURES;
 
   if ((required_features & peer_supported_features) != required_features) {
@@ -947,6 +990,7 @@ CtPtr ProtocolV2::_handle_peer_banner_payload(rx_buffer_t &&buffer, int r) {
   }
 
   this->peer_supported_features = peer_supported_features;
+  connection->set_peer_msgr2_features(peer_supported_features);
   if (peer_required_features == 0) {
     this->connection_features = msgr2_required;
   }
@@ -1476,6 +1520,7 @@ CtPtr ProtocolV2::handle_message() {
   connection->logger->inc(l_msgr_recv_messages);
   connection->logger->inc(l_msgr_recv_bytes,
                           rx_frame_asm.get_frame_onwire_len());
+  update_compression_stats();
 
   messenger->ms_fast_preprocess(message);
   fast_dispatch_time = ceph::mono_clock::now();
@@ -1887,6 +1932,19 @@ CtPtr ProtocolV2::send_client_ident() {
   if (connection->policy.lossy) {
     flags |= CEPH_MSG_CONNECT_LOSSY;
   }
+  if (connection->is_anon() &&
+      connection->get_peer_type() == CEPH_ENTITY_TYPE_OSD) {
+    // only the objecter's extra osd connections; other anonymous
+    // connections (e.g. MonClient commands) register as before
+    if (!HAVE_MSGR2_FEATURE(peer_supported_features, CONNECT_ANON)) {
+      // an older osd would register this session under our address and
+      // replace the primary connection with it
+      ldout(cct, 1) << __func__ << " peer does not support anonymous"
+                    << " sessions, dropping connection" << dendl;
+      return _fault();
+    }
+    flags |= CEPH_MSG_CONNECT_ANON;
+  }
 
   auto client_ident = ClientIdentFrame::Encode(
       messenger->get_myaddrs(),
@@ -2152,8 +2210,11 @@ CtPtr ProtocolV2::handle_compression_done(ceph::bufferlist &payload) {
   if (comp_meta.is_compress() != response.is_compress()) {
     comp_meta.con_mode = Compressor::COMP_NONE;
   }
+  comp_meta.con_dict = comp_meta.is_compress() && is_compress_dict_supported();
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta,
+    messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    messenger->comp_registry.get_min_compression_dict_size(connection->get_peer_type()));
 
   return start_session_connect();
 }
@@ -2394,7 +2455,15 @@ CtPtr ProtocolV2::handle_client_ident(ceph::bufferlist &payload)
 
   if (connection->policy.server &&
       connection->policy.lossy &&
-      !connection->policy.register_lossy_clients) {
+      (client_ident.flags() & CEPH_MSG_CONNECT_ANON)) {
+    // the client keeps other connections to us open alongside this one;
+    // don't let it replace (or be replaced by) them
+    connection->anon = true;
+  }
+
+  if (connection->policy.server &&
+      connection->policy.lossy &&
+      (!connection->policy.register_lossy_clients || connection->anon)) {
     // incoming lossy client, no need to register this connection
   } else {
     // Looks good so far, let's check if there is already an existing connection
@@ -2714,6 +2783,7 @@ CtPtr ProtocolV2::reuse_connection(const AsyncConnectionRef& existing,
   exproto->pre_auth.enabled = false;
 
   if (!reconnecting) {
+    exproto->supported_features = supported_features;
     exproto->peer_supported_features = peer_supported_features;
     exproto->tx_frame_asm.set_is_rev1(tx_frame_asm.get_is_rev1());
     exproto->rx_frame_asm.set_is_rev1(rx_frame_asm.get_is_rev1());
@@ -2991,6 +3061,7 @@ CtPtr ProtocolV2::handle_compression_request(ceph::bufferlist &payload) {
   } else {
     comp_meta.con_method = Compressor::COMP_ALG_NONE;
   }
+  comp_meta.con_dict = comp_meta.is_compress() && is_compress_dict_supported();
   
   auto response = CompressionDoneFrame::Encode(comp_meta.is_compress(), comp_meta.get_method());
 
@@ -3003,7 +3074,9 @@ CtPtr ProtocolV2::finish_compression() {
   // allow reusing finish_compression().
   
   session_compression_handlers = ceph::compression::onwire::rxtx_t::create_handler_pair(
-    cct, comp_meta, messenger->comp_registry.get_min_compression_size(connection->get_peer_type()));
+    cct, comp_meta,
+    messenger->comp_registry.get_min_compression_size(connection->get_peer_type()),
+    messenger->comp_registry.get_min_compression_dict_size(connection->get_peer_type()));
 
   state = SESSION_ACCEPTING;
   return CONTINUE(read_frame);
@@ -78,6 +78,7 @@ private:
 private:
   entity_name_t peer_name;
   State state;
+  uint64_t supported_features;  // CEPH_MSGR2_FEATURE_* we advertised
   uint64_t peer_supported_features;  // CEPH_MSGR2_FEATURE_*
 
   uint64_t client_cookie;
@@ -153,6 +154,8 @@ private:
   ssize_t write_message(Message *m, bool more);
   void handle_message_ack(uint64_t seq);
   void reset_compression();
+  bool is_compress_dict_supported() const;
+  void update_compression_stats();
 
   CONTINUATION_DECL(ProtocolV2, _wait_for_peer_banner);
   READ_BPTR_HANDLER_CONTINUATION_DECL(ProtocolV2, _handle_peer_banner);
@@ -203,6 +203,20 @@ enum {
   l_msgr_send_messages_queue_lat,
   l_msgr_handle_ack_lat,
 
+  l_msgr_migrated_in_connections,
+  l_msgr_migrated_out_connections,
+
+  l_msgr_wakeup_lat_histogram,
+
+  l_msgr_compress_frames,
+  l_msgr_compress_raw_bytes,
+  l_msgr_compress_wire_bytes,
+  l_msgr_compress_time,
+  l_msgr_decompress_frames,
+  l_msgr_decompress_raw_bytes,
+  l_msgr_decompress_wire_bytes,
+  l_msgr_decompress_time,
+
   l_msgr_last,
 };
 
@@ -246,8 +260,39 @@ class Worker {
     plb.add_time_avg(l_msgr_send_messages_queue_lat, "msgr_send_messages_queue_lat", "Network sent messages lat");
     plb.add_time_avg(l_msgr_handle_ack_lat, "msgr_handle_ack_lat", "Connection handle ack lat");
 
+    plb.add_u64_counter(l_msgr_migrated_in_connections, "msgr_migrated_in_connections", "Connections moved to this worker by rebalancing");
+    plb.add_u64_counter(l_msgr_migrated_out_connections, "msgr_migrated_out_connections", "Connections moved off this worker by rebalancing");
+
+    PerfHistogramCommon::axis_config_d wakeup_lat_axis{
+      "Latency (nsec)",
+      PerfHistogramCommon::SCALE_LOG2,
+      0,
+      1000,  // 1 usec
+      16,    // up to ~32 msec
+    };
+    PerfHistogramCommon::axis_config_d wakeup_mode_axis{
+      "Busy polling",
+      PerfHistogramCommon::SCALE_LINEAR,
+      0,
+      1,
+      2,     // 0 = woken through notify, 1 = picked up while spinning
+    };
+    plb.add_u64_counter_histogram(l_msgr_wakeup_lat_histogram, "msgr_wakeup_latency_histogram",
+                                  wakeup_lat_axis, wakeup_mode_axis,
+                                  "Delay between queueing an external event and the worker picking it up");
+
+    plb.add_u64_counter(l_msgr_compress_frames, "msgr_compress_frames", "Frames sent compressed");
+    plb.add_u64_counter(l_msgr_compress_raw_bytes, "msgr_compress_raw_bytes", "Payload of compressed frames before compression", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_msgr_compress_wire_bytes, "msgr_compress_wire_bytes", "Payload of compressed frames after compression", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_time(l_msgr_compress_time, "msgr_compress_time", "The total time spent compressing frames");
+    plb.add_u64_counter(l_msgr_decompress_frames, "msgr_decompress_frames", "Compressed frames received");
+    plb.add_u64_counter(l_msgr_decompress_raw_bytes, "msgr_decompress_raw_bytes", "Payload of compressed frames after decompression", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_u64_counter(l_msgr_decompress_wire_bytes, "msgr_decompress_wire_bytes", "Payload of compressed frames as received", NULL, 0, unit_t(UNIT_BYTES));
+    plb.add_time(l_msgr_decompress_time, "msgr_decompress_time", "The total time spent decompressing frames");
+
     perf_logger = plb.create_perf_counters();
     cct->get_perfcounters_collection()->add(perf_logger);
+    center.set_wakeup_histogram(perf_logger, l_msgr_wakeup_lat_histogram);
   }
   virtual ~Worker() {
     if (perf_logger) {
@@ -330,6 +375,10 @@ class NetworkStack {
   // need to let each thread do binding port.
   virtual bool support_local_listen_table() const { return false; }
   virtual bool nonblock_connect_need_writable_event() const { return true; }
+  // backend need to override this method if an established socket can be
+  // handed over to another worker's EventCenter, i.e. it is nothing more
+  // than a file descriptor.
+  virtual bool support_connection_migration() const { return false; }
 
   void start();
   void stop();
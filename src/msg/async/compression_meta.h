@@ -8,6 +8,7 @@ struct CompConnectionMeta {
     TOPNSPC::Compressor::COMP_NONE;  // negotiated mode
   TOPNSPC::Compressor::CompressionAlgorithm con_method =
     TOPNSPC::Compressor::COMP_ALG_NONE; // negotiated method
+  bool con_dict = false;  // both sides offered CEPH_MSGR2_FEATURE_COMPRESSION_DICT
 
   bool is_compress() const {
     return con_mode != TOPNSPC::Compressor::COMP_NONE;
@@ -18,4 +19,7 @@ struct CompConnectionMeta {
   TOPNSPC::Compressor::CompressionMode get_mode() const {
     return con_mode;
   }
+  bool is_dict() const {
+    return con_dict;
+  }
 };
@@ -12,20 +12,47 @@ namespace ceph::compression::onwire {
 rxtx_t rxtx_t::create_handler_pair(
     CephContext* ctx,
     const CompConnectionMeta& comp_meta,
-    std::uint64_t compress_min_size)
+    std::uint64_t compress_min_size,
+    std::uint64_t compress_dict_min_size)
 {
   if (comp_meta.is_compress()) {
      CompressorRef compressor = Compressor::create(ctx, comp_meta.get_method());
     if (compressor) {
-      return {std::make_unique<RxHandler>(ctx, compressor),
+      // both ends run the same check against the same negotiated method
+      const bool with_dict = comp_meta.is_dict() && compressor->supports_dict();
+      return {std::make_unique<RxHandler>(ctx, compressor, with_dict),
 	      std::make_unique<TxHandler>(ctx, compressor,
 					  comp_meta.get_mode(),
-					  compress_min_size)};
+					  with_dict ? compress_dict_min_size : compress_min_size,
+					  with_dict)};
     }
   }
   return {};
 }
 
+void DictWindow::append(const ceph::bufferlist& bl)
+{
+  // only the tail of a large frame can end up in the window
+  uint64_t skip = bl.length() > SIZE ? bl.length() - SIZE : 0;
+  for (const auto& p : bl.buffers()) {
+    if (skip >= p.length()) {
+      skip -= p.length();
+      continue;
+    }
+    m_buf.insert(m_buf.end(), p.c_str() + skip, p.c_str() + p.length());
+    skip = 0;
+  }
+  if (m_buf.size() - m_start > SIZE) {
+    m_start = m_buf.size() - SIZE;
+  }
+  // let the buffer grow to twice the window before moving the data,
+  // so the copying is amortized over many small frames
+  if (m_start >= SIZE) {
+    m_buf.erase(m_buf.begin(), m_buf.begin() + m_start);
+    m_start = 0;
+  }
+}
+
 std::optional<ceph::bufferlist> TxHandler::compress(const ceph::bufferlist &input)
 {
   if (m_init_onwire_size < m_min_size) {
@@ -46,13 +73,26 @@ std::optional<ceph::bufferlist> TxHandler::compress(const ceph::bufferlist &inpu
     return out;
   }
 
-  boost::optional<int32_t> compressor_message;
-  if (m_compressor->compress(input, out, compressor_message)) {
+  const auto start = ceph::mono_clock::now();
+  int r;
+  if (m_dict) {
+    // every segment of the frame sees the window as of the frame start
+    r = m_compressor->compress_with_dict(input, out, m_dict->view());
+  } else {
+    boost::optional<int32_t> compressor_message;
+    r = m_compressor->compress(input, out, compressor_message);
+  }
+  m_stats.time += ceph::mono_clock::now() - start;
+  if (r) {
     return {};
   } else {
     ldout(m_cct, 20) << __func__ << " uncompressed.length()=" << input.length()
-                     << " compressed.length()=" << out.length() << dendl;
+                     << " compressed.length()=" << out.length()
+                     << " dict=" << (m_dict ? m_dict->view().size() : 0) << dendl;
     m_onwire_size += out.length();
+    if (m_dict) {
+      m_pending.append(input);
+    }
     return out;
   }
 }
@@ -68,19 +108,48 @@ std::optional<ceph::bufferlist> RxHandler::decompress(const ceph::bufferlist &in
     return out;
   }
 
-  boost::optional<int32_t> compressor_message;
-  if (m_compressor->decompress(input, out, compressor_message)) {
+  const auto start = ceph::mono_clock::now();
+  int r;
+  if (m_dict) {
+    r = m_compressor->decompress_with_dict(input, out, m_dict->view());
+  } else {
+    boost::optional<int32_t> compressor_message;
+    r = m_compressor->decompress(input, out, compressor_message);
+  }
+  m_stats.time += ceph::mono_clock::now() - start;
+  if (r) {
     return {};
   } else {
     ldout(m_cct, 20) << __func__ << " compressed.length()=" << input.length()
                      << " uncompressed.length()=" << out.length() << dendl;
+    m_stats.raw_bytes += out.length();
+    m_stats.wire_bytes += input.length();
+    if (m_dict) {
+      m_pending.append(out);
+    }
     return out;
   }
 }
 
+void RxHandler::done()
+{
+  m_stats.frames++;
+  if (m_dict) {
+    m_dict->append(m_pending);
+    m_pending.clear();
+  }
+}
+
 void TxHandler::done()
 {
   ldout(m_cct, 25) << __func__ << " compression ratio=" << get_ratio() << dendl;
+  m_stats.frames++;
+  m_stats.raw_bytes += m_init_onwire_size;
+  m_stats.wire_bytes += m_onwire_size;
+  if (m_dict) {
+    m_dict->append(m_pending);
+    m_pending.clear();
+  }
 }
 
 } // namespace ceph::compression::onwire
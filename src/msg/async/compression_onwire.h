@@ -5,7 +5,11 @@
 #define CEPH_COMPRESSION_ONWIRE_H
 
 #include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "common/ceph_time.h"
 #include "compressor/Compressor.h"
 #include "include/buffer.h"
 
@@ -15,20 +19,84 @@ namespace ceph::compression::onwire {
   using Compressor = TOPNSPC::Compressor;
   using CompressorRef = TOPNSPC::CompressorRef;
 
+  struct Stats {
+    uint64_t frames = 0;      // frames that went out/came in compressed
+    uint64_t raw_bytes = 0;   // their payload before compression
+    uint64_t wire_bytes = 0;  // and after
+    ceph::timespan time = ceph::timespan::zero();  // spent in the compressor
+
+    Stats& operator+=(const Stats& rhs) {
+      frames += rhs.frames;
+      raw_bytes += rhs.raw_bytes;
+      wire_bytes += rhs.wire_bytes;
+      time += rhs.time;
+      return *this;
+    }
+    double get_ratio() const {
+      return wire_bytes ? raw_bytes / (double) wire_bytes : 0;
+    }
+  };
+
+  /**
+   * The most recent payload of one direction of a connection, used as
+   * raw-content dictionary for the next frame.  Sender and receiver
+   * append exactly the same bytes in frame order, so the dictionary is
+   * never sent over the wire.
+   */
+  class DictWindow {
+  public:
+    static constexpr std::size_t SIZE = 32 << 10;
+
+    std::string_view view() const {
+      return {m_buf.data() + m_start, m_buf.size() - m_start};
+    }
+    void append(const ceph::bufferlist& bl);
+
+  private:
+    std::vector<char> m_buf;
+    std::size_t m_start = 0;
+  };
+
   class Handler {
   public:
-    Handler(CephContext* const cct, CompressorRef compressor)
-      : m_cct(cct), m_compressor(compressor) {}
+    Handler(CephContext* const cct, CompressorRef compressor, bool with_dict)
+      : m_cct(cct), m_compressor(compressor) {
+      if (with_dict) {
+	m_dict.emplace();
+      }
+    }
+
+    bool has_dict() const {
+      return m_dict.has_value();
+    }
+
+    /// stats accumulated since the previous call
+    Stats take_stats() {
+      m_total += m_stats;
+      return std::exchange(m_stats, Stats{});
+    }
+
+    /// stats over the handler's whole life
+    Stats get_total_stats() const {
+      Stats total = m_total;
+      total += m_stats;
+      return total;
+    }
 
   protected:
     CephContext* const m_cct;
     CompressorRef m_compressor;
+    std::optional<DictWindow> m_dict;
+    // payload of the current frame, to be added to m_dict once it is done
+    ceph::bufferlist m_pending;
+    Stats m_stats;
+    Stats m_total;
   };
 
-  class RxHandler final : private Handler {
+  class RxHandler final : public Handler {
   public:
-    RxHandler(CephContext* const cct, CompressorRef compressor)
-      : Handler(cct, compressor) {}
+    RxHandler(CephContext* const cct, CompressorRef compressor, bool with_dict)
+      : Handler(cct, compressor, with_dict) {}
     ~RxHandler() {};
 
     /**
@@ -40,12 +108,16 @@ namespace ceph::compression::onwire {
      * @returns true on success, false on failure
      */
     std::optional<ceph::bufferlist> decompress(const ceph::bufferlist &input);
+
+    /// all segments of a compressed frame have been decompressed
+    void done();
   };
 
-  class TxHandler final : private Handler {
+  class TxHandler final : public Handler {
   public:
-    TxHandler(CephContext* const cct, CompressorRef compressor, int mode, std::uint64_t min_size)
-      : Handler(cct, compressor),
+    TxHandler(CephContext* const cct, CompressorRef compressor, int mode,
+	      std::uint64_t min_size, bool with_dict)
+      : Handler(cct, compressor, with_dict),
 	m_min_size(min_size),
 	m_mode(static_cast<Compressor::CompressionMode>(mode))
     {}
@@ -55,6 +127,7 @@ namespace ceph::compression::onwire {
       m_init_onwire_size = size;
       m_compress_potential = size;
       m_onwire_size = 0;
+      m_pending.clear();
     }
 
     void done();
@@ -97,7 +170,8 @@ namespace ceph::compression::onwire {
     static rxtx_t create_handler_pair(
       CephContext* ctx,
       const CompConnectionMeta& comp_meta,
-      std::uint64_t compress_min_size);
+      std::uint64_t compress_min_size,
+      std::uint64_t compress_dict_min_size);
   };
 }
 
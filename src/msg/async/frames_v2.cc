@@ -545,6 +545,7 @@ void FrameAssembler::disassemble_decompress(bufferlist segment_bls[]) const {
       segment_bls[i] = std::move(*out);
     }
   }
+  m_compression->rx->done();
 }
 
 }  // namespace ceph::msgr::v2
@@ -50,6 +50,23 @@ public:
     }
   }
 
+  uint64_t get_min_compression_dict_size(uint32_t peer_type) const {
+    std::scoped_lock l(lock);
+    switch (peer_type) {
+      case CEPH_ENTITY_TYPE_OSD:
+        return ms_osd_compress_dict_min_size;
+      default:
+        return 0;
+    }
+  }
+
+  // whether we offer dictionary compression (CEPH_MSGR2_FEATURE_COMPRESSION_DICT)
+  // at all; the peer type is not yet known during the banner exchange
+  bool get_is_compress_dict() const {
+    std::scoped_lock l(lock);
+    return ms_osd_compress_dict;
+  }
+
   bool get_is_compress_secure() const { 
     std::scoped_lock l(lock);
     return ms_compress_secure; 
@@ -62,6 +79,8 @@ private:
   uint32_t ms_osd_compress_mode;
   bool ms_compress_secure;
   std::uint64_t ms_osd_compress_min_size;
+  bool ms_osd_compress_dict;
+  std::uint64_t ms_osd_compress_dict_min_size;
   std::vector<uint32_t> ms_osd_compression_methods;
 
   void _refresh_config();
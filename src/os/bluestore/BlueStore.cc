@@ -1134,7 +1134,16 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
   }
   void _unpin(BlueStore::Onode* o) override
   {
-    lru.push_front(*o);
+    if (_note_access(o) == ONODE_CLASS_SCAN) {
+      // don't let a sweep push the working set out
+      if (o->cache_seg == ONODE_SEG_NEW) {
+        o->cache_seg = ONODE_SEG_PROBATION;
+      }
+      lru.push_back(*o);
+    } else {
+      o->cache_seg = ONODE_SEG_HOT;
+      lru.push_front(*o);
+    }
     ceph_assert(num_pinned);
     --num_pinned;
     dout(20) << __func__ << " " << this << " " << " " << " " << o->oid << " unpinned" << dendl;
@@ -1168,6 +1177,150 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
         ceph_assert(n == 0);
         lru.erase(p);
       }
+      _note_eviction(o);
+      auto pinned = !o->pop_cache();
+      ceph_assert(!pinned);
+      o->c->onode_map._remove(o->oid);
+    }
+  }
+  void move_pinned(OnodeCacheShard *to, BlueStore::Onode *o) override
+  {
+    if (to == this) {
+      return;
+    }
+    ceph_assert(o->cached);
+    ceph_assert(o->pinned);
+    ceph_assert(num);
+    ceph_assert(num_pinned);
+    --num_pinned;
+    --num;
+    ++to->num_pinned;
+    ++to->num;
+  }
+  void add_stats(uint64_t *onodes, uint64_t *pinned_onodes) override
+  {
+    *onodes += num;
+    *pinned_onodes += num_pinned;
+  }
+  void _dump_lists(Formatter *f) override
+  {
+    f->dump_unsigned("lru", lru.size());
+  }
+};
+
+// TwoQOnodeCacheShard
+//
+// Onodes start out on the probation list and are only promoted to the
+// hot list when a client request references them again.  Accesses
+// flagged as scans (see Onode::hint_cache_scan) never promote, so a
+// listing, scrub or orphan sweep churns through probation and leaves
+// the hot list alone.  Probation is trimmed first whenever it holds
+// more than bluestore_onode_cache_probation_ratio of the shard.
+struct TwoQOnodeCacheShard : public BlueStore::OnodeCacheShard {
+  typedef boost::intrusive::list<
+    BlueStore::Onode,
+    boost::intrusive::member_hook<
+      BlueStore::Onode,
+      boost::intrusive::list_member_hook<>,
+      &BlueStore::Onode::lru_item> > list_t;
+
+  list_t probation;  ///< "A1in" new and scan-only onodes
+  list_t hot;        ///< "Am" onodes re-referenced by clients
+
+  double probation_ratio;
+
+  explicit TwoQOnodeCacheShard(CephContext *cct)
+    : BlueStore::OnodeCacheShard(cct),
+      probation_ratio(
+	cct->_conf.get_val<double>("bluestore_onode_cache_probation_ratio")) {}
+
+  list_t& _list_of(BlueStore::Onode* o) {
+    return o->cache_seg == ONODE_SEG_HOT ? hot : probation;
+  }
+
+  void _add(BlueStore::Onode* o, int level) override
+  {
+    if (o->put_cache()) {
+      list_t& l = _list_of(o);
+      (level > 0) ? l.push_front(*o) : l.push_back(*o);
+    } else {
+      ++num_pinned;
+    }
+    ++num; // we count both pinned and unpinned entries
+    dout(20) << __func__ << " " << this << " " << o->oid << " added, num=" << num << dendl;
+  }
+  void _rm(BlueStore::Onode* o) override
+  {
+    if (o->pop_cache()) {
+      list_t& l = _list_of(o);
+      l.erase(l.iterator_to(*o));
+    } else {
+      ceph_assert(num_pinned);
+      --num_pinned;
+    }
+    ceph_assert(num);
+    --num;
+    dout(20) << __func__ << " " << this << " " << " " << o->oid << " removed, num=" << num << dendl;
+  }
+  void _pin(BlueStore::Onode* o) override
+  {
+    list_t& l = _list_of(o);
+    l.erase(l.iterator_to(*o));
+    ++num_pinned;
+    dout(20) << __func__ << " " << this << " " << o->oid << " pinned" << dendl;
+  }
+  void _unpin(BlueStore::Onode* o) override
+  {
+    int cls = _note_access(o);
+    switch (o->cache_seg) {
+    case ONODE_SEG_NEW:
+      o->cache_seg = ONODE_SEG_PROBATION;
+      break;
+    case ONODE_SEG_PROBATION:
+      if (cls == ONODE_CLASS_CLIENT) {
+	o->cache_seg = ONODE_SEG_HOT;
+	++promotions;
+	if (logger) {
+	  logger->inc(l_bluestore_onode_promotions);
+	}
+      }
+      break;
+    }
+    _list_of(o).push_front(*o);
+    ceph_assert(num_pinned);
+    --num_pinned;
+    dout(20) << __func__ << " " << this << " " << o->oid << " unpinned"
+	     << (o->cache_seg == ONODE_SEG_HOT ? " hot" : " probation")
+	     << dendl;
+  }
+  void _unpin_and_rm(BlueStore::Onode* o) override
+  {
+    o->pop_cache();
+    ceph_assert(num_pinned);
+    --num_pinned;
+    ceph_assert(num);
+    --num;
+  }
+  void _trim_to(uint64_t new_size) override
+  {
+    uint64_t unpinned = probation.size() + hot.size();
+    if (new_size >= unpinned) {
+      return; // don't even try
+    }
+    uint64_t n = unpinned - new_size;
+    uint64_t probation_max = new_size * probation_ratio;
+    ceph_assert(num >= n);
+    num -= n;
+    while (n-- > 0) {
+      list_t& l =
+	(!probation.empty() &&
+	 (probation.size() > probation_max || hot.empty())) ? probation : hot;
+      BlueStore::Onode *o = &l.back();
+      dout(20) << __func__ << "  rm " << o->oid << " "
+               << o->nref << " " << o->cached << " " << o->pinned
+	       << " seg " << (int)o->cache_seg << dendl;
+      l.pop_back();
+      _note_eviction(o);
       auto pinned = !o->pop_cache();
       ceph_assert(!pinned);
       o->c->onode_map._remove(o->oid);
@@ -1192,6 +1345,11 @@ struct LruOnodeCacheShard : public BlueStore::OnodeCacheShard {
     *onodes += num;
     *pinned_onodes += num_pinned;
   }
+  void _dump_lists(Formatter *f) override
+  {
+    f->dump_unsigned("probation", probation.size());
+    f->dump_unsigned("hot", hot.size());
+  }
 };
 
 // OnodeCacheShard
@@ -1201,12 +1359,60 @@ BlueStore::OnodeCacheShard *BlueStore::OnodeCacheShard::create(
     PerfCounters *logger)
 {
   BlueStore::OnodeCacheShard *c = nullptr;
-  // Currently we only implement an LRU cache for onodes
-  c = new LruOnodeCacheShard(cct);
+  if (type == "2q")
+    c = new TwoQOnodeCacheShard(cct);
+  else
+    c = new LruOnodeCacheShard(cct);
   c->logger = logger;
   return c;
 }
 
+int BlueStore::OnodeCacheShard::_note_access(Onode* o)
+{
+  int cls = o->cache_scan.exchange(false) ?
+    ONODE_CLASS_SCAN : ONODE_CLASS_CLIENT;
+  if (o->cache_seg == ONODE_SEG_NEW) {
+    ++misses[cls];
+  } else {
+    ++hits[cls];
+  }
+  if (logger && cls == ONODE_CLASS_SCAN) {
+    logger->inc(l_bluestore_onode_scan_accesses);
+  }
+  return cls;
+}
+
+void BlueStore::OnodeCacheShard::_note_eviction(Onode* o)
+{
+  ceph_assert(o->cache_seg < ONODE_SEG_MAX);
+  ++evictions[o->cache_seg];
+  if (logger) {
+    logger->inc(l_bluestore_onode_evictions);
+  }
+}
+
+void BlueStore::OnodeCacheShard::dump_stats(Formatter *f)
+{
+  static const char* class_names[ONODE_CLASS_MAX] = { "client", "scan" };
+  static const char* seg_names[ONODE_SEG_MAX] = { "new", "probation", "hot" };
+  std::lock_guard l(lock);
+  f->dump_unsigned("onodes", num);
+  f->dump_unsigned("pinned", num_pinned);
+  _dump_lists(f);
+  for (int i = 0; i < ONODE_CLASS_MAX; ++i) {
+    f->open_object_section(class_names[i]);
+    f->dump_unsigned("hits", hits[i]);
+    f->dump_unsigned("misses", misses[i]);
+    f->close_section();
+  }
+  f->open_object_section("evictions");
+  for (int i = 0; i < ONODE_SEG_MAX; ++i) {
+    f->dump_unsigned(seg_names[i], evictions[i]);
+  }
+  f->close_section();
+  f->dump_unsigned("promotions", promotions);
+}
+
 // LruBufferCacheShard
 struct LruBufferCacheShard : public BlueStore::BufferCacheShard {
   typedef boost::intrusive::list<
@@ -3688,6 +3894,10 @@ BlueStore::Onode* BlueStore::Onode::decode(
   for (auto& i : on->onode.attrs) {
     i.second.reassign_to_mempool(mempool::mempool_bluestore_cache_meta);
   }
+  if (on->onode.has_inline_data()) {
+    on->onode.inline_data.reassign_to_mempool(
+      mempool::mempool_bluestore_cache_data);
+  }
 
   // initialize extent_map
   on->extent_map.decode_spanning_blobs(p);
@@ -4050,6 +4260,32 @@ BlueStore::OnodeRef BlueStore::Collection::get_onode(
   return onode_map.add(oid, o);
 }
 
+void BlueStore::Collection::note_omap_trimmed(
+  const string& prefix,
+  const string& start,
+  const string& end)
+{
+  // log trims advance through an object's keys, so consecutive ranges
+  // usually touch and collapse into one
+  string s = start, e = end;
+  auto p = omap_trimmed.lower_bound(make_pair(prefix, start));
+  if (p != omap_trimmed.begin()) {
+    auto q = std::prev(p);
+    if (q->first.first == prefix && q->second >= start) {
+      p = q;
+    }
+  }
+  while (p != omap_trimmed.end() &&
+	 p->first.first == prefix &&
+	 p->first.second <= e) {
+    s = std::min(s, p->first.second);
+    e = std::max(e, p->second);
+    p = omap_trimmed.erase(p);
+  }
+  omap_trimmed[make_pair(prefix, s)] = e;
+  ++omap_trimmed_ranges;
+}
+
 void BlueStore::Collection::split_cache(
   Collection *dest)
 {
@@ -4612,6 +4848,9 @@ const char **BlueStore::get_tracked_conf_keys() const
     "bluestore_warn_on_no_per_pool_omap",
     "bluestore_warn_on_no_per_pg_omap",
     "bluestore_max_defer_interval",
+    "bluestore_omap_trim_range_delete_keys",
+    "bluestore_omap_trim_compact_ranges",
+    "bluestore_inline_data_max_size",
     NULL
   };
   return KEYS;
@@ -4676,6 +4915,13 @@ void BlueStore::handle_conf_change(const ConfigProxy& conf,
       _set_max_defer_interval();
     }
   }
+  if (changed.count("bluestore_omap_trim_range_delete_keys") ||
+      changed.count("bluestore_omap_trim_compact_ranges")) {
+    _set_omap_trim_params();
+  }
+  if (changed.count("bluestore_inline_data_max_size")) {
+    _set_inline_data_max();
+  }
   if (changed.count("osd_memory_target") ||
       changed.count("osd_memory_base") ||
       changed.count("osd_memory_cache_min") ||
@@ -5055,6 +5301,15 @@ void BlueStore::_init_logger()
 		    "Sum for write penalty read ops");
   b.add_u64_counter(l_bluestore_write_new, "write_new",
 		    "Write into new blob");
+  b.add_u64_counter(l_bluestore_write_inline, "write_inline",
+		    "Writes kept inline in the onode");
+  b.add_u64_counter(l_bluestore_write_inline_bytes, "write_inline_bytes",
+		    "Sum for writes kept inline in the onode",
+		    NULL,
+		    PerfCountersBuilder::PRIO_DEBUGONLY,
+		    unit_t(UNIT_BYTES));
+  b.add_u64_counter(l_bluestore_inline_migrated, "inline_migrated",
+		    "Objects whose inline data moved to a blob");
 
   b.add_u64_counter(l_bluestore_issued_deferred_writes,
 		    "issued_deferred_writes",
@@ -5124,6 +5379,12 @@ void BlueStore::_init_logger()
   b.add_u64_counter(l_bluestore_onode_misses, "onode_misses",
 		    "Count of onode cache lookup misses",
 		    "o_ms", PerfCountersBuilder::PRIO_USEFUL);
+  b.add_u64_counter(l_bluestore_onode_evictions, "onode_evictions",
+		    "Count of onodes trimmed from the onode cache");
+  b.add_u64_counter(l_bluestore_onode_promotions, "onode_promotions",
+		    "Count of onodes promoted from probation to hot");
+  b.add_u64_counter(l_bluestore_onode_scan_accesses, "onode_scan_accesses",
+		    "Count of onode accesses hinted as background scans");
   b.add_u64_counter(l_bluestore_onode_shard_hits, "onode_shard_hits",
 		    "Count of onode shard cache lookups hits");
   b.add_u64_counter(l_bluestore_onode_shard_misses,
@@ -5195,6 +5456,12 @@ void BlueStore::_init_logger()
   b.add_time_avg(l_bluestore_remove_lat, "remove_lat",
     "Average removal latency",
     "rm_l", PerfCountersBuilder::PRIO_USEFUL);
+  b.add_u64_counter(l_bluestore_omap_trim_range_deletes,
+    "omap_trim_range_deletes",
+    "Omap range removals written as a range tombstone");
+  b.add_u64_counter(l_bluestore_omap_trim_compactions,
+    "omap_trim_compactions",
+    "Trimmed omap ranges queued for compaction");
   //****************************************
 
   // Resulting size axis configuration for op histograms, values are in bytes
@@ -5445,6 +5712,8 @@ int BlueStore::_open_bdev(bool create)
   block_size_order = ctz(block_size);
   ceph_assert(block_size == 1u << block_size_order);
   _set_max_defer_interval();
+  _set_omap_trim_params();
+  _set_inline_data_max();
   // and set cache_size based on device type
   r = _set_cache_sizes();
   if (r < 0) {
@@ -7475,8 +7744,9 @@ void BlueStore::set_cache_shards(unsigned num)
   buffer_cache_shards.resize(num);
   for (unsigned i = oold; i < num; ++i) {
     onode_cache_shards[i] = 
-        OnodeCacheShard::create(cct, cct->_conf->bluestore_cache_type,
-                                 logger);
+        OnodeCacheShard::create(
+	  cct, cct->_conf.get_val<std::string>("bluestore_onode_cache_type"),
+	  logger);
   }
   for (unsigned i = bold; i < num; ++i) {
     buffer_cache_shards[i] = 
@@ -7861,6 +8131,16 @@ BlueStore::OnodeRef BlueStore::fsck_check_objects_shallow(
 
   o->extent_map.fault_range(db, 0, OBJECT_MAX_SIZE);
   _dump_onode<30>(cct, *o);
+  if (o->onode.has_inline_data()) {
+    if (o->onode.inline_data.length() != o->onode.size ||
+	!o->extent_map.extent_map.empty()) {
+      derr << "fsck error: " << oid << " inline data 0x" << std::hex
+	   << o->onode.inline_data.length() << " does not match size 0x"
+	   << o->onode.size << std::dec << " or has lextents" << dendl;
+      ++errors;
+    }
+    res_statfs->data_stored += o->onode.inline_data.length();
+  }
   // shards
   if (!o->extent_map.shards.empty()) {
     ++num_sharded_objects;
@@ -10424,6 +10704,7 @@ int BlueStore::read(
       goto out;
     }
 
+    o->hint_cache_scan(op_flags);
     if (offset == length && offset == 0)
       length = o->onode.size;
 
@@ -10752,6 +11033,11 @@ int BlueStore::_do_read(
     length = o->onode.size - offset;
   }
 
+  if (o->onode.has_inline_data()) {
+    bl.append(o->onode.inline_data, offset, length);
+    return bl.length();
+  }
+
   auto start = mono_clock::now();
   o->extent_map.fault_range(db, offset, length);
   log_latency(__func__,
@@ -10949,6 +11235,11 @@ int BlueStore::_fiemap(
       length = o->onode.size - offset;
     }
 
+    if (o->onode.has_inline_data()) {
+      destset.insert(offset, length);
+      goto out;
+    }
+
     o->extent_map.fault_range(db, offset, length);
     eend = o->extent_map.extent_map.end();
     ep = o->extent_map.seek_lextent(offset);
@@ -11049,6 +11340,7 @@ int BlueStore::readv(
       goto out;
     }
 
+    o->hint_cache_scan(op_flags);
     if (m.empty()) {
       r = 0;
       goto out;
@@ -11116,6 +11408,12 @@ int BlueStore::_do_readv(
   // call fiemap first!
   ceph_assert(m.range_start() <= o->onode.size);
   ceph_assert(m.range_end() <= o->onode.size);
+  if (o->onode.has_inline_data()) {
+    for (auto p = m.begin(); p != m.end(); ++p) {
+      bl.append(o->onode.inline_data, p.get_start(), p.get_len());
+    }
+    return bl.length();
+  }
   auto start = mono_clock::now();
   o->extent_map.fault_range(db, m.range_start(), m.range_end() - m.range_start());
   log_latency(__func__,
@@ -11563,10 +11861,11 @@ int BlueStore::_onode_omap_get(
   o->flush();
   {
     const string& prefix = o->get_omap_prefix();
-    KeyValueDB::Iterator it = db->get_iterator(prefix);
     string head, tail;
     o->get_omap_header(&head);
     o->get_omap_tail(&tail);
+    KeyValueDB::Iterator it = db->get_iterator(prefix, 0,
+      KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
       if (it->key() == head) {
@@ -11648,10 +11947,11 @@ int BlueStore::omap_get_keys(
   o->flush();
   {
     const string& prefix = o->get_omap_prefix();
-    KeyValueDB::Iterator it = db->get_iterator(prefix);
     string head, tail;
     o->get_omap_key(string(), &head);
     o->get_omap_tail(&tail);
+    KeyValueDB::Iterator it = db->get_iterator(prefix, 0,
+      KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
       if (it->key() >= tail) {
@@ -11836,7 +12136,18 @@ ObjectMap::ObjectMapIterator BlueStore::get_omap_iterator(
   }
   o->flush();
   dout(10) << __func__ << " has_omap = " << (int)o->onode.has_omap() <<dendl;
-  KeyValueDB::Iterator it = db->get_iterator(o->get_omap_prefix());
+  // keep the scan within this object's keys; this lets rocksdb skip
+  // tables and the shards of a sharded omap column that can't hold them
+  KeyValueDB::IteratorBounds bounds;
+  if (o->onode.has_omap()) {
+    std::string lower_bound, upper_bound;
+    o->get_omap_key(string(), &lower_bound);
+    o->get_omap_tail(&upper_bound);
+    bounds.lower_bound = std::move(lower_bound);
+    bounds.upper_bound = std::move(upper_bound);
+  }
+  KeyValueDB::Iterator it = db->get_iterator(o->get_omap_prefix(), 0,
+					     std::move(bounds));
   return ObjectMap::ObjectMapIterator(new OmapIteratorImpl(c, o, it));
 }
 
@@ -11851,8 +12162,11 @@ uint64_t BlueStore::_get_ondisk_reserved() const {
 
 void BlueStore::_prepare_ondisk_format_super(KeyValueDB::Transaction& t)
 {
+  // never lower a compat raised by inline data
+  int32_t compat = std::max(min_compat_ondisk_format,
+			    compat_ondisk_format.load());
   dout(10) << __func__ << " ondisk_format " << ondisk_format
-	   << " min_compat_ondisk_format " << min_compat_ondisk_format
+	   << " min_compat_ondisk_format " << compat
 	   << dendl;
   ceph_assert(ondisk_format == latest_ondisk_format);
   {
@@ -11862,11 +12176,35 @@ void BlueStore::_prepare_ondisk_format_super(KeyValueDB::Transaction& t)
   }
   {
     bufferlist bl;
-    encode(min_compat_ondisk_format, bl);
+    encode(compat, bl);
     t->set(PREFIX_SUPER, "min_compat_ondisk_format", bl);
   }
 }
 
+void BlueStore::_require_inline_data_compat()
+{
+  if (compat_ondisk_format >= inline_data_compat_ondisk_format) {
+    return;
+  }
+  std::lock_guard l(compat_lock);
+  if (compat_ondisk_format >= inline_data_compat_ondisk_format) {
+    return;
+  }
+  // releases that predate inline data would skip it when decoding the
+  // onode and read the object back as zeros; keep them from mounting
+  // before the first such onode can reach the db
+  dout(1) << __func__ << " raising min_compat_ondisk_format from "
+	  << compat_ondisk_format.load() << " to "
+	  << inline_data_compat_ondisk_format << dendl;
+  KeyValueDB::Transaction t = db->get_transaction();
+  bufferlist bl;
+  encode(inline_data_compat_ondisk_format, bl);
+  t->set(PREFIX_SUPER, "min_compat_ondisk_format", bl);
+  int r = db->submit_transaction_sync(t);
+  ceph_assert(r == 0);
+  compat_ondisk_format = inline_data_compat_ondisk_format;
+}
+
 int BlueStore::_open_super_meta()
 {
   // nid
@@ -11917,7 +12255,7 @@ int BlueStore::_open_super_meta()
     dout(5) << __func__ << "::NCB::freelist_type=" << freelist_type << dendl;
   }
   // ondisk format
-  int32_t compat_ondisk_format = 0;
+  compat_ondisk_format = 0;
   {
     bufferlist bl;
     int r = db->get(PREFIX_SUPER, "ondisk_format", &bl);
@@ -11941,7 +12279,9 @@ int BlueStore::_open_super_meta()
 	ceph_assert(!r);
 	auto p = bl.cbegin();
 	try {
-	  decode(compat_ondisk_format, p);
+	  int32_t v;
+	  decode(v, p);
+	  compat_ondisk_format = v;
 	} catch (ceph::buffer::error& e) {
 	  derr << __func__ << " unable to read compat_ondisk_format" << dendl;
 	  return -EIO;
@@ -11949,13 +12289,13 @@ int BlueStore::_open_super_meta()
       }
     }
     dout(1) << __func__ << " ondisk_format " << ondisk_format
-	     << " compat_ondisk_format " << compat_ondisk_format
+	     << " compat_ondisk_format " << compat_ondisk_format.load()
 	     << dendl;
   }
 
   if (latest_ondisk_format < compat_ondisk_format) {
     derr << __func__ << " compat_ondisk_format is "
-	 << compat_ondisk_format << " but we only understand version "
+	 << compat_ondisk_format.load() << " but we only understand version "
 	 << latest_ondisk_format << dendl;
     return -EPERM;
   }
@@ -12069,6 +12409,12 @@ int BlueStore::_upgrade_super()
       ceph_assert(r == 0);
       ondisk_format = 4;
     }
+    if (ondisk_format == 4) {
+      // changes:
+      // - onode may carry its data inline (FLAG_INLINE_DATA).  The first
+      //   write of such an onode raises min_compat_ondisk_format to 5.
+      ondisk_format = 5;
+    }
     // This to be the last operation
     _prepare_ondisk_format_super(t);
     int r = db->submit_transaction_sync(t);
@@ -12543,6 +12889,14 @@ void BlueStore::_txc_finish(TransContext *txc)
     txc->removed_collections.pop_front();
   }
 
+  for (auto& [prefix, start, end] : txc->omap_compact) {
+    dout(20) << __func__ << " compact omap range " << prefix << " "
+	     << pretty_binary_string(start) << " - "
+	     << pretty_binary_string(end) << dendl;
+    db->compact_range_async(prefix, start, end);
+  }
+  txc->omap_compact.clear();
+
   OpSequencerRef osr = txc->osr;
   bool empty = false;
   bool submit_deferred = false;
@@ -15663,6 +16017,14 @@ int BlueStore::_do_write(
 
   uint64_t end = offset + length;
 
+  if (_can_inline(o, end)) {
+    _do_write_inline(txc, o, offset, bl);
+    return 0;
+  }
+  if (o->onode.has_inline_data()) {
+    _do_uninline(txc, c, o);
+  }
+
   GarbageCollector gc(c->store->cct);
   int64_t benefit = 0;
   auto dirty_start = offset;
@@ -15727,6 +16089,74 @@ int BlueStore::_do_write(
   return r;
 }
 
+bool BlueStore::_can_inline(OnodeRef& o, uint64_t end) const
+{
+  if (end > inline_data_max) {
+    return false;
+  }
+  if (o->onode.has_inline_data()) {
+    return true;
+  }
+  // only objects without any data start out inline
+  return o->onode.size == 0 &&
+    o->onode.extent_map_shards.empty() &&
+    o->extent_map.extent_map.empty();
+}
+
+void BlueStore::_do_write_inline(
+  TransContext *txc,
+  OnodeRef& o,
+  uint64_t offset,
+  const bufferlist& bl)
+{
+  uint64_t old_size = o->onode.size;
+  uint64_t end = offset + bl.length();
+  uint64_t size = std::max(old_size, end);
+  dout(20) << __func__ << " " << o->oid
+	   << " 0x" << std::hex << offset << "~" << bl.length()
+	   << " size 0x" << old_size << " -> 0x" << size << std::dec << dendl;
+
+  if (!o->onode.has_inline_data()) {
+    _require_inline_data_compat();
+  }
+
+  // never modify the current buffer in place, readers may still hold it
+  bufferptr p = ceph::buffer::create(size);
+  if (o->onode.has_inline_data()) {
+    o->onode.inline_data.copy_out(0, old_size, p.c_str());
+  }
+  if (offset > old_size) {
+    p.zero(old_size, offset - old_size);
+  }
+  bl.begin().copy(bl.length(), p.c_str() + offset);
+  p.reassign_to_mempool(mempool::mempool_bluestore_cache_data);
+
+  o->onode.inline_data = std::move(p);
+  o->onode.set_flag(bluestore_onode_t::FLAG_INLINE_DATA);
+  o->onode.size = size;
+  txc->statfs_delta.stored() += size - old_size;
+  logger->inc(l_bluestore_write_inline);
+  logger->inc(l_bluestore_write_inline_bytes, bl.length());
+}
+
+void BlueStore::_do_uninline(
+  TransContext *txc,
+  CollectionRef& c,
+  OnodeRef& o)
+{
+  bufferlist bl;
+  bl.append(o->onode.inline_data);
+  dout(20) << __func__ << " " << o->oid
+	   << " 0x" << std::hex << bl.length() << std::dec << dendl;
+  o->onode.inline_data = bufferptr();
+  o->onode.clear_flag(bluestore_onode_t::FLAG_INLINE_DATA);
+  txc->statfs_delta.stored() -= bl.length();
+  logger->inc(l_bluestore_inline_migrated);
+  // the size stays, so this is a plain write into a hole and does not
+  // consider going inline again
+  _do_write(txc, c, o, 0, bl.length(), bl, 0);
+}
+
 int BlueStore::_write(TransContext *txc,
 		      CollectionRef& c,
 		      OnodeRef& o,
@@ -15784,6 +16214,17 @@ int BlueStore::_do_zero(TransContext *txc,
 
   _dump_onode<30>(cct, *o);
 
+  if (length > 0 && o->onode.has_inline_data()) {
+    if (offset + length <= inline_data_max) {
+      bufferlist zeros;
+      zeros.append_zero(length);
+      _do_write_inline(txc, o, offset, zeros);
+      txc->write_onode(o);
+      return r;
+    }
+    _do_uninline(txc, c, o);
+  }
+
   WriteContext wctx;
   o->extent_map.fault_range(db, offset, length);
   o->extent_map.punch_hole(c, offset, length, &wctx.old_extents);
@@ -15815,6 +16256,29 @@ void BlueStore::_do_truncate(
   if (offset == o->onode.size)
     return;
 
+  if (o->onode.has_inline_data()) {
+    if (offset < o->onode.size) {
+      txc->statfs_delta.stored() -= o->onode.size - offset;
+      if (offset) {
+	o->onode.inline_data.set_length(offset);
+      } else {
+	o->onode.inline_data = bufferptr();
+	o->onode.clear_flag(bluestore_onode_t::FLAG_INLINE_DATA);
+      }
+      o->onode.size = offset;
+      txc->write_onode(o);
+      return;
+    }
+    if (offset <= inline_data_max) {
+      bufferlist zeros;
+      zeros.append_zero(offset - o->onode.size);
+      _do_write_inline(txc, o, o->onode.size, zeros);
+      txc->write_onode(o);
+      return;
+    }
+    _do_uninline(txc, c, o);
+  }
+
   WriteContext wctx;
   if (offset < o->onode.size) {
     uint64_t length = o->onode.size - offset;
@@ -16082,13 +16546,50 @@ int BlueStore::_rmattrs(TransContext *txc,
   return r;
 }
 
+void BlueStore::_do_omap_rm_range(TransContext *txc,
+				  OnodeRef& o,
+				  const string& prefix,
+				  const string& start,
+				  const string& end)
+{
+  if (!omap_trim_range_delete_keys) {
+    txc->t->rm_range_keys(prefix, start, end);
+    return;
+  }
+  if (!txc->t->rm_range_keys_trim(prefix, start, end,
+				  omap_trim_range_delete_keys)) {
+    return;
+  }
+  logger->inc(l_bluestore_omap_trim_range_deletes);
+  if (!omap_trim_compact_ranges) {
+    return;
+  }
+  // the range tombstones stay in the way of iterators until compaction
+  // drops them; once a collection has piled up enough of them, compact
+  // the ranges they cover after this txc commits.
+  Collection *c = o->c;
+  c->note_omap_trimmed(prefix, start, end);
+  if (c->omap_trimmed_ranges < omap_trim_compact_ranges) {
+    return;
+  }
+  dout(10) << __func__ << " " << c->cid << " compacting "
+	   << c->omap_trimmed.size() << " ranges after "
+	   << c->omap_trimmed_ranges << " range deletes" << dendl;
+  logger->inc(l_bluestore_omap_trim_compactions, c->omap_trimmed.size());
+  for (auto& [k, e] : c->omap_trimmed) {
+    txc->omap_compact.emplace_back(k.first, k.second, e);
+  }
+  c->omap_trimmed.clear();
+  c->omap_trimmed_ranges = 0;
+}
+
 void BlueStore::_do_omap_clear(TransContext *txc, OnodeRef& o)
 {
   const string& omap_prefix = o->get_omap_prefix();
   string prefix, tail;
   o->get_omap_header(&prefix);
   o->get_omap_tail(&tail);
-  txc->t->rm_range_keys(omap_prefix, prefix, tail);
+  _do_omap_rm_range(txc, o, omap_prefix, prefix, tail);
   txc->t->rmkey(omap_prefix, tail);
   dout(20) << __func__ << " remove range start: "
            << pretty_binary_string(prefix) << " end: "
@@ -16241,7 +16742,7 @@ int BlueStore::_omap_rmkey_range(TransContext *txc,
     o->flush();
     o->get_omap_key(first, &key_first);
     o->get_omap_key(last, &key_last);
-    txc->t->rm_range_keys(prefix, key_first, key_last);
+    _do_omap_rm_range(txc, o, prefix, key_first, key_last);
     dout(20) << __func__ << " remove range start: "
              << pretty_binary_string(key_first) << " end: "
              << pretty_binary_string(key_last) << dendl;
@@ -16298,7 +16799,7 @@ int BlueStore::_clone(TransContext *txc,
   // clone data
   oldo->flush();
   _do_truncate(txc, c, newo, 0);
-  if (cct->_conf->bluestore_clone_cow) {
+  if (cct->_conf->bluestore_clone_cow && !oldo->onode.has_inline_data()) {
     _do_clone_range(txc, c, oldo, newo, 0, oldo->onode.size, 0);
   } else {
     bufferlist bl;
@@ -16331,10 +16832,11 @@ int BlueStore::_clone(TransContext *txc,
     // otherwise rewrite_omap_key will corrupt data
     ceph_assert(oldo->onode.flags == newo->onode.flags);
     const string& prefix = newo->get_omap_prefix();
-    KeyValueDB::Iterator it = db->get_iterator(prefix);
     string head, tail;
     oldo->get_omap_header(&head);
     oldo->get_omap_tail(&tail);
+    KeyValueDB::Iterator it = db->get_iterator(prefix, 0,
+      KeyValueDB::IteratorBounds{head, tail});
     it->lower_bound(head);
     while (it->valid()) {
       if (it->key() >= tail) {
@@ -16444,7 +16946,9 @@ int BlueStore::_clone_range(TransContext *txc,
   _assign_nid(txc, newo);
 
   if (length > 0) {
-    if (cct->_conf->bluestore_clone_cow) {
+    if (cct->_conf->bluestore_clone_cow &&
+	!oldo->onode.has_inline_data() &&
+	!newo->onode.has_inline_data()) {
       _do_zero(txc, c, newo, dstoff, length);
       _do_clone_range(txc, c, oldo, newo, srcoff, length, dstoff);
     } else {
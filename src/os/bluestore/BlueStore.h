@@ -136,6 +136,9 @@ enum {
   l_bluestore_write_pad_bytes,
   l_bluestore_write_penalty_read_ops,
   l_bluestore_write_new,
+  l_bluestore_write_inline,
+  l_bluestore_write_inline_bytes,
+  l_bluestore_inline_migrated,
 
   l_bluestore_issued_deferred_writes,
   l_bluestore_issued_deferred_write_bytes,
@@ -165,6 +168,9 @@ enum {
   l_bluestore_pinned_onodes,
   l_bluestore_onode_hits,
   l_bluestore_onode_misses,
+  l_bluestore_onode_evictions,
+  l_bluestore_onode_promotions,
+  l_bluestore_onode_scan_accesses,
   l_bluestore_onode_shard_hits,
   l_bluestore_onode_shard_misses,
   l_bluestore_extents,
@@ -197,6 +203,8 @@ enum {
   l_bluestore_omap_get_values_lat,
   l_bluestore_clist_lat,
   l_bluestore_remove_lat,
+  l_bluestore_omap_trim_range_deletes,
+  l_bluestore_omap_trim_compactions,
   //****************************************
 
   // allocation stats
@@ -229,6 +237,16 @@ public:
     max_defer_interval =
 	cct->_conf.get_val<double>("bluestore_max_defer_interval");
   }
+  void _set_inline_data_max() {
+    inline_data_max =
+      cct->_conf.get_val<Option::size_t>("bluestore_inline_data_max_size");
+  }
+  void _set_omap_trim_params() {
+    omap_trim_range_delete_keys =
+      cct->_conf.get_val<uint64_t>("bluestore_omap_trim_range_delete_keys");
+    omap_trim_compact_ranges =
+      cct->_conf.get_val<uint64_t>("bluestore_omap_trim_compact_ranges");
+  }
 
   struct TransContext;
 
@@ -1141,6 +1159,10 @@ public:
                               /// of it at the moment though)
     std::atomic_bool pinned;  ///< Onode is pinned
                               /// (or should be pinned when cached)
+    uint8_t cache_seg = 0;    ///< OnodeCacheShard segment we belong to
+                              /// (protected by the cache shard lock)
+    std::atomic_bool cache_scan = {false}; ///< current access is a
+                                           /// background/sequential scan
     ExtentMap extent_map;
 
     // track txc's that have not been committed to kv store (and whose
@@ -1207,6 +1229,13 @@ public:
       cached = false;
       return !pinned;
     }
+    /// let the onode cache know this access should not promote us
+    inline void hint_cache_scan(uint32_t op_flags) {
+      if (op_flags & (CEPH_OSD_OP_FLAG_FADVISE_DONTNEED |
+		      CEPH_OSD_OP_FLAG_FADVISE_NOCACHE)) {
+	cache_scan = true;
+      }
+    }
 
     static const std::string& calc_omap_prefix(uint8_t flags);
     static void calc_omap_header(uint8_t flags, const Onode* o,
@@ -1303,8 +1332,31 @@ public:
 
     std::array<std::pair<ghobject_t, ceph::mono_clock::time_point>, 64> dumped_onodes;
 
+    enum {
+      ONODE_SEG_NEW = 0,    ///< not released since it was added
+      ONODE_SEG_PROBATION,  ///< seen once, or only by scans
+      ONODE_SEG_HOT,        ///< re-referenced by client requests
+      ONODE_SEG_MAX
+    };
+    enum {
+      ONODE_CLASS_CLIENT = 0,
+      ONODE_CLASS_SCAN,     ///< DONTNEED/NOCACHE (scrub, listing, ...)
+      ONODE_CLASS_MAX
+    };
+
+    /// per shard access stats, protected by lock.  Accesses are accounted
+    /// when the onode is released back to the cache.
+    std::array<uint64_t, ONODE_CLASS_MAX> hits = {};
+    std::array<uint64_t, ONODE_CLASS_MAX> misses = {};
+    std::array<uint64_t, ONODE_SEG_MAX> evictions = {};
+    uint64_t promotions = 0;
+
     virtual void _pin(Onode* o) = 0;
     virtual void _unpin(Onode* o) = 0;
+    virtual void _dump_lists(ceph::Formatter *f) = 0;
+
+    int _note_access(Onode* o);
+    void _note_eviction(Onode* o);
 
   public:
     OnodeCacheShard(CephContext* cct) : CacheShard(cct) {}
@@ -1316,6 +1368,7 @@ public:
 
     virtual void move_pinned(OnodeCacheShard *to, Onode *o) = 0;
     virtual void add_stats(uint64_t *onodes, uint64_t *pinned_onodes) = 0;
+    void dump_stats(ceph::Formatter *f);
     bool empty() {
       return _get_num() == 0;
     }
@@ -1376,6 +1429,7 @@ public:
     friend struct Collection; // for split_cache()
     friend struct Onode; // for put()
     friend struct LruOnodeCacheShard;
+    friend struct TwoQOnodeCacheShard;
     void _remove(const ghobject_t& oid);
   public:
     OnodeSpace(OnodeCacheShard *c) : cache(c) {}
@@ -1421,6 +1475,15 @@ public:
     pool_opts_t pool_opts;
     ContextQueue *commit_queue;
 
+    /// omap ranges removed with range tombstones and not yet queued for
+    /// compaction, (prefix, start) -> end; protected by lock
+    std::map<std::pair<std::string, std::string>, std::string> omap_trimmed;
+    uint64_t omap_trimmed_ranges = 0; ///< range tombstones behind omap_trimmed
+
+    void note_omap_trimmed(const std::string& prefix,
+			   const std::string& start,
+			   const std::string& end);
+
     OnodeCacheShard* get_onode_cache() const {
       return onode_map.cache;
     }
@@ -1677,6 +1740,8 @@ public:
     KeyValueDB::Transaction t; ///< then we will commit this
     std::list<Context*> oncommits;  ///< more commit completions
     std::list<CollectionRef> removed_collections; ///< colls we removed
+    /// trimmed omap ranges to compact once we commit: prefix, start, end
+    std::vector<std::tuple<std::string, std::string, std::string>> omap_compact;
 
     boost::intrusive::list_member_hook<> deferred_queue_item;
     bluestore_deferred_transaction_t *deferred_txn = nullptr; ///< if any
@@ -2244,6 +2309,9 @@ private:
   uint64_t osd_memory_cache_min = 0; ///< Min memory to assign when autotuning cache
   double osd_memory_cache_resize_interval = 0; ///< Time to wait between cache resizing 
   double max_defer_interval = 0; ///< Time to wait between last deferred submit
+  uint64_t inline_data_max = 0; ///< largest object to keep inline in its onode
+  uint64_t omap_trim_range_delete_keys = 0; ///< keys that make an omap trim a range delete
+  uint64_t omap_trim_compact_ranges = 0; ///< range deletes per collection before compacting
   std::atomic<uint32_t> config_changed = {0}; ///< Counter to determine if there is a configuration change.
 
   typedef std::map<uint64_t, volatile_statfs> osd_pools_map;
@@ -2628,16 +2696,21 @@ private:
 
   // -- ondisk version ---
 public:
-  const int32_t latest_ondisk_format = 4;        ///< our version
+  const int32_t latest_ondisk_format = 5;        ///< our version
   const int32_t min_readable_ondisk_format = 1;  ///< what we can read
   const int32_t min_compat_ondisk_format = 3;    ///< who can read us
+  /// who can read us once an onode carries inline data
+  const int32_t inline_data_compat_ondisk_format = 5;
 
 private:
   int32_t ondisk_format = 0;  ///< value detected on mount
+  std::atomic<int32_t> compat_ondisk_format = 0;  ///< detected on mount
+  ceph::mutex compat_lock = ceph::make_mutex("BlueStore::compat_lock");
 
   int _upgrade_super();  ///< upgrade (called during open_super)
   uint64_t _get_ondisk_reserved() const;
   void _prepare_ondisk_format_super(KeyValueDB::Transaction& t);
+  void _require_inline_data_compat();
 
   // --- public interface ---
 public:
@@ -2723,6 +2796,13 @@ public:
     }
     f->dump_int("bluestore_onode", onode_count);
     f->dump_int("bluestore_buffers", buffers_bytes);
+    f->open_array_section("bluestore_onode_shards");
+    for (auto i: onode_cache_shards) {
+      f->open_object_section("shard");
+      i->dump_stats(f);
+      f->close_section();
+    }
+    f->close_section();
   }
   void dump_cache_stats(std::ostream& ss) override {
     int onode_count = 0, buffers_bytes = 0;
@@ -3322,6 +3402,14 @@ private:
 		uint64_t offset, uint64_t length,
 		ceph::buffer::list& bl,
 		uint32_t fadvise_flags);
+  bool _can_inline(OnodeRef& o, uint64_t end) const;
+  void _do_write_inline(TransContext *txc,
+			OnodeRef& o,
+			uint64_t offset,
+			const ceph::buffer::list& bl);
+  void _do_uninline(TransContext *txc,
+		    CollectionRef& c,
+		    OnodeRef& o);
   void _do_write_data(TransContext *txc,
                       CollectionRef& c,
                       OnodeRef o,
@@ -3372,6 +3460,11 @@ private:
   int _rmattrs(TransContext *txc,
 	       CollectionRef& c,
 	       OnodeRef& o);
+  void _do_omap_rm_range(TransContext *txc,
+			 OnodeRef& o,
+			 const std::string& prefix,
+			 const std::string& start,
+			 const std::string& end);
   void _do_omap_clear(TransContext *txc, OnodeRef &o);
   int _omap_clear(TransContext *txc,
 		  CollectionRef& c,
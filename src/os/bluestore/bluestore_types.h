@@ -962,11 +962,16 @@ struct bluestore_onode_t {
 
   std::map<uint32_t, uint64_t> zone_offset_refs;  ///< (zone, offset) refs to this onode
 
+  /// object data kept in the onode itself (FLAG_INLINE_DATA); covers all
+  /// of [0, size), there are no lextents then
+  ceph::buffer::ptr inline_data;
+
   enum {
     FLAG_OMAP = 1,         ///< object may have omap data
     FLAG_PGMETA_OMAP = 2,  ///< omap data is in meta omap prefix
     FLAG_PERPOOL_OMAP = 4, ///< omap data is in per-pool prefix; per-pool keys
     FLAG_PERPG_OMAP = 8,   ///< omap data is in per-pg prefix; per-pg keys
+    FLAG_INLINE_DATA = 16, ///< object data is in inline_data
   };
 
   std::string get_flags_string() const {
@@ -983,6 +988,9 @@ struct bluestore_onode_t {
     if (flags & FLAG_PERPG_OMAP) {
       s += "+per_pg_omap";
     }
+    if (flags & FLAG_INLINE_DATA) {
+      s += "+inline_data";
+    }
     return s;
   }
 
@@ -1032,8 +1040,12 @@ struct bluestore_onode_t {
     clear_flag(FLAG_OMAP);
   }
 
+  bool has_inline_data() const {
+    return has_flag(FLAG_INLINE_DATA);
+  }
+
   DENC(bluestore_onode_t, v, p) {
-    DENC_START(2, 1, p);
+    DENC_START(3, 1, p);
     denc_varint(v.nid, p);
     denc_varint(v.size, p);
     denc(v.attrs, p);
@@ -1045,6 +1057,10 @@ struct bluestore_onode_t {
     if (struct_v >= 2) {
       denc(v.zone_offset_refs, p);
     }
+    // flags are known by now, only pay for inline data when there is some
+    if (struct_v >= 3 && v.has_inline_data()) {
+      denc(v.inline_data, p);
+    }
     DENC_FINISH(p);
   }
   void dump(ceph::Formatter *f) const;
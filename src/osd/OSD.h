@@ -1673,6 +1673,11 @@ protected:
   void dequeue_op(
     PGRef pg, OpRequestRef op,
     ThreadPool::TPHandle &handle);
+  bool can_batch_op(const OpRequestRef& op) const;
+  void dequeue_op_batch(
+    OSDShard *sdata,
+    PGRef pg, OpRequestRef op,
+    ThreadPool::TPHandle &handle);
 
   void enqueue_peering_evt(
     spg_t pgid,
@@ -0,0 +1,80 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+#ifndef CEPH_OSD_OPBATCH_H
+#define CEPH_OSD_OPBATCH_H
+
+#include <vector>
+
+#include "common/ceph_time.h"
+#include "common/perf_counters.h"
+#include "os/ObjectStore.h"
+#include "osd/OpRequest.h"
+#include "osd/osd_perf_counters.h"
+
+/**
+ * Store transactions of the ops a pg executed back to back under one lock
+ * hold (osd_op_batch_*), submitted to the object store as a single group
+ * commit.  Transactions are submitted in the order they were added, so a
+ * batch leaves the store in the same state as submitting each op's
+ * transactions on its own.
+ */
+struct OpBatch {
+  struct Entry {
+    OpRequestRef op;
+    ceph::mono_time queued;
+  };
+  std::vector<ObjectStore::Transaction> tls;
+  std::vector<Entry> ops;  ///< ops whose transactions are in tls, in order
+
+  bool empty() const {
+    return tls.empty();
+  }
+
+  void add(std::vector<ObjectStore::Transaction>& more,
+	   const OpRequestRef& op) {
+    ops.push_back(Entry{op, ceph::mono_clock::now()});
+    for (auto& t : more) {
+      tls.push_back(std::move(t));
+    }
+  }
+
+  /// queue everything collected so far, mark every op and record how long
+  /// each one was held back
+  int submit(ObjectStore *store, ObjectStore::CollectionHandle& ch,
+	     PerfCounters *logger) {
+    if (tls.empty()) {
+      return 0;
+    }
+    const auto now = ceph::mono_clock::now();
+    if (logger) {
+      logger->inc(l_osd_op_batch);
+      logger->inc(l_osd_op_batch_size, ops.size());
+    }
+    for (auto& e : ops) {
+      if (logger) {
+	logger->tinc(l_osd_op_batch_lat, now - e.queued);
+      }
+      if (e.op) {
+	e.op->mark_event("op_batch_submit");
+      }
+    }
+    // the store takes one op for its own events and trace; the others
+    // are tracked through the event above and their commit callbacks
+    int r = store->queue_transactions(
+      ch, tls, ops.empty() ? OpRequestRef() : ops.front().op, nullptr);
+    tls.clear();
+    ops.clear();
+    return r;
+  }
+};
+
+#endif
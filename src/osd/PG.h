@@ -683,6 +683,11 @@ public:
     OpRequestRef& op,
     ThreadPool::TPHandle &handle
   ) = 0;
+  /// collect the store transactions of the following ops into one group
+  /// commit (see OSD::dequeue_op_batch); false if this pg can't batch
+  virtual bool begin_op_batch() = 0;
+  /// submit whatever the batch collected and stop batching
+  virtual void end_op_batch() = 0;
   virtual void clear_cache() = 0;
   virtual int get_cache_obj_count() = 0;
 
@@ -1789,6 +1789,32 @@ void PrimaryLogPG::handle_backoff(OpRequestRef& op)
   session->ack_backoff(cct, m->pgid, m->id, begin, end);
 }
 
+bool PrimaryLogPG::begin_op_batch()
+{
+  ceph_assert(!op_batch);
+  // ec overwrites read back stripes through the local store
+  if (!pool.info.is_replicated())
+    return false;
+  op_batch.emplace();
+  return true;
+}
+
+void PrimaryLogPG::flush_op_batch()
+{
+  if (!op_batch || op_batch->empty())
+    return;
+  dout(20) << __func__ << " " << op_batch->ops.size() << " ops, "
+	   << op_batch->tls.size() << " transactions" << dendl;
+  int r = op_batch->submit(osd->store, ch, osd->logger);
+  ceph_assert(r == 0);
+}
+
+void PrimaryLogPG::end_op_batch()
+{
+  flush_op_batch();
+  op_batch.reset();
+}
+
 void PrimaryLogPG::do_request(
   OpRequestRef& op,
   ThreadPool::TPHandle &handle)
@@ -2028,6 +2054,15 @@ void PrimaryLogPG::do_op(OpRequestRef& op)
     }
   }
 
+  if (op_batch && !op_batch->empty() &&
+      (op->may_read() || op->may_cache() || op->includes_pg_op())) {
+    // the store only shows batched writes once they are queued, so an op
+    // that may read them has to submit the batch first
+    dout(20) << __func__ << " submitting op batch before " << *m << dendl;
+    osd->logger->inc(l_osd_op_batch_read_flush);
+    flush_op_batch();
+  }
+
   if ((m->get_flags() & (CEPH_OSD_FLAG_BALANCE_READS |
 			 CEPH_OSD_FLAG_LOCALIZE_READS)) &&
       op->may_read() &&
@@ -11585,6 +11620,7 @@ void PrimaryLogPG::submit_log_entries(
       };
       t.register_on_commit(
 	new OnComplete{this, rep_tid, get_osdmap_epoch()});
+      flush_op_batch();
       int r = osd->store->queue_transaction(ch, std::move(t), NULL);
       ceph_assert(r == 0);
       op_applied(info.last_update);
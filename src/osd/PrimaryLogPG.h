@@ -30,6 +30,7 @@
 #include "common/shared_cache.hpp"
 #include "ReplicatedBackend.h"
 #include "PGTransaction.h"
+#include "OpBatch.h"
 #include "cls/cas/cls_cas_ops.h"
 
 class CopyFromCallback;
@@ -357,10 +358,15 @@ public:
   }
   void queue_transaction(ObjectStore::Transaction&& t,
 			 OpRequestRef op) override {
+    flush_op_batch();
     osd->store->queue_transaction(ch, std::move(t), op);
   }
   void queue_transactions(std::vector<ObjectStore::Transaction>& tls,
 			  OpRequestRef op) override {
+    if (op_batch) {
+      op_batch->add(tls, op);
+      return;
+    }
     osd->store->queue_transactions(ch, tls, op, NULL);
   }
   epoch_t get_interval_start_epoch() const override {
@@ -901,6 +907,10 @@ protected:
    */
   void release_object_locks(ObcLockManager &lock_manager);
 
+  // op batching (osd_op_batch_*), see OSD::dequeue_op_batch
+  std::optional<OpBatch> op_batch;
+  void flush_op_batch();
+
   // replica ops
   // [primary|tail]
   xlist<RepGather*> repop_queue;
@@ -1493,6 +1503,8 @@ public:
   void do_request(
     OpRequestRef& op,
     ThreadPool::TPHandle &handle) override;
+  bool begin_op_batch() override;
+  void end_op_batch() override;
   void do_op(OpRequestRef& op);
   void record_write_error(OpRequestRef op, const hobject_t &soid,
 			  MOSDOpReply *orig_reply, int r,
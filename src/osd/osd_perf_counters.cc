@@ -126,6 +126,19 @@ PerfCounters *build_osd_logger(CephContext *cct) {
   osd_plb.add_time_avg(l_osd_op_before_dequeue_op_lat, "op_before_dequeue_op_lat",
     "Latency of IO before calling dequeue_op(already dequeued and get PG lock)"); // client io before dequeue_op latency
 
+  osd_plb.add_u64_counter(
+    l_osd_op_batch, "op_batch",
+    "Op batches submitted to the object store");
+  osd_plb.add_u64_avg(
+    l_osd_op_batch_size, "op_batch_size",
+    "Ops per op batch");
+  osd_plb.add_time_avg(
+    l_osd_op_batch_lat, "op_batch_latency",
+    "Time an op's transactions were held in an op batch before submission");
+  osd_plb.add_u64_counter(
+    l_osd_op_batch_read_flush, "op_batch_read_flush",
+    "Op batches submitted early because the next op reads");
+
   osd_plb.add_u64_counter(
     l_osd_sop, "subop", "Suboperations");
   osd_plb.add_u64_counter(
@@ -39,6 +39,11 @@ enum {
   l_osd_op_before_queue_op_lat,
   l_osd_op_before_dequeue_op_lat,
 
+  l_osd_op_batch,
+  l_osd_op_batch_size,
+  l_osd_op_batch_lat,
+  l_osd_op_batch_read_flush,
+
   l_osd_sop,
   l_osd_sop_inb,
   l_osd_sop_lat,
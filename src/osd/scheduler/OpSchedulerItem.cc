@@ -26,7 +26,11 @@ void PGOpItem::run(
   ThreadPool::TPHandle &handle)
 {
   [[maybe_unused]] auto span = tracing::osd::tracer.add_span("PGOpItem::run", op->osd_parent_span);
-  osd->dequeue_op(pg, op, handle);
+  if (osd->can_batch_op(op)) {
+    osd->dequeue_op_batch(sdata, pg, op, handle);
+  } else {
+    osd->dequeue_op(pg, op, handle);
+  }
   pg->unlock();
 }
 
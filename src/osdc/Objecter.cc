@@ -172,6 +172,7 @@ enum {
   l_osdc_osd_session_open,
   l_osdc_osd_session_close,
   l_osdc_osd_laggy,
+  l_osdc_osd_aux_cons,
 
   l_osdc_osdop_omap_wr,
   l_osdc_osdop_omap_rd,
@@ -210,6 +211,22 @@ std::unique_lock<std::mutex> Objecter::OSDSession::get_lock(object_t& oid)
   return {completion_locks[h % num_locks], std::defer_lock};
 }
 
+const ConnectionRef& Objecter::OSDSession::get_con(const object_t& oid) const
+{
+  if (aux_cons.empty() || oid.name.empty())
+    return con;
+
+  uint32_t h = ceph_str_hash_linux(oid.name.c_str(), oid.name.size())
+    % (aux_cons.size() + 1);
+  return h == 0 ? con : aux_cons[h - 1];
+}
+
+bool Objecter::OSDSession::has_con(const ConnectionRef& c) const
+{
+  return c && (c == con ||
+	       std::find(aux_cons.begin(), aux_cons.end(), c) != aux_cons.end());
+}
+
 const char** Objecter::get_tracked_conf_keys() const
 {
   static const char *config_keys[] = {
@@ -364,6 +381,8 @@ void Objecter::init()
     pcb.add_u64_counter(l_osdc_osd_session_close, "osd_session_close",
 			"Sessions closed");
     pcb.add_u64(l_osdc_osd_laggy, "osd_laggy", "Laggy OSD sessions");
+    pcb.add_u64(l_osdc_osd_aux_cons, "osd_aux_cons",
+		"Additional connections open to OSDs");
 
     pcb.add_u64_counter(l_osdc_osdop_omap_wr, "omap_wr",
 			"OSD OMAP write operations");
@@ -576,6 +595,7 @@ void Objecter::_send_linger(LingerOp *info,
   // do not resend this; we will send a new op to reregister
   o->should_resend = false;
   o->ctx_budgeted = true;
+  o->primary_con = true;
 
   if (info->register_tid) {
     // repeat send.  cancel old registration op, if any.
@@ -707,6 +727,7 @@ void Objecter::_send_linger_ping(LingerOp *info)
 		 nullptr, nullptr);
   o->target = info->target;
   o->should_resend = false;
+  o->primary_con = true;
   _send_op_account(o);
   o->tid = ++last_tid;
   _session_op_assign(info->session, o);
@@ -1896,12 +1917,45 @@ void Objecter::_reopen_session(OSDSession *s)
     s->con->mark_down();
     logger->inc(l_osdc_osd_session_close);
   }
+  _close_aux_cons(s);
   s->con = messenger->connect_to_osd(addrs);
   s->con->set_priv(RefCountedPtr{s});
   s->incarnation++;
   logger->inc(l_osdc_osd_session_open);
 }
 
+void Objecter::_open_aux_cons(OSDSession *s)
+{
+  // extra connections are anonymous so that neither end registers them
+  // under our address.  only osds that advertised CONNECT_ANON on the
+  // primary connection know not to; older ones keep a single connection.
+  auto n = cct->_conf.get_val<uint64_t>("objecter_osd_connections");
+  if (n <= 1 || !s->con || !s->aux_cons.empty() ||
+      !HAVE_MSGR2_FEATURE(s->con->get_peer_msgr2_features(), CONNECT_ANON)) {
+    return;
+  }
+  auto addrs = s->con->get_peer_addrs();
+  s->aux_cons.reserve(n - 1);
+  for (uint64_t i = 1; i < n; ++i) {
+    auto c = messenger->connect_to_osd(addrs, true /* anon */);
+    c->set_priv(RefCountedPtr{s});
+    s->aux_cons.push_back(std::move(c));
+  }
+  logger->inc(l_osdc_osd_aux_cons, s->aux_cons.size());
+  ldout(cct, 10) << __func__ << " osd." << s->osd << " opened "
+		 << s->aux_cons.size() << " additional connections" << dendl;
+}
+
+void Objecter::_close_aux_cons(OSDSession *s)
+{
+  for (auto& c : s->aux_cons) {
+    c->set_priv(NULL);
+    c->mark_down();
+  }
+  logger->dec(l_osdc_osd_aux_cons, s->aux_cons.size());
+  s->aux_cons.clear();
+}
+
 void Objecter::close_session(OSDSession *s)
 {
   // rwlock is locked unique
@@ -1912,6 +1966,7 @@ void Objecter::close_session(OSDSession *s)
     s->con->mark_down();
     logger->inc(l_osdc_osd_session_close);
   }
+  _close_aux_cons(s);
   unique_lock sl(s->lock);
 
   std::list<LingerOp*> homeless_lingers;
@@ -3274,7 +3329,8 @@ void Objecter::_send_op(Op *op)
 		 << op->target.actual_pgid << " on osd." << op->session->osd
 		 << dendl;
 
-  ConnectionRef con = op->session->con;
+  ConnectionRef con = op->primary_con ? op->session->con
+    : op->session->get_con(op->target.base_oid);
   ceph_assert(con);
 
 #if 0
@@ -3300,7 +3356,7 @@ void Objecter::_send_op(Op *op)
   if (op->trace.valid()) {
     m->trace.init("op msg", nullptr, &op->trace);
   }
-  op->session->con->send_message(m);
+  con->send_message(m);
 }
 
 int Objecter::calc_op_budget(const bc::small_vector_base<OSDOp>& ops)
@@ -3370,7 +3426,7 @@ void Objecter::handle_osd_op_reply(MOSDOpReply *m)
   ConnectionRef con = m->get_connection();
   auto priv = con->get_priv();
   auto s = static_cast<OSDSession*>(priv.get());
-  if (!s || s->con != con) {
+  if (!s || !s->has_con(con)) {
     ldout(cct, 7) << __func__ << " no session on con " << con << dendl;
     m->put();
     return;
@@ -3594,7 +3650,7 @@ void Objecter::handle_osd_backoff(MOSDBackoff *m)
   ConnectionRef con = m->get_connection();
   auto priv = con->get_priv();
   auto s = static_cast<OSDSession*>(priv.get());
-  if (!s || s->con != con) {
+  if (!s || !s->has_con(con)) {
     ldout(cct, 7) << __func__ << " no session on con " << con << dendl;
     m->put();
     return;
@@ -4426,6 +4482,18 @@ void Objecter::ms_handle_connect(Connection *con)
 
   if (con->get_peer_type() == CEPH_ENTITY_TYPE_MON)
     resend_mon_ops();
+
+  if (con->get_peer_type() == CEPH_ENTITY_TYPE_OSD) {
+    auto priv = con->get_priv();
+    auto session = static_cast<OSDSession*>(priv.get());
+    if (session) {
+      unique_lock wl(rwlock);
+      unique_lock sl(session->lock);
+      if (session->con == con) {
+	_open_aux_cons(session);
+      }
+    }
+  }
 }
 
 bool Objecter::ms_handle_reset(Connection *con)
@@ -4747,7 +4815,7 @@ void Objecter::handle_command_reply(MCommandReply *m)
   ConnectionRef con = m->get_connection();
   auto priv = con->get_priv();
   auto s = static_cast<OSDSession*>(priv.get());
-  if (!s || s->con != con) {
+  if (!s || !s->has_con(con)) {
     ldout(cct, 7) << __func__ << " no session on con " << con << dendl;
     m->put();
     return;
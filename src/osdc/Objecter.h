@@ -1943,6 +1943,10 @@ public:
     /// true if we should resend this message on failure
     bool should_resend = true;
 
+    /// true to send over the session's first connection even when
+    /// objecter_osd_connections spreads ops over several (watch/notify)
+    bool primary_con = false;
+
     /// true if the throttle budget is get/put on a series of OPs,
     /// instead of per OP basis, when this flag is set, the budget is
     /// acquired before sending the very first OP of the series and
@@ -2391,6 +2395,10 @@ public:
 
     int incarnation;
     ConnectionRef con;
+    // additional connections to the same osd (objecter_osd_connections > 1);
+    // regular ops are spread over con and these by object name hash, so
+    // ops on one object always travel over the same connection.
+    std::vector<ConnectionRef> aux_cons;
     int num_locks;
     std::unique_ptr<std::mutex[]> completion_locks;
 
@@ -2404,6 +2412,11 @@ public:
     bool is_homeless() { return (osd == -1); }
 
     std::unique_lock<std::mutex> get_lock(object_t& oid);
+
+    /// connection that carries ops on oid
+    const ConnectionRef& get_con(const object_t& oid) const;
+    /// true if c is one of this session's connections
+    bool has_con(const ConnectionRef& c) const;
   };
   std::map<int,OSDSession*> osd_sessions;
 
@@ -2538,6 +2551,8 @@ private:
   void put_session(OSDSession *s);
   void get_session(OSDSession *s);
   void _reopen_session(OSDSession *session);
+  void _open_aux_cons(OSDSession *session);
+  void _close_aux_cons(OSDSession *session);
   void close_session(OSDSession *session);
 
   void _nlist_reply(NListContext *list_context, int r, Context *final_finish,
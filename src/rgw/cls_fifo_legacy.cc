@@ -25,6 +25,7 @@
 #include "include/rados/librados.hpp"
 
 #include "include/buffer.h"
+#include "include/scope_guard.h"
 
 #include "common/async/yield_context.h"
 #include "common/random_string.h"
@@ -1310,12 +1311,17 @@ void FIFO::push(const DoutPrefixProvider *dpp, const cb::list& bl, lr::AioComple
   push(dpp, std::vector{ bl }, c);
 }
 
+struct FIFO::push_waiter {
+  const std::vector<cb::list>* data_bufs;
+  int r = 0;
+  bool done = false;
+};
+
 int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_bufs, optional_yield y)
 {
   std::unique_lock l(m);
   auto tid = ++next_tid;
   auto max_entry_size = info.params.max_entry_size;
-  auto need_new_head = info.need_new_head();
   l.unlock();
   ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ << ":" << __LINE__
 		 << " entering: tid=" << tid << dendl;
@@ -1334,6 +1340,77 @@ int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_
     }
   }
 
+  if (y) {
+    // A coroutine can't sleep on push_cond, so push on our own.
+    return _push(dpp, {data_bufs.begin(), data_bufs.end()}, tid, y, nullptr);
+  }
+
+  // Queue behind any push in flight. When it finishes, one of the
+  // queued callers becomes the leader and pushes everything queued so
+  // far in one go, so N concurrent callers cost one push_part per part
+  // rather than N.
+  push_waiter w{&data_bufs};
+  std::unique_lock pl(push_m);
+  push_waiters.push_back(&w);
+  while (!w.done) {
+    if (push_leader) {
+      push_cond.wait(pl);
+      continue;
+    }
+    push_leader = true;
+    auto group = std::move(push_waiters);
+    push_waiters.clear();
+    pl.unlock();
+
+    std::deque<cb::list> remaining;
+    for (const auto g : group) {
+      remaining.insert(remaining.end(), g->data_bufs->begin(),
+		       g->data_bufs->end());
+    }
+    ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ << ":" << __LINE__
+		   << " leading push: callers=" << group.size()
+		   << " entries=" << remaining.size()
+		   << " tid=" << tid << dendl;
+    std::size_t pushed = 0;
+    auto r = _push(dpp, std::move(remaining), tid, y, &pushed);
+
+    // Entries go out in order, so on failure everyone whose entries
+    // all made it succeeded, the caller the push stopped in gets the
+    // error, and those behind it push again on their own.
+    pl.lock();
+    std::size_t end = 0;
+    std::vector<push_waiter*> retry;
+    for (auto g : group) {
+      auto begin = end;
+      end += g->data_bufs->size();
+      if (r < 0 && begin > pushed) {
+	retry.push_back(g);
+	continue;
+      }
+      g->r = (r == 0 || end <= pushed) ? 0 : r;
+      g->done = true;
+    }
+    if (!retry.empty()) {
+      ldpp_dout(dpp, 5) << __PRETTY_FUNCTION__ << ":" << __LINE__
+		    << " coalesced push failed: r=" << r
+		    << " pushed=" << pushed << "/" << end
+		    << " requeued callers=" << retry.size()
+		    << " tid=" << tid << dendl;
+      push_waiters.insert(push_waiters.begin(), retry.begin(), retry.end());
+    }
+    push_leader = false;
+    push_cond.notify_all();
+  }
+  return w.r;
+}
+
+int FIFO::_push(const DoutPrefixProvider *dpp, std::deque<cb::list> remaining,
+		std::uint64_t tid, optional_yield y, std::size_t* pushed)
+{
+  std::unique_lock l(m);
+  auto need_new_head = info.need_new_head();
+  l.unlock();
+
   int r = 0;
   if (need_new_head) {
     ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ << ":" << __LINE__
@@ -1347,7 +1424,46 @@ int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_
     }
   }
 
-  std::deque<cb::list> remaining(data_bufs.begin(), data_bufs.end());
+  // If nothing exists past the head, create the next part while we
+  // push to this one, so that when the head fills moving on to a new
+  // one costs a metadata update rather than a journaled part
+  // creation. Only blocking callers can wait for it to finish.
+  lr::AioCompletion* prealloc = nullptr;
+  auto maybe_preallocate = [&] {
+    if (y || prealloc) {
+      return;
+    }
+    std::unique_lock l(m);
+    if (preallocating || info.max_push_part_num > info.head_part_num) {
+      return;
+    }
+    preallocating = true;
+    l.unlock();
+    ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ << ":" << __LINE__
+		   << " preallocating part after head: tid=" << tid << dendl;
+    prealloc = lr::Rados::aio_create_completion();
+    _prepare_new_part(dpp, false, tid, prealloc);
+  };
+  auto wait_preallocate = [&] {
+    if (!prealloc) {
+      return;
+    }
+    prealloc->wait_for_complete();
+    auto r = prealloc->get_return_value();
+    prealloc->release();
+    prealloc = nullptr;
+    if (r < 0) {
+      // Not fatal, _prepare_new_head will create the part when needed.
+      ldpp_dout(dpp, 5) << __PRETTY_FUNCTION__ << ":" << __LINE__
+		    << " preallocating part failed: r=" << r
+		    << " tid=" << tid << dendl;
+    }
+    std::unique_lock l(m);
+    preallocating = false;
+  };
+  auto g = make_scope_guard([&] { wait_preallocate(); });
+  maybe_preallocate();
+
   std::deque<cb::list> batch;
 
   uint64_t batch_len = 0;
@@ -1386,6 +1502,8 @@ int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_
       ++retries;
       ldpp_dout(dpp, 20) << __PRETTY_FUNCTION__ << ":" << __LINE__
 		     << " need new head tid=" << tid << dendl;
+      // Don't race our own preallocation for the same part number.
+      wait_preallocate();
       r = _prepare_new_head(dpp, tid, y);
       if (r < 0) {
 	ldpp_dout(dpp, -1) << __PRETTY_FUNCTION__ << ":" << __LINE__
@@ -1393,6 +1511,7 @@ int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_
 		   << " tid=" << tid << dendl;
 	return r;
       }
+      maybe_preallocate();
       r = 0;
       continue;
     }
@@ -1406,6 +1525,9 @@ int FIFO::push(const DoutPrefixProvider *dpp, const std::vector<cb::list>& data_
     canceled = false;
     retries = 0;
     batch_len = 0;
+    if (pushed) {
+      *pushed += r;
+    }
     if (static_cast<unsigned>(r) == batch.size()) {
       batch.clear();
     } else  {
@@ -16,6 +16,7 @@
 #ifndef CEPH_RGW_CLS_FIFO_LEGACY_H
 #define CEPH_RGW_CLS_FIFO_LEGACY_H
 
+#include <condition_variable>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -121,6 +122,18 @@ class FIFO {
   std::uint32_t part_header_size = 0xdeadbeef;
   std::uint32_t part_entry_overhead = 0xdeadbeef;
 
+  /// True while a part past the head is being created, see _push()
+  bool preallocating = false;
+
+  /// Blocking pushes are coalesced: whoever finds no push in flight
+  /// becomes the leader and pushes the entries of everyone queued
+  /// behind it, see push()
+  struct push_waiter;
+  std::mutex push_m;
+  std::condition_variable push_cond;
+  std::vector<push_waiter*> push_waiters;
+  bool push_leader = false;
+
   std::optional<marker> to_marker(std::string_view s);
 
   FIFO(lr::IoCtx&& ioc,
@@ -154,6 +167,8 @@ class FIFO {
 		   std::uint64_t tid, optional_yield y);
   void push_entries(const std::deque<cb::list>& data_bufs,
 		    std::uint64_t tid, lr::AioCompletion* c);
+  int _push(const DoutPrefixProvider *dpp, std::deque<cb::list> remaining,
+	    std::uint64_t tid, optional_yield y, std::size_t* pushed);
   int trim_part(const DoutPrefixProvider *dpp, int64_t part_num, uint64_t ofs,
 		std::optional<std::string_view> tag, bool exclusive,
 		std::uint64_t tid, optional_yield y);
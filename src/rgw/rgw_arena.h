@@ -0,0 +1,54 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace rgw {
+
+/**
+ * RequestArena is a memory resource for containers that live no longer
+ * than a request. Allocations are served from an inline buffer, then from
+ * heap blocks of growing size, and deallocation is a no-op: everything is
+ * released at once when the arena is destroyed. That replaces a malloc and
+ * free per map node with a pointer bump, and keeps the nodes of a request
+ * together in memory. Since nothing is reused, it only suits containers
+ * that mostly grow: memory a container erases or rehashes away stays
+ * allocated until the end of the request.
+ *
+ * Allocation is serialized, as a request may spawn coroutines that run on
+ * other threads.
+ */
+class RequestArena : public std::pmr::memory_resource {
+ public:
+  static constexpr size_t inline_size = 2048;
+
+  explicit RequestArena(std::pmr::memory_resource *upstream =
+                          std::pmr::new_delete_resource())
+    : resource(buffer.data(), buffer.size(), upstream) {}
+
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+
+ private:
+  alignas(std::max_align_t) std::array<std::byte, inline_size> buffer;
+  std::mutex mutex;
+  std::pmr::monotonic_buffer_resource resource;
+
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    std::lock_guard lock{mutex};
+    return resource.allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    // released with the arena
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // namespace rgw
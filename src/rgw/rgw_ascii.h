@@ -0,0 +1,202 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* byte-string helpers for the request path (url decoding, header names and
+ * values in signatures). they work 16 bytes at a time with SSE2, which every
+ * x86_64 build has, and fall back to a byte loop elsewhere and for the tail.
+ * all of them treat text as ASCII, like the "C" locale radosgw runs in */
+namespace rgw::ascii {
+
+/// isspace() of the "C" locale
+inline bool is_space(char c) {
+  return c == ' ' || static_cast<unsigned>(c - '\t') < 5;
+}
+
+#ifdef __SSE2__
+namespace detail {
+
+inline __m128i load(const char *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void store(char *p, __m128i v) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+/// 0xff in the bytes of v that are within [lo, hi]
+inline __m128i in_range(__m128i v, char lo, char hi) {
+  // bias to signed so a signed compare orders the bytes as unsigned
+  const __m128i bias = _mm_set1_epi8(-128);
+  const __m128i b = _mm_xor_si128(v, bias);
+  const __m128i l = _mm_xor_si128(_mm_set1_epi8(lo), bias);
+  const __m128i h = _mm_xor_si128(_mm_set1_epi8(hi), bias);
+  return _mm_andnot_si128(_mm_or_si128(_mm_cmplt_epi8(b, l),
+                                       _mm_cmpgt_epi8(b, h)),
+                          _mm_set1_epi8(-1));
+}
+
+/// add delta to the bytes within [lo, hi], and replace the bytes equal to
+/// each from[i] with to[i]
+inline __m128i map(__m128i v, char lo, char hi, char delta,
+                   char from1, char to1, char from2, char to2) {
+  const __m128i alpha = in_range(v, lo, hi);
+  const __m128i f1 = _mm_cmpeq_epi8(v, _mm_set1_epi8(from1));
+  const __m128i f2 = _mm_cmpeq_epi8(v, _mm_set1_epi8(from2));
+  __m128i r = _mm_add_epi8(v, _mm_and_si128(alpha, _mm_set1_epi8(delta)));
+  r = _mm_or_si128(_mm_andnot_si128(f1, r),
+                   _mm_and_si128(f1, _mm_set1_epi8(to1)));
+  r = _mm_or_si128(_mm_andnot_si128(f2, r),
+                   _mm_and_si128(f2, _mm_set1_epi8(to2)));
+  return r;
+}
+
+inline size_t first_bit(int mask) {
+  return __builtin_ctz(mask);
+}
+
+} // namespace detail
+#endif
+
+/// return the offset of the first byte of s that is a or b, or s.size()
+inline size_t find_first_of(std::string_view s, char a, char b) {
+  const char *p = s.data();
+  const size_t n = s.size();
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i va = _mm_set1_epi8(a);
+  const __m128i vb = _mm_set1_epi8(b);
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = detail::load(p + i);
+    const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va),
+                                                    _mm_cmpeq_epi8(v, vb)));
+    if (mask) {
+      return i + detail::first_bit(mask);
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (p[i] == a || p[i] == b) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/// return the offset of the first whitespace byte of s, or s.size()
+inline size_t find_space(std::string_view s) {
+  const char *p = s.data();
+  const size_t n = s.size();
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128i space = _mm_set1_epi8(' ');
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = detail::load(p + i);
+    const int mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(v, space),
+                     detail::in_range(v, '\t', '\r')));
+    if (mask) {
+      return i + detail::first_bit(mask);
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    if (is_space(p[i])) {
+      return i;
+    }
+  }
+  return n;
+}
+
+/// append the header name of an env var name ("HTTP_" already removed) to
+/// out: lowercased, with '_' for '-'
+inline void append_header_name(std::string_view env, std::string& out) {
+  const size_t pos = out.size();
+  out.resize(pos + env.size());
+  const char *in = env.data();
+  char *dst = out.data() + pos;
+  const size_t n = env.size();
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= n; i += 16) {
+    detail::store(dst + i, detail::map(detail::load(in + i), 'A', 'Z',
+                                       'a' - 'A', '_', '-', '_', '-'));
+  }
+#endif
+  for (; i < n; i++) {
+    const char c = in[i];
+    if (c == '_') {
+      dst[i] = '-';
+    } else if (c >= 'A' && c <= 'Z') {
+      dst[i] = c + ('a' - 'A');
+    } else {
+      dst[i] = c;
+    }
+  }
+}
+
+/// append the env var name of a header name to out: uppercased, with '-'
+/// and '_' swapped
+inline void append_env_name(std::string_view header, std::string& out) {
+  const size_t pos = out.size();
+  out.resize(pos + header.size());
+  const char *in = header.data();
+  char *dst = out.data() + pos;
+  const size_t n = header.size();
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= n; i += 16) {
+    detail::store(dst + i, detail::map(detail::load(in + i), 'a', 'z',
+                                       'A' - 'a', '-', '_', '_', '-'));
+  }
+#endif
+  for (; i < n; i++) {
+    const char c = in[i];
+    if (c == '-') {
+      dst[i] = '_';
+    } else if (c == '_') {
+      dst[i] = '-';
+    } else if (c >= 'a' && c <= 'z') {
+      dst[i] = c - ('a' - 'A');
+    } else {
+      dst[i] = c;
+    }
+  }
+}
+
+/// boost::trim_all(): remove leading and trailing whitespace, and shorten
+/// runs of whitespace inside to their first byte
+inline void trim_all(std::string& s) {
+  if (find_space(s) == s.size()) {
+    return; // the usual case
+  }
+  size_t out = 0;
+  bool in_space = true; // drops leading whitespace
+  for (size_t i = 0; i < s.size(); i++) {
+    const char c = s[i];
+    if (is_space(c)) {
+      if (!in_space) {
+        s[out++] = c;
+        in_space = true;
+      }
+    } else {
+      s[out++] = c;
+      in_space = false;
+    }
+  }
+  if (out > 0 && in_space) {
+    out--; // trailing whitespace
+  }
+  s.resize(out);
+}
+
+} // namespace rgw::ascii
@@ -268,7 +268,7 @@ void handle_connection(boost::asio::io_context& context,
 
       process_request(env.store, env.rest, &req, env.uri_prefix,
                       *env.auth_registry, &client, env.olog, y,
-                      scheduler, &user, &latency, &http_ret);
+                      scheduler, env.ratelimiter, &user, &latency, &http_ret);
 
       if (cct->_conf->subsys.should_gather(dout_subsys, 1)) {
         // access log line elements begin per Apache Combined Log Format with additions following
@@ -416,14 +416,23 @@ class AsioFrontend {
   {
     auto sched_t = dmc::get_scheduler_t(ctx());
     switch(sched_t){
-    case dmc::scheduler_t::dmclock:
-      scheduler.reset(new dmc::AsyncScheduler(ctx(),
-                                              context,
-                                              std::ref(sched_ctx.get_dmc_client_counters()),
-                                              sched_ctx.get_dmc_client_config(),
-                                              *sched_ctx.get_dmc_client_config(),
-                                              dmc::AtLimit::Reject));
+    case dmc::scheduler_t::dmclock: {
+      // erase idle clients on the schedule that dmc::ClientStats assumes
+      // when it drops names from its table
+      const auto idle_age = ctx()->_conf.get_val<std::chrono::seconds>(
+          "rgw_dmclock_client_idle_age");
+      auto s = new dmc::AsyncScheduler(ctx(),
+                                       context,
+                                       std::ref(sched_ctx.get_dmc_client_counters()),
+                                       sched_ctx.get_dmc_client_config(),
+                                       std::ref(*sched_ctx.get_dmc_client_config()),
+                                       idle_age, idle_age,
+                                       dmc::client_check_time(idle_age),
+                                       dmc::AtLimit::Reject);
+      s->set_client_stats(sched_ctx.get_dmc_client_stats());
+      scheduler.reset(s);
       break;
+    }
     case dmc::scheduler_t::none:
       lderr(ctx()) << "Got invalid scheduler type for beast, defaulting to throttler" << dendl;
       [[fallthrough]];
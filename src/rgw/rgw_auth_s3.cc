@@ -16,10 +16,10 @@
 #include "rgw_client_io.h"
 #include "rgw_rest.h"
 #include "rgw_crypt_sanitize.h"
+#include "rgw_ascii.h"
 
 #include <boost/container/small_vector.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/algorithm/string/trim_all.hpp>
 
 #define dout_context g_ceph_context
 #define dout_subsys ceph_subsys_rgw
@@ -663,11 +663,7 @@ get_v4_canonical_headers(const req_info& info,
      * get push_back() and reserve() first. */
     std::string token_env = "HTTP_";
     token_env.reserve(token.length() + std::strlen("HTTP_") + 1);
-
-    std::transform(std::begin(token), std::end(token),
-                   std::back_inserter(token_env), [](const int c) {
-                     return c == '-' ? '_' : c == '_' ? '-' : std::toupper(c);
-                   });
+    rgw::ascii::append_env_name(token, token_env);
 
     if (token_env == "HTTP_CONTENT_LENGTH") {
       token_env = "CONTENT_LENGTH";
@@ -711,7 +707,7 @@ get_v4_canonical_headers(const req_info& info,
   for (const auto& header : canonical_hdrs_map) {
     const std::string_view& name = header.first;
     std::string value = header.second;
-    boost::trim_all<std::string>(value);
+    rgw::ascii::trim_all(value);
 
     canonical_hdrs.append(name.data(), name.length())
                   .append(":", std::strlen(":"))
@@ -721,7 +717,7 @@ get_v4_canonical_headers(const req_info& info,
   return canonical_hdrs;
 }
 
-static void handle_header(const string& header, const string& val,
+static void handle_header(std::string_view header, std::string_view val,
                           std::map<std::string, std::string> *canonical_hdrs_map)
 {
   /* TODO(rzarzynski): we'd like to switch to sstring here but it should
@@ -735,15 +731,11 @@ static void handle_header(const string& header, const string& val,
   } else if (header == "HTTP_CONTENT_TYPE") {
     token = "content-type";
   } else {
-    auto start = std::begin(header);
-    if (boost::algorithm::starts_with(header, "HTTP_")) {
-      start += 5; /* len("HTTP_") */
+    std::string_view name = header;
+    if (boost::algorithm::starts_with(name, "HTTP_")) {
+      name.remove_prefix(5); /* len("HTTP_") */
     }
-
-    std::transform(start, std::end(header),
-                   std::back_inserter(token), [](const int c) {
-                   return c == '_' ? '-' : std::tolower(c);
-                   });
+    rgw::ascii::append_header_name(name, token);
   }
 
   (*canonical_hdrs_map)[token] = rgw_trim_whitespace(val);
@@ -766,7 +758,7 @@ std::string gen_v4_canonical_headers(const req_info& info,
   for (const auto& header : canonical_hdrs_map) {
     const auto& name = header.first;
     std::string value = header.second;
-    boost::trim_all<std::string>(value);
+    rgw::ascii::trim_all(value);
 
     if (!signed_hdrs->empty()) {
       signed_hdrs->append(";");
@@ -2515,17 +2515,39 @@ int RGWBucketCtl::read_bucket_instance_info(const rgw_bucket& bucket,
                                             optional_yield y,
                                             const DoutPrefixProvider *dpp,
                                             const BucketInstance::GetParams& params)
+{
+  RGWSI_Bucket::bucket_info_snapshot e;
+  int ret = read_bucket_instance_snapshot(bucket, &e, y, dpp, params);
+  if (ret < 0) {
+    *info = RGWBucketInfo();
+    return ret;
+  }
+
+  *info = e->info;
+  if (params.mtime) {
+    *params.mtime = e->mtime;
+  }
+  if (params.attrs) {
+    *params.attrs = e->attrs;
+  }
+
+  return 0;
+}
+
+int RGWBucketCtl::read_bucket_instance_snapshot(const rgw_bucket& bucket,
+                                                RGWSI_Bucket::bucket_info_snapshot *snapshot,
+                                                optional_yield y,
+                                                const DoutPrefixProvider *dpp,
+                                                const BucketInstance::GetParams& params)
 {
   int ret = bmi_handler->call(params.bectx_params, [&](RGWSI_Bucket_BI_Ctx& ctx) {
-    return svc.bucket->read_bucket_instance_info(ctx,
-                                                 RGWSI_Bucket::get_bi_meta_key(bucket),
-                                                 info,
-                                                 params.mtime,
-                                                 params.attrs,
-						 y,
-                                                 dpp,
-                                                 params.cache_info,
-                                                 params.refresh_version);
+    return svc.bucket->read_bucket_instance_snapshot(ctx,
+                                                     RGWSI_Bucket::get_bi_meta_key(bucket),
+                                                     snapshot,
+                                                     y,
+                                                     dpp,
+                                                     params.cache_info,
+                                                     params.refresh_version);
   });
 
   if (ret < 0) {
@@ -2533,7 +2555,7 @@ int RGWBucketCtl::read_bucket_instance_info(const rgw_bucket& bucket,
   }
 
   if (params.objv_tracker) {
-    *params.objv_tracker = info->objv_tracker;
+    *params.objv_tracker = (*snapshot)->info.objv_tracker;
   }
 
   return 0;
@@ -2545,6 +2567,31 @@ int RGWBucketCtl::read_bucket_info(const rgw_bucket& bucket,
                                    const DoutPrefixProvider *dpp,
                                    const BucketInstance::GetParams& params,
                                    RGWObjVersionTracker *ep_objv_tracker)
+{
+  RGWSI_Bucket::bucket_info_snapshot e;
+  int ret = read_bucket_info_snapshot(bucket, &e, y, dpp, params,
+                                      ep_objv_tracker);
+  if (ret < 0) {
+    return ret;
+  }
+
+  *info = e->info;
+  if (params.mtime) {
+    *params.mtime = e->mtime;
+  }
+  if (params.attrs) {
+    *params.attrs = e->attrs;
+  }
+
+  return 0;
+}
+
+int RGWBucketCtl::read_bucket_info_snapshot(const rgw_bucket& bucket,
+                                            RGWSI_Bucket::bucket_info_snapshot *snapshot,
+                                            optional_yield y,
+                                            const DoutPrefixProvider *dpp,
+                                            const BucketInstance::GetParams& params,
+                                            RGWObjVersionTracker *ep_objv_tracker)
 {
   const rgw_bucket *b = &bucket;
 
@@ -2563,26 +2610,7 @@ int RGWBucketCtl::read_bucket_info(const rgw_bucket& bucket,
     b = &ep->bucket;
   }
 
-  int ret = bmi_handler->call(params.bectx_params, [&](RGWSI_Bucket_BI_Ctx& ctx) {
-    return svc.bucket->read_bucket_instance_info(ctx,
-                                                 RGWSI_Bucket::get_bi_meta_key(*b),
-                                                 info,
-                                                 params.mtime,
-                                                 params.attrs,
-						 y, dpp,
-                                                 params.cache_info,
-                                                 params.refresh_version);
-  });
-
-  if (ret < 0) {
-    return ret;
-  }
-
-  if (params.objv_tracker) {
-    *params.objv_tracker = info->objv_tracker;
-  }
-
-  return 0;
+  return read_bucket_instance_snapshot(*b, snapshot, y, dpp, params);
 }
 
 int RGWBucketCtl::do_store_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
@@ -2990,10 +3018,11 @@ int RGWBucketCtl::read_bucket_stats(const rgw_bucket& bucket,
 }
 
 int RGWBucketCtl::read_buckets_stats(map<string, RGWBucketEnt>& m,
+                                     bool cached_stats,
                                      optional_yield y, const DoutPrefixProvider *dpp)
 {
   return call([&](RGWSI_Bucket_X_Ctx& ctx) {
-    return svc.bucket->read_buckets_stats(ctx, m, y, dpp);
+    return svc.bucket->read_buckets_stats(ctx, m, cached_stats, y, dpp);
   });
 }
 
@@ -25,6 +25,7 @@
 #include "rgw_formats.h"
 
 #include "services/svc_bucket_types.h"
+#include "services/svc_bucket.h"
 #include "services/svc_bucket_sync.h"
 
 // define as static when RGWBucket implementation completes
@@ -662,6 +663,23 @@ public:
                        const BucketInstance::GetParams& params = {},
 		       RGWObjVersionTracker *ep_objv_tracker = nullptr);
 
+  /*
+   * as above, but hand out the cached snapshot of the bucket instance
+   * instead of copying it. params.mtime and params.attrs are unused, the
+   * snapshot carries both
+   */
+  int read_bucket_instance_snapshot(const rgw_bucket& bucket,
+                                    RGWSI_Bucket::bucket_info_snapshot *snapshot,
+                                    optional_yield y,
+                                    const DoutPrefixProvider *dpp,
+                                    const BucketInstance::GetParams& params = {});
+  int read_bucket_info_snapshot(const rgw_bucket& bucket,
+                                RGWSI_Bucket::bucket_info_snapshot *snapshot,
+                                optional_yield y,
+                                const DoutPrefixProvider *dpp,
+                                const BucketInstance::GetParams& params = {},
+                                RGWObjVersionTracker *ep_objv_tracker = nullptr);
+
 
   int set_bucket_instance_attrs(RGWBucketInfo& bucket_info,
                                 std::map<std::string, bufferlist>& attrs,
@@ -689,6 +707,7 @@ public:
             const std::string& marker, optional_yield y, const DoutPrefixProvider *dpp);
 
   int read_buckets_stats(std::map<std::string, RGWBucketEnt>& m,
+                         bool cached_stats,
                          optional_yield y,
                          const DoutPrefixProvider *dpp);
 
@@ -689,29 +689,30 @@ RGWBucketSyncPolicyHandler::RGWBucketSyncPolicyHandler(RGWSI_Zone *_zone_svc,
 }
 
 RGWBucketSyncPolicyHandler::RGWBucketSyncPolicyHandler(const RGWBucketSyncPolicyHandler *_parent,
-                                                       const RGWBucketInfo& _bucket_info,
-                                                       map<string, bufferlist>&& _bucket_attrs) : parent(_parent),
-                                                                                                       bucket_info(_bucket_info),
+                                                       std::shared_ptr<const RGWBucketInfo> _bucket_info,
+                                                       std::shared_ptr<const map<string, bufferlist> > _bucket_attrs) : parent(_parent),
+                                                                                                       bucket_info(std::move(_bucket_info)),
                                                                                                        bucket_attrs(std::move(_bucket_attrs)) {
-  if (_bucket_info.sync_policy) {
-    sync_policy = *_bucket_info.sync_policy;
+  const RGWBucketInfo& info = *bucket_info;
+  if (info.sync_policy) {
+    sync_policy = *info.sync_policy;
 
     for (auto& entry : sync_policy.groups) {
       for (auto& pipe : entry.second.pipes) {
         if (pipe.params.mode == rgw_sync_pipe_params::MODE_USER &&
             pipe.params.user.empty()) {
-          pipe.params.user = _bucket_info.owner;
+          pipe.params.user = info.owner;
         }
       }
     }
   }
   legacy_config = parent->legacy_config;
-  bucket = _bucket_info.bucket;
+  bucket = info.bucket;
   zone_svc = parent->zone_svc;
   bucket_sync_svc = parent->bucket_sync_svc;
   flow_mgr.reset(new RGWBucketSyncFlowManager(zone_svc->ctx(),
                                               parent->zone_id,
-                                              _bucket_info.bucket,
+                                              info.bucket,
                                               parent->flow_mgr.get()));
 }
 
@@ -734,7 +735,14 @@ RGWBucketSyncPolicyHandler::RGWBucketSyncPolicyHandler(const RGWBucketSyncPolicy
 RGWBucketSyncPolicyHandler *RGWBucketSyncPolicyHandler::alloc_child(const RGWBucketInfo& bucket_info,
                                                                     map<string, bufferlist>&& bucket_attrs) const
 {
-  return new RGWBucketSyncPolicyHandler(this, bucket_info, std::move(bucket_attrs));
+  return alloc_child(std::make_shared<const RGWBucketInfo>(bucket_info),
+                     std::make_shared<const map<string, bufferlist> >(std::move(bucket_attrs)));
+}
+
+RGWBucketSyncPolicyHandler *RGWBucketSyncPolicyHandler::alloc_child(std::shared_ptr<const RGWBucketInfo> bucket_info,
+                                                                    std::shared_ptr<const map<string, bufferlist> > bucket_attrs) const
+{
+  return new RGWBucketSyncPolicyHandler(this, std::move(bucket_info), std::move(bucket_attrs));
 }
 
 RGWBucketSyncPolicyHandler *RGWBucketSyncPolicyHandler::alloc_child(const rgw_bucket& bucket,
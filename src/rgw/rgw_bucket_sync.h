@@ -284,8 +284,9 @@ class RGWBucketSyncPolicyHandler {
   RGWSI_Zone *zone_svc;
   RGWSI_Bucket_Sync *bucket_sync_svc;
   rgw_zone_id zone_id;
-  std::optional<RGWBucketInfo> bucket_info;
-  std::optional<std::map<std::string, bufferlist> > bucket_attrs;
+  /* shared with the bucket info cache's snapshot where there is one */
+  std::shared_ptr<const RGWBucketInfo> bucket_info;
+  std::shared_ptr<const std::map<std::string, bufferlist> > bucket_attrs;
   std::optional<rgw_bucket> bucket;
   std::unique_ptr<RGWBucketSyncFlowManager> flow_mgr;
   rgw_sync_policy_info sync_policy;
@@ -314,8 +315,8 @@ class RGWBucketSyncPolicyHandler {
   }
 
   RGWBucketSyncPolicyHandler(const RGWBucketSyncPolicyHandler *_parent,
-                             const RGWBucketInfo& _bucket_info,
-                             std::map<std::string, bufferlist>&& _bucket_attrs);
+                             std::shared_ptr<const RGWBucketInfo> _bucket_info,
+                             std::shared_ptr<const std::map<std::string, bufferlist> > _bucket_attrs);
 
   RGWBucketSyncPolicyHandler(const RGWBucketSyncPolicyHandler *_parent,
                              const rgw_bucket& _bucket,
@@ -328,6 +329,8 @@ public:
 
   RGWBucketSyncPolicyHandler *alloc_child(const RGWBucketInfo& bucket_info,
                                           std::map<std::string, bufferlist>&& bucket_attrs) const;
+  RGWBucketSyncPolicyHandler *alloc_child(std::shared_ptr<const RGWBucketInfo> bucket_info,
+                                          std::shared_ptr<const std::map<std::string, bufferlist> > bucket_attrs) const;
   RGWBucketSyncPolicyHandler *alloc_child(const rgw_bucket& bucket,
                                           std::optional<rgw_sync_policy_info> sync_policy) const;
 
@@ -375,11 +378,11 @@ public:
     return targets;
   }
 
-  const std::optional<RGWBucketInfo>& get_bucket_info() const {
+  const std::shared_ptr<const RGWBucketInfo>& get_bucket_info() const {
     return bucket_info;
   }
 
-  const std::optional<std::map<std::string, bufferlist> >& get_bucket_attrs() const {
+  const std::shared_ptr<const std::map<std::string, bufferlist> >& get_bucket_attrs() const {
     return bucket_attrs;
   }
 
@@ -13,6 +13,7 @@
 
 #include "rgw_op.h"
 #include "rgw_common.h"
+#include "rgw_ascii.h"
 #include "rgw_acl.h"
 #include "rgw_string.h"
 #include "rgw_http_errors.h"
@@ -396,8 +397,8 @@ void req_info::init_meta_info(const DoutPrefixProvider *dpp, bool *found_bad_met
 
   for (const auto& kv: env->get_map()) {
     const char *prefix;
-    const string& header_name = kv.first;
-    const string& val = kv.second;
+    const auto& header_name = kv.first;
+    const auto& val = kv.second;
     for (int prefix_num = 0; (prefix = meta_prefixes[prefix_num].str) != NULL; prefix_num++) {
       int len = meta_prefixes[prefix_num].len;
       const char *p = header_name.c_str();
@@ -810,7 +811,7 @@ int RGWHTTPArgs::parse(const DoutPrefixProvider *dpp)
        end = true;
        fpos = str.size(); 
     }
-    std::string nameval = url_decode(str.substr(pos, fpos - pos), true);
+    std::string nameval = url_decode(std::string_view{str}.substr(pos, fpos - pos), true);
     NameVal nv(std::move(nameval));
     int ret = nv.parse();
     if (ret >= 0) {
@@ -841,6 +842,9 @@ void RGWHTTPArgs::append(const string& name, const string& val)
     sys_val_map[name] = val;
   } else {
     val_map[name] = val;
+    if (auto param = rgw_query_param_lookup(name); param != RGW_QP_MAX) {
+      query_params |= rgw_query_param_bit(param);
+    }
   }
 
 // when sub_resources exclusive by object are added, please remember to update obj_sub_resource in RGWHTTPArgs::exist_obj_excl_sub_resource().
@@ -1652,6 +1656,15 @@ std::string url_decode(const std::string_view& src_str, bool in_query)
   dest_str.reserve(src_str.length() + 1);
 
   for (auto src = std::begin(src_str); src != std::end(src_str); ++src) {
+    // copy the bytes up to the next one that needs decoding in one go
+    const std::string_view rest{&*src, size_t(std::end(src_str) - src)};
+    const size_t plain = in_query ? rgw::ascii::find_first_of(rest, '%', '+')
+                                  : rgw::ascii::find_first_of(rest, '%', '?');
+    if (plain > 0) {
+      dest_str.append(rest.data(), plain);
+      src += plain - 1;
+      continue;
+    }
     if (*src != '%') {
       if (!in_query || *src != '+') {
         if (*src == '?') {
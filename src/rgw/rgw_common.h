@@ -22,6 +22,7 @@
 #include "common/ceph_crypto.h"
 #include "common/random_string.h"
 #include "rgw_acl.h"
+#include "rgw_arena.h"
 #include "rgw_bucket_layout.h"
 #include "rgw_cors.h"
 #include "rgw_iam_policy.h"
@@ -38,6 +39,7 @@
 #include "cls/rgw/cls_rgw_types.h"
 #include "include/rados/librados.hpp"
 #include "rgw_public_access.h"
+#include "rgw_query_param.h"
 #include "common/tracer.h"
 
 namespace ceph {
@@ -325,6 +327,7 @@ class RGWHTTPArgs {
   std::map<std::string, std::string> val_map;
   std::map<std::string, std::string> sys_val_map;
   std::map<std::string, std::string> sub_resources;
+  uint64_t query_params = 0; //< bits of the RGWQueryParams in val_map
   bool has_resp_modifier = false;
   bool admin_subresource_added = false;
  public:
@@ -339,6 +342,7 @@ class RGWHTTPArgs {
     has_resp_modifier = false;
     val_map.clear();
     sub_resources.clear();
+    query_params = 0;
     str = s;
   }
   /** parse the received arguments */
@@ -360,6 +364,13 @@ class RGWHTTPArgs {
   bool exists(const char *name) const {
     return (val_map.find(name) != std::end(val_map));
   }
+  bool exists(RGWQueryParam param) const {
+    return query_params & rgw_query_param_bit(param);
+  }
+  /** Get the bits of the RGWQueryParams present */
+  uint64_t get_query_params() const {
+    return query_params;
+  }
   bool sub_resource_exists(const char *name) const {
     return (sub_resources.find(name) != std::end(sub_resources));
   }
@@ -404,9 +415,12 @@ class RGWHTTPArgs {
   }
 }; // RGWHTTPArgs
 
-const char *rgw_conf_get(const std::map<std::string, std::string, ltstr_nocase>& conf_map, const char *name, const char *def_val);
-int rgw_conf_get_int(const std::map<std::string, std::string, ltstr_nocase>& conf_map, const char *name, int def_val);
-bool rgw_conf_get_bool(const std::map<std::string, std::string, ltstr_nocase>& conf_map, const char *name, bool def_val);
+using rgw_env_map_t =
+  std::pmr::map<std::pmr::string, std::pmr::string, ltstr_nocase_transparent>;
+
+const char *rgw_conf_get(const rgw_env_map_t& conf_map, const char *name, const char *def_val);
+int rgw_conf_get_int(const rgw_env_map_t& conf_map, const char *name, int def_val);
+bool rgw_conf_get_bool(const rgw_env_map_t& conf_map, const char *name, bool def_val);
 
 class RGWEnv;
 
@@ -425,12 +439,16 @@ public:
 };
 
 class RGWEnv {
-  std::map<std::string, std::string, ltstr_nocase> env_map;
+  /* the map gets a node and two strings for every request header, so it
+   * allocates them from an arena that is released with the env at the end
+   * of the request */
+  rgw::RequestArena arena;
+  rgw_env_map_t env_map{&arena};
   RGWConf conf;
 public:
   void init(CephContext *cct);
   void init(CephContext *cct, char **envp);
-  void set(std::string name, std::string val);
+  void set(std::string_view name, std::string_view val);
   const char *get(const char *name, const char *def_val = nullptr) const;
   int get_int(const char *name, int def_val = 0) const;
   bool get_bool(const char *name, bool def_val = 0);
@@ -438,7 +456,7 @@ public:
   bool exists(const char *name) const;
   bool exists_prefix(const char *prefix) const;
   void remove(const char *name);
-  const std::map<std::string, std::string, ltstr_nocase>& get_map() const { return env_map; }
+  const rgw_env_map_t& get_map() const { return env_map; }
   int get_enable_ops_log() const {
     return conf.enable_ops_log;
   }
@@ -16,6 +16,9 @@
 
 #ifndef RGW_DMCLOCK_H
 #define RGW_DMCLOCK_H
+#include <ostream>
+#include <string>
+#include <tuple>
 #include "dmclock/src/dmclock_server.h"
 
 namespace rgw::dmclock {
@@ -28,6 +31,36 @@ enum class client_id {
                       count
 };
 
+/// a dmclock client: the class of a request and, if rgw_dmclock_client_key
+/// asks for it, the tenant or user it came from. an empty name is the one
+/// queue that all requests of that class share
+struct client_key {
+  client_id id;
+  std::string name;
+
+  client_key(client_id id) : id(id) {}
+  client_key(client_id id, std::string name) : id(id), name(std::move(name)) {}
+
+  friend bool operator==(const client_key& l, const client_key& r) {
+    return l.id == r.id && l.name == r.name;
+  }
+  friend bool operator!=(const client_key& l, const client_key& r) {
+    return !(l == r);
+  }
+  friend bool operator<(const client_key& l, const client_key& r) {
+    return std::tie(l.id, l.name) < std::tie(r.id, r.name);
+  }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const client_key& c)
+{
+  out << static_cast<int>(c.id);
+  if (!c.name.empty()) {
+    out << '/' << c.name;
+  }
+  return out;
+}
+
 // TODO move these to dmclock/types or so in submodule
 using crimson::dmclock::Cost;
 using crimson::dmclock::ClientInfo;
@@ -51,4 +84,13 @@ inline scheduler_t get_scheduler_t(CephContext* const cct)
 
 } // namespace rgw::dmclock
 
+namespace std {
+template<>
+struct hash<rgw::dmclock::client_key> {
+  size_t operator()(const rgw::dmclock::client_key& c) const {
+    return hash<string>{}(c.name) ^ static_cast<size_t>(c.id);
+  }
+};
+} // namespace std
+
 #endif /* RGW_DMCLOCK_H */
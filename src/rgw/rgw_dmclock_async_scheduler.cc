@@ -38,7 +38,7 @@ void AsyncScheduler::handle_conf_change(const ConfigProxy& conf,
   schedule(crimson::dmclock::TimeZero);
 }
 
-int AsyncScheduler::schedule_request_impl(const client_id& client,
+int AsyncScheduler::schedule_request_impl(const client_key& client,
                                           const ReqParams& params,
                                           const Time& time, const Cost& cost,
                                           optional_yield yield_ctx)
@@ -73,7 +73,10 @@ void AsyncScheduler::cancel()
   ClientSums sums;
 
   queue.remove_by_req_filter([&] (RequestRef&& request) {
-      inc(sums, request->client, request->cost);
+      inc(sums, request->client.id, request->cost);
+      if (client_stats && !request->client.name.empty()) {
+        client_stats->on_canceled(request->client, 1);
+      }
       auto c = static_cast<Completion*>(request.release());
       Completion::dispatch(std::unique_ptr<Completion>{c},
                            boost::asio::error::operation_aborted,
@@ -89,7 +92,7 @@ void AsyncScheduler::cancel()
   }
 }
 
-void AsyncScheduler::cancel(const client_id& client)
+void AsyncScheduler::cancel(const client_key& client)
 {
   ClientSum sum;
 
@@ -101,9 +104,12 @@ void AsyncScheduler::cancel(const client_id& client)
                            boost::asio::error::operation_aborted,
                            PhaseType::priority);
     });
-  if (auto c = counters(client)) {
+  if (auto c = counters(client.id)) {
     on_cancel(c, sum);
   }
+  if (client_stats && !client.name.empty()) {
+    client_stats->on_canceled(client, sum.count);
+  }
   schedule(crimson::dmclock::TimeZero);
 }
 
@@ -155,16 +161,19 @@ void AsyncScheduler::process(const Time& now)
     Completion::post(std::unique_ptr<Completion>{c},
                      boost::system::error_code{}, phase);
 
-    if (auto c = counters(client)) {
-      auto lat = Clock::from_double(now) - Clock::from_double(started);
+    auto lat = Clock::from_double(now) - Clock::from_double(started);
+    if (auto c = counters(client.id)) {
       if (phase == PhaseType::reservation) {
-        inc(rsums, client, cost);
+        inc(rsums, client.id, cost);
         c->tinc(queue_counters::l_res_latency, lat);
       } else {
-        inc(psums, client, cost);
+        inc(psums, client.id, cost);
         c->tinc(queue_counters::l_prio_latency, lat);
       }
     }
+    if (client_stats && !client.name.empty()) {
+      client_stats->on_dequeued(client, lat);
+    }
   }
 
   if (outstanding_requests >= max_requests) {
@@ -50,7 +50,7 @@ class AsyncScheduler : public md_config_obs_t, public Scheduler {
   /// is ready or canceled. on success, this grants a throttle unit that must
   /// be returned with a call to request_complete()
   template <typename CompletionToken>
-  auto async_request(const client_id& client, const ReqParams& params,
+  auto async_request(const client_key& client, const ReqParams& params,
                      const Time& time, Cost cost, CompletionToken&& token);
 
   /// returns a throttle unit granted by async_request()
@@ -62,19 +62,26 @@ class AsyncScheduler : public md_config_obs_t, public Scheduler {
 
   /// cancel all queued requests for a given client, invoking their completion
   /// handler with an operation_aborted error and default-constructed result
-  void cancel(const client_id& client);
+  void cancel(const client_key& client);
 
   const char** get_tracked_conf_keys() const override;
   void handle_conf_change(const ConfigProxy& conf,
                           const std::set<std::string>& changed) override;
 
+  /// admit named clients through the given table and track their queue
+  /// depth and wait time there. without one, named clients share their
+  /// class's client
+  void set_client_stats(ClientStats *stats) {
+    client_stats = stats;
+  }
+
  private:
-  int schedule_request_impl(const client_id& client, const ReqParams& params,
+  int schedule_request_impl(const client_key& client, const ReqParams& params,
                             const Time& time, const Cost& cost,
                             optional_yield yield_ctx) override;
 
   static constexpr bool IsDelayed = false;
-  using Queue = crimson::dmclock::PullPriorityQueue<client_id, Request, IsDelayed>;
+  using Queue = crimson::dmclock::PullPriorityQueue<client_key, Request, IsDelayed>;
   using RequestRef = typename Queue::RequestRef;
   Queue queue; //< dmclock priority queue
 
@@ -89,6 +96,7 @@ class AsyncScheduler : public md_config_obs_t, public Scheduler {
   CephContext *const cct;
   md_config_obs_t *const observer; //< observer to update ClientInfoFunc
   GetClientCounters counters; //< provides per-client perf counters
+  ClientStats *client_stats = nullptr; //< per named client stats, optional
 
   /// max request throttle
   std::atomic<int64_t> max_requests;
@@ -120,7 +128,7 @@ AsyncScheduler::AsyncScheduler(CephContext *cct, boost::asio::io_context& contex
 }
 
 template <typename CompletionToken>
-auto AsyncScheduler::async_request(const client_id& client,
+auto AsyncScheduler::async_request(const client_key& client,
                               const ReqParams& params,
                               const Time& time, Cost cost,
                               CompletionToken&& token)
@@ -130,27 +138,37 @@ auto AsyncScheduler::async_request(const client_id& client,
   auto ex1 = get_executor();
   auto& handler = init.completion_handler;
 
+  // a named client only gets a queue of its own if the client table has
+  // room for it, which keeps the number of queue clients bounded
+  client_key key = client;
+  if (!key.name.empty() && !(client_stats && client_stats->on_queued(key))) {
+    key.name.clear();
+  }
+
   // allocate the Request and add it to the queue
   auto completion = Completion::create(ex1, std::move(handler),
-                                       Request{client, time, cost});
+                                       Request{key, time, cost});
   // cast to unique_ptr<Request>
   auto req = RequestRef{std::move(completion)};
-  int r = queue.add_request(std::move(req), client, params, time, cost);
+  int r = queue.add_request(std::move(req), key, params, time, cost);
   if (r == 0) {
     // schedule an immediate call to process() on the executor
     schedule(crimson::dmclock::TimeZero);
-    if (auto c = counters(client)) {
+    if (auto c = counters(key.id)) {
       c->inc(queue_counters::l_qlen);
       c->inc(queue_counters::l_cost, cost);
     }
   } else {
+    if (!key.name.empty()) {
+      client_stats->on_canceled(key, 1);
+    }
     // post the error code
     boost::system::error_code ec(r, boost::system::system_category());
     // cast back to Completion
     auto completion = static_cast<Completion*>(req.release());
     async::post(std::unique_ptr<Completion>{completion},
                 ec, PhaseType::priority);
-    if (auto c = counters(client)) {
+    if (auto c = counters(key.id)) {
       c->inc(queue_counters::l_limit);
       c->inc(queue_counters::l_limit_cost, cost);
     }
@@ -195,7 +213,7 @@ public:
   }
 
 private:
-  int schedule_request_impl(const client_id&, const ReqParams&,
+  int schedule_request_impl(const client_key&, const ReqParams&,
                             const Time&, const Cost&,
                             optional_yield) override {
     if (outstanding_requests++ >= max_requests) {
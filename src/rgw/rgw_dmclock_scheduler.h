@@ -33,7 +33,7 @@ using crimson::dmclock::get_time;
 using GetClientCounters = std::function<PerfCounters*(client_id)>;
 
 struct Request {
-  client_id client;
+  client_key client;
   Time started;
   Cost cost;
 };
@@ -68,7 +68,7 @@ using SchedulerCompleter = Completer<std::function<void()>>;
 
 class Scheduler  {
 public:
-  auto schedule_request(const client_id& client, const ReqParams& params,
+  auto schedule_request(const client_key& client, const ReqParams& params,
 			const Time& time, const Cost& cost,
 			optional_yield yield)
   {
@@ -79,7 +79,7 @@ public:
 
   virtual ~Scheduler() {};
 private:
-  virtual int schedule_request_impl(const client_id&, const ReqParams&,
+  virtual int schedule_request_impl(const client_key&, const ReqParams&,
 				    const Time&, const Cost&,
 				    optional_yield) = 0;
 };
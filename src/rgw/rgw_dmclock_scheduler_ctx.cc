@@ -13,6 +13,11 @@
  */
 #include "rgw_dmclock_scheduler_ctx.h"
 
+#include "common/dout.h"
+#include "common/split.h"
+
+#define dout_subsys ceph_subsys_rgw
+
 namespace rgw::dmclock {
 
 ClientConfig::ClientConfig(CephContext *cct)
@@ -20,9 +25,16 @@ ClientConfig::ClientConfig(CephContext *cct)
   update(cct->_conf);
 }
 
-ClientInfo* ClientConfig::operator()(client_id client)
+const ClientInfo* ClientConfig::operator()(const client_key& client) const
 {
-  return &clients[static_cast<size_t>(client)];
+  auto p = std::atomic_load(&infos);
+  if (client.name.empty()) {
+    return &p->clients[static_cast<size_t>(client.id)];
+  }
+  if (auto i = p->overrides.find(client.name); i != p->overrides.end()) {
+    return &p->named_clients[i->second];
+  }
+  return &p->named_clients.front();
 }
 
 const char** ClientConfig::get_tracked_conf_keys() const
@@ -40,15 +52,38 @@ const char** ClientConfig::get_tracked_conf_keys() const
     "rgw_dmclock_metadata_res",
     "rgw_dmclock_metadata_wgt",
     "rgw_dmclock_metadata_lim",
+    "rgw_dmclock_client_res",
+    "rgw_dmclock_client_wgt",
+    "rgw_dmclock_client_lim",
+    "rgw_dmclock_client_overrides",
     "rgw_max_concurrent_requests",
     nullptr
   };
   return keys;
 }
 
+// parse "name=res:wgt:lim" into the name and its ClientInfo
+static std::optional<std::pair<std::string, ClientInfo>>
+parse_client_override(std::string_view s)
+{
+  auto eq = s.find('=');
+  if (eq == 0 || eq == s.npos) {
+    return std::nullopt;
+  }
+  std::string name{s.substr(0, eq)};
+  std::string params{s.substr(eq + 1)};
+  double res = 0, wgt = 0, lim = 0;
+  char extra;
+  if (sscanf(params.c_str(), "%lf:%lf:%lf%c", &res, &wgt, &lim, &extra) != 3) {
+    return std::nullopt;
+  }
+  return std::make_pair(std::move(name), ClientInfo{res, wgt, lim});
+}
+
 void ClientConfig::update(const ConfigProxy& conf)
 {
-  clients.clear();
+  auto p = std::make_shared<Infos>();
+  auto& clients = p->clients;
   static_assert(0 == static_cast<int>(client_id::admin));
   clients.emplace_back(conf.get_val<double>("rgw_dmclock_admin_res"),
                        conf.get_val<double>("rgw_dmclock_admin_wgt"),
@@ -65,6 +100,26 @@ void ClientConfig::update(const ConfigProxy& conf)
   clients.emplace_back(conf.get_val<double>("rgw_dmclock_metadata_res"),
                        conf.get_val<double>("rgw_dmclock_metadata_wgt"),
                        conf.get_val<double>("rgw_dmclock_metadata_lim"));
+
+  p->named_clients.emplace_back(conf.get_val<double>("rgw_dmclock_client_res"),
+                                conf.get_val<double>("rgw_dmclock_client_wgt"),
+                                conf.get_val<double>("rgw_dmclock_client_lim"));
+  const auto str = conf.get_val<std::string>("rgw_dmclock_client_overrides");
+  for (const auto& entry : ceph::split(str, ", ")) {
+    auto o = parse_client_override(entry);
+    if (!o) {
+      continue;
+    }
+    auto [i, inserted] = p->overrides.emplace(o->first,
+                                              p->named_clients.size());
+    if (inserted) {
+      p->named_clients.push_back(o->second);
+    } else {
+      p->named_clients[i->second] = o->second;
+    }
+  }
+
+  retired = std::atomic_exchange(&infos, std::shared_ptr<const Infos>{std::move(p)});
 }
 
 void ClientConfig::handle_conf_change(const ConfigProxy& conf,
@@ -73,6 +128,107 @@ void ClientConfig::handle_conf_change(const ConfigProxy& conf,
   update(conf);
 }
 
+ClientStats::ClientStats(CephContext *cct)
+  : cct(cct),
+    evict_age([cct] {
+      const auto idle_age = cct->_conf.get_val<std::chrono::seconds>(
+          "rgw_dmclock_client_idle_age");
+      return ceph::timespan{idle_age + client_check_time(idle_age)};
+    }())
+{
+  int r = cct->get_admin_socket()->register_command(
+      "dmclock clients", this,
+      "show queue depth and wait time of each dmclock client");
+  if (r < 0) {
+    lderr(cct) << "ERROR: failed to register admin socket command "
+        "'dmclock clients' (r=" << r << ")" << dendl;
+  }
+}
+
+ClientStats::~ClientStats()
+{
+  cct->get_admin_socket()->unregister_commands(this);
+}
+
+auto ClientStats::get(const client_key& client, ceph::coarse_mono_time now)
+  -> Stats*
+{
+  if (auto i = clients.find(client); i != clients.end()) {
+    i->second.last_seen = now;
+    return &i->second;
+  }
+  const auto max_clients = cct->_conf.get_val<uint64_t>("rgw_dmclock_max_clients");
+  if (clients.size() >= max_clients) {
+    for (auto i = clients.begin(); i != clients.end();) {
+      if (i->second.qlen == 0 && now - i->second.last_seen > evict_age) {
+        i = clients.erase(i);
+      } else {
+        ++i;
+      }
+    }
+    if (clients.size() >= max_clients) {
+      return nullptr;
+    }
+  }
+  auto& stats = clients[client];
+  stats.last_seen = now;
+  return &stats;
+}
+
+bool ClientStats::on_queued(const client_key& client)
+{
+  std::lock_guard l{lock};
+  auto s = get(client, ceph::coarse_mono_clock::now());
+  if (!s) {
+    return false;
+  }
+  ++s->qlen;
+  return true;
+}
+
+void ClientStats::on_dequeued(const client_key& client, ceph::timespan wait)
+{
+  std::lock_guard l{lock};
+  if (auto i = clients.find(client); i != clients.end()) {
+    auto& s = i->second;
+    if (s.qlen > 0) {
+      --s.qlen;
+    }
+    ++s.count;
+    s.wait += wait;
+    s.last_seen = ceph::coarse_mono_clock::now();
+  }
+}
+
+void ClientStats::on_canceled(const client_key& client, uint64_t count)
+{
+  std::lock_guard l{lock};
+  if (auto i = clients.find(client); i != clients.end()) {
+    auto& s = i->second;
+    s.qlen -= std::min(s.qlen, count);
+  }
+}
+
+int ClientStats::call(std::string_view command, const cmdmap_t& cmdmap,
+                      ceph::Formatter *f, std::ostream& errss,
+                      ceph::buffer::list& out)
+{
+  std::lock_guard l{lock};
+  f->open_array_section("clients");
+  for (const auto& [client, s] : clients) {
+    f->open_object_section("client");
+    f->dump_int("class", static_cast<int>(client.id));
+    f->dump_string("name", client.name);
+    f->dump_unsigned("qlen", s.qlen);
+    f->dump_unsigned("requests", s.count);
+    f->dump_float("avg_wait", s.count ?
+                  std::chrono::duration<double>(s.wait).count() / s.count : 0);
+    f->close_section();
+  }
+  f->close_section();
+  return 0;
+}
+
 ClientCounters::ClientCounters(CephContext *cct)
 {
   clients[static_cast<size_t>(client_id::admin)] =
@@ -4,6 +4,14 @@
 #ifndef RGW_DMCLOCK_SCHEDULER_CTX_H
 #define RGW_DMCLOCK_SCHEDULER_CTX_H
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+#include "common/admin_socket.h"
+#include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "common/perf_counters.h"
 #include "common/ceph_context.h"
 #include "common/config.h"
@@ -84,20 +92,79 @@ void on_process(PerfCounters* c, const ClientSum& rsum, const ClientSum& psum);
 
 
 class ClientConfig : public md_config_obs_t {
-  std::vector<ClientInfo> clients;
+  /// what update() computes from the config. each update publishes a new
+  /// Infos instead of changing the current one, so the queue never reads a
+  /// ClientInfo while it is being written
+  struct Infos {
+    std::vector<ClientInfo> clients;
+    /// ClientInfo for named clients: the rgw_dmclock_client_* defaults
+    /// first, then one per rgw_dmclock_client_overrides entry
+    std::vector<ClientInfo> named_clients;
+    std::map<std::string, size_t, std::less<>> overrides;
+  };
+  /// accessed with std::atomic_load/atomic_store
+  std::shared_ptr<const Infos> infos;
+  /// the Infos replaced by the last update. the queue holds pointers into
+  /// it until the scheduler calls update_client_infos() right after
+  /// update(), so it is kept until the next update
+  std::shared_ptr<const Infos> retired;
 
   void update(const ConfigProxy &conf);
 
 public:
   ClientConfig(CephContext *cct);
 
-  ClientInfo* operator()(client_id client);
+  const ClientInfo* operator()(const client_key& client) const;
 
   const char** get_tracked_conf_keys() const override;
   void handle_conf_change(const ConfigProxy& conf,
                           const std::set<std::string>& changed) override;
 };
 
+/// how often the dmclock queue looks for named clients that have been idle
+/// for rgw_dmclock_client_idle_age and erases them
+inline std::chrono::seconds client_check_time(std::chrono::seconds idle_age)
+{
+  return std::max(std::chrono::seconds(1), idle_age / 4);
+}
+
+/// the named clients admitted to the dmclock queue, with their queue depth
+/// and wait time, dumped by the 'dmclock clients' admin socket command.
+/// at most rgw_dmclock_max_clients names are admitted at a time; requests
+/// of any other name share their class's client. a name is only dropped
+/// once it has had nothing queued for long enough that the queue has
+/// erased its client as well, so the queue never holds more named clients
+/// than this table
+class ClientStats : public AdminSocketHook {
+  struct Stats {
+    uint64_t qlen = 0;
+    uint64_t count = 0;
+    ceph::timespan wait = ceph::timespan::zero();
+    ceph::coarse_mono_time last_seen;
+  };
+  CephContext *const cct;
+  /// rgw_dmclock_client_idle_age plus one queue cleaning interval
+  const ceph::timespan evict_age;
+  mutable ceph::mutex lock = ceph::make_mutex("rgw::dmclock::ClientStats");
+  std::map<client_key, Stats> clients;
+
+  Stats* get(const client_key& client, ceph::coarse_mono_time now);
+
+public:
+  ClientStats(CephContext *cct);
+  ~ClientStats();
+
+  /// admit a request of a named client. false if the table is full, in
+  /// which case the request has to go to its class's shared client
+  bool on_queued(const client_key& client);
+  void on_dequeued(const client_key& client, ceph::timespan wait);
+  void on_canceled(const client_key& client, uint64_t count);
+
+  int call(std::string_view command, const cmdmap_t& cmdmap,
+           ceph::Formatter *f, std::ostream& errss,
+           ceph::buffer::list& out) override;
+};
+
 class SchedulerCtx {
 public:
   SchedulerCtx(CephContext* const cct) : sched_t(get_scheduler_t(cct))
@@ -106,15 +173,18 @@ public:
       dmc_client_config = std::make_shared<ClientConfig>(cct);
       // we don't have a move only cref std::function yet
       dmc_client_counters = std::make_optional<ClientCounters>(cct);
+      dmc_client_stats = std::make_unique<ClientStats>(cct);
     }
   }
   // We need to construct a std::function from a NonCopyable object
   ClientCounters& get_dmc_client_counters() { return dmc_client_counters.value(); }
   ClientConfig* const get_dmc_client_config() const { return dmc_client_config.get(); }
+  ClientStats* get_dmc_client_stats() const { return dmc_client_stats.get(); }
 private:
   scheduler_t sched_t;
   std::shared_ptr<ClientConfig> dmc_client_config {nullptr};
   std::optional<ClientCounters> dmc_client_counters  {std::nullopt};
+  std::unique_ptr<ClientStats> dmc_client_stats;
 };
 
 } // namespace rgw::dmclock
@@ -12,7 +12,7 @@ SyncScheduler::~SyncScheduler()
   cancel();
 }
 
-int SyncScheduler::add_request(const client_id& client, const ReqParams& params,
+int SyncScheduler::add_request(const client_key& client, const ReqParams& params,
                                const Time& time, Cost cost)
 {
   std::mutex req_mtx;
@@ -21,7 +21,7 @@ int SyncScheduler::add_request(const client_id& client, const ReqParams& params,
   auto req = SyncRequest{client, time, cost, req_mtx, req_cv, rstate, counters};
   int r = queue.add_request_time(req, client, params, time, cost);
   if (r == 0) {
-    if (auto c = counters(client)) {
+    if (auto c = counters(client.id)) {
       c->inc(queue_counters::l_qlen);
       c->inc(queue_counters::l_cost, cost);
     }
@@ -37,7 +37,7 @@ int SyncScheduler::add_request(const client_id& client, const ReqParams& params,
     }
   } else {
       // post the error code
-    if (auto c = counters(client)) {
+    if (auto c = counters(client.id)) {
       c->inc(queue_counters::l_limit);
       c->inc(queue_counters::l_limit_cost, cost);
     }
@@ -45,7 +45,7 @@ int SyncScheduler::add_request(const client_id& client, const ReqParams& params,
   return r;
 }
 
-void SyncScheduler::handle_request_cb(const client_id &c,
+void SyncScheduler::handle_request_cb(const client_key &c,
                                       std::unique_ptr<SyncRequest> req,
                                       PhaseType phase, Cost cost)
 {
@@ -54,7 +54,7 @@ void SyncScheduler::handle_request_cb(const client_id &c,
     req->req_cv.notify_one();
   }
 
-  if (auto ctr = req->counters(c)) {
+  if (auto ctr = req->counters(c.id)) {
     auto lat = Clock::from_double(get_time()) - Clock::from_double(req->started);
     if (phase == PhaseType::reservation){
       ctr->tinc(queue_counters::l_res_latency, lat);
@@ -71,7 +71,7 @@ void SyncScheduler::handle_request_cb(const client_id &c,
 }
 
 
-void SyncScheduler::cancel(const client_id& client)
+void SyncScheduler::cancel(const client_key& client)
 {
   ClientSum sum;
 
@@ -85,7 +85,7 @@ void SyncScheduler::cancel(const client_id& client)
         request->req_cv.notify_one();
       }
     });
-  if (auto c = counters(client)) {
+  if (auto c = counters(client.id)) {
     on_cancel(c, sum);
   }
 
@@ -98,7 +98,7 @@ void SyncScheduler::cancel()
 
   queue.remove_by_req_filter([&](RequestRef&& request) -> bool
            {
-             inc(sums, request->client, request->cost);
+             inc(sums, request->client.id, request->cost);
              {
                std::lock_guard<std::mutex> lg(request->req_mtx);
                request->req_state = ReqState::Cancelled;
@@ -26,7 +26,7 @@ struct SyncRequest : public Request {
   std::condition_variable& req_cv;
   ReqState& req_state;
   GetClientCounters& counters;
-  explicit SyncRequest(client_id _id, Time started, Cost cost,
+  explicit SyncRequest(const client_key& _id, Time started, Cost cost,
                        std::mutex& mtx, std::condition_variable& _cv,
                        ReqState& _state, GetClientCounters& counters):
     Request{_id, started, cost}, req_mtx(mtx), req_cv(_cv), req_state(_state), counters(counters) {};
@@ -41,18 +41,18 @@ public:
 
   // submit a blocking request for dmclock scheduling, this function waits until
   // the request is ready.
-  int add_request(const client_id& client, const ReqParams& params,
+  int add_request(const client_key& client, const ReqParams& params,
 		  const Time& time, Cost cost);
 
 
   void cancel();
 
-  void cancel(const client_id& client);
+  void cancel(const client_key& client);
 
-  static void handle_request_cb(const client_id& c, std::unique_ptr<SyncRequest> req,
+  static void handle_request_cb(const client_key& c, std::unique_ptr<SyncRequest> req,
 				PhaseType phase, Cost cost);
 private:
-  int schedule_request_impl(const client_id& client, const ReqParams& params,
+  int schedule_request_impl(const client_key& client, const ReqParams& params,
 			    const Time& time, const Cost& cost,
 			    optional_yield _y [[maybe_unused]]) override
   {
@@ -60,7 +60,7 @@ private:
   }
 
   static constexpr bool IsDelayed = false;
-  using Queue = crimson::dmclock::PushPriorityQueue<client_id, SyncRequest, IsDelayed>;
+  using Queue = crimson::dmclock::PushPriorityQueue<client_key, SyncRequest, IsDelayed>;
   using RequestRef = typename Queue::RequestRef;
   using Clock = ceph::coarse_real_clock;
 
@@ -19,9 +19,15 @@ void RGWEnv::init(CephContext *cct)
   conf.init(cct);
 }
 
-void RGWEnv::set(std::string name, std::string val)
+void RGWEnv::set(std::string_view name, std::string_view val)
 {
-  env_map[std::move(name)] = std::move(val);
+  // the key and value are built with the map's allocator
+  auto iter = env_map.find(name);
+  if (iter == env_map.end()) {
+    env_map.emplace(name, val);
+  } else {
+    iter->second.assign(val);
+  }
 }
 
 void RGWEnv::init(CephContext *cct, char **envp)
@@ -31,19 +37,17 @@ void RGWEnv::init(CephContext *cct, char **envp)
   env_map.clear();
 
   for (int i=0; (p = envp[i]); ++i) {
-    string s(p);
-    int pos = s.find('=');
-    if (pos <= 0) // should never be 0
+    std::string_view s(p);
+    auto pos = s.find('=');
+    if (pos == s.npos || pos == 0) // should never be 0
       continue;
-    string name = s.substr(0, pos);
-    string val = s.substr(pos + 1);
-    env_map[name] = val;
+    set(s.substr(0, pos), s.substr(pos + 1));
   }
 
   init(cct);
 }
 
-const char *rgw_conf_get(const map<string, string, ltstr_nocase>& conf_map, const char *name, const char *def_val)
+const char *rgw_conf_get(const rgw_env_map_t& conf_map, const char *name, const char *def_val)
 {
   auto iter = conf_map.find(name);
   if (iter == conf_map.end())
@@ -57,7 +61,7 @@ const char *RGWEnv::get(const char *name, const char *def_val) const
   return rgw_conf_get(env_map, name, def_val);
 }
 
-int rgw_conf_get_int(const map<string, string, ltstr_nocase>& conf_map, const char *name, int def_val)
+int rgw_conf_get_int(const rgw_env_map_t& conf_map, const char *name, int def_val)
 {
   auto iter = conf_map.find(name);
   if (iter == conf_map.end())
@@ -72,7 +76,7 @@ int RGWEnv::get_int(const char *name, int def_val) const
   return rgw_conf_get_int(env_map, name, def_val);
 }
 
-bool rgw_conf_get_bool(const map<string, string, ltstr_nocase>& conf_map, const char *name, bool def_val)
+bool rgw_conf_get_bool(const rgw_env_map_t& conf_map, const char *name, bool def_val)
 {
   auto iter = conf_map.find(name);
   if (iter == conf_map.end())
@@ -95,7 +99,7 @@ size_t RGWEnv::get_size(const char *name, size_t def_val) const
 
   size_t sz;
   try{
-    sz = stoull(iter->second);
+    sz = stoull(std::string(iter->second));
   } catch(...){
     /* it is very unlikely that we'll ever encounter out_of_range, but let's
        return the default eitherway */
@@ -124,7 +128,7 @@ bool RGWEnv::exists_prefix(const char *prefix) const
 
 void RGWEnv::remove(const char *name)
 {
-  map<string, string, ltstr_nocase>::iterator iter = env_map.find(name);
+  auto iter = env_map.find(name);
   if (iter != env_map.end())
     env_map.erase(iter);
 }
@@ -593,9 +593,11 @@ int rgw_log_op(RGWREST* const rest, struct req_state *s, const string& op_name,
   if (rest) {
     if (rest->log_x_headers()) {
       for (const auto& iter : s->info.env->get_map()) {
-	if (rest->log_x_header(iter.first)) {
+	std::string name{iter.first};
+	if (rest->log_x_header(name)) {
 	  entry.x_headers.insert(
-	    rgw_log_entry::headers_map::value_type(iter.first, iter.second));
+	    rgw_log_entry::headers_map::value_type(std::move(name),
+						   std::string{iter.second}));
 	}
       }
     }
@@ -171,7 +171,9 @@ bs::error_code log_remove(const DoutPrefixProvider *dpp,
 				      0, y, true);
     if (r == -ENOENT) continue;
     if (r == 0 && info.head_part_num > -1) {
-      for (auto j = info.tail_part_num; j <= info.head_part_num; ++j) {
+      // Parts past the head may have been preallocated by a pusher.
+      auto last = std::max(info.head_part_num, info.max_push_part_num);
+      for (auto j = info.tail_part_num; j <= last; ++j) {
 	librados::ObjectWriteOperation op;
 	op.remove();
 	auto part_oid = info.part_oid(j);
@@ -51,6 +51,7 @@
 #endif
 #include "rgw_asio_frontend.h"
 #include "rgw_dmclock_scheduler_ctx.h"
+#include "rgw_ratelimit.h"
 #ifdef WITH_RADOSGW_LUA_PACKAGES
 #include "rgw_lua.h"
 #endif
@@ -359,6 +360,14 @@ int radosgw_Main(int argc, const char **argv)
   }
 #endif
 
+  // start the perf counters first, so the startup phases can be timed
+  r = rgw_perf_start(g_ceph_context);
+  if (r < 0) {
+    derr << "ERROR: failed starting rgw perf" << dendl;
+    return -r;
+  }
+  RGWStartupPhase startup_phase(&dp, l_rgw_startup_total, "total");
+
   rgw::sal::Store* store =
     StoreManager::get_storage(&dp, g_ceph_context,
 				 rgw_store,
@@ -377,11 +386,6 @@ int radosgw_Main(int argc, const char **argv)
     derr << "Couldn't init storage provider (RADOS)" << dendl;
     return EIO;
   }
-  r = rgw_perf_start(g_ceph_context);
-  if (r < 0) {
-    derr << "ERROR: failed starting rgw perf" << dendl;
-    return -r;
-  }
 
   rgw_rest_init(g_ceph_context, store->get_zone()->get_zonegroup());
 
@@ -534,6 +538,7 @@ int radosgw_Main(int argc, const char **argv)
   }
 
   rgw::dmclock::SchedulerCtx sched_ctx{cct.get()};
+  rgw::RateLimiter ratelimiter{cct.get()};
 
   OpsLogManifold *olog = new OpsLogManifold();
   if (!g_conf()->rgw_ops_log_socket_path.empty()) {
@@ -585,6 +590,7 @@ int radosgw_Main(int argc, const char **argv)
 
   int fe_count = 0;
 
+  RGWStartupPhase frontends_phase(&dp, l_rgw_startup_frontends, "frontends");
   for (multimap<string, RGWFrontendConfig *>::iterator fiter = fe_map.begin();
        fiter != fe_map.end(); ++fiter, ++fe_count) {
     RGWFrontendConfig *config = fiter->second;
@@ -612,7 +618,8 @@ int radosgw_Main(int argc, const char **argv)
       config->get_val("port", 80, &port);
       std::string uri_prefix;
       config->get_val("prefix", "", &uri_prefix);
-      RGWProcessEnv env{ store, &rest, olog, port, uri_prefix, auth_registry };
+      RGWProcessEnv env{ store, &rest, olog, port, uri_prefix, auth_registry,
+                         &ratelimiter };
       fe = new RGWAsioFrontend(env, config, sched_ctx);
     }
 
@@ -638,6 +645,8 @@ int radosgw_Main(int argc, const char **argv)
 
     fes.push_back(fe);
   }
+  frontends_phase.finish();
+  startup_phase.finish();
 
   r = store->register_to_service_map(&dp, "rgw", service_map_meta);
   if (r < 0) {
@@ -657,6 +666,11 @@ int radosgw_Main(int argc, const char **argv)
   realm_watcher.add_watcher(RGWRealmNotify::Reload, *reloader);
   realm_watcher.add_watcher(RGWRealmNotify::ZonesNeedPeriod, pusher);
 
+  // share rate limit consumption with the other gateways of the zone
+  rgw::RateLimitSync ratelimit_sync(&dp, g_ceph_context, ratelimiter,
+                                    store->get_zone()->get_params().log_pool,
+                                    store->get_zone()->get_id().id);
+
 #if defined(HAVE_SYS_PRCTL_H)
   if (prctl(PR_SET_DUMPABLE, 1) == -1) {
     cerr << "warning: unable to set dumpable flag: " << cpp_strerror(errno) << std::endl;
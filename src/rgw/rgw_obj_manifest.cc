@@ -3,6 +3,8 @@
 
 #include "rgw_obj_manifest.h"
 
+#include "include/scope_guard.h"
+
 #include "services/svc_zone.h"
 #include "services/svc_tier_rados.h"
 #include "rgw_rados.h" // RGW_OBJ_NS_SHADOW and RGW_OBJ_NS_MULTIPART
@@ -45,6 +47,8 @@ int RGWObjManifest::generator::create_next(uint64_t ofs)
 int RGWObjManifest::append(const DoutPrefixProvider *dpp, RGWObjManifest& m, const RGWZoneGroup& zonegroup,
                            const RGWZoneParams& zone_params)
 {
+  auto reindex = make_scope_guard([this] { update_index(); });
+
   if (explicit_objs || m.explicit_objs) {
     return append_explicit(dpp, m, zonegroup, zone_params);
   }
@@ -166,6 +170,7 @@ void RGWObjManifest::convert_to_explicit(const DoutPrefixProvider *dpp, const RG
   explicit_objs = true;
   rules.clear();
   prefix.clear();
+  update_index();
 }
 
 int RGWObjManifest::append_explicit(const DoutPrefixProvider *dpp, RGWObjManifest& m, const RGWZoneGroup& zonegroup, const RGWZoneParams& zone_params)
@@ -193,7 +198,7 @@ bool RGWObjManifest::get_rule(uint64_t ofs, RGWObjManifestRule *rule)
     return false;
   }
 
-  map<uint64_t, RGWObjManifestRule>::iterator iter = rules.upper_bound(ofs);
+  auto iter = rules_index.upper_bound(rules, ofs);
   if (iter != rules.begin()) {
     --iter;
   }
@@ -352,7 +357,7 @@ void RGWObjManifest::obj_iterator::seek(uint64_t o)
 {
   ofs = o;
   if (manifest->explicit_objs) {
-    explicit_iter = manifest->objs.upper_bound(ofs);
+    explicit_iter = manifest->objs_index.upper_bound(manifest->objs, ofs);
     if (explicit_iter != manifest->objs.begin()) {
       --explicit_iter;
     }
@@ -376,7 +381,7 @@ void RGWObjManifest::obj_iterator::seek(uint64_t o)
     return;
   }
 
-  rule_iter = manifest->rules.upper_bound(ofs);
+  rule_iter = manifest->rules_index.upper_bound(manifest->rules, ofs);
   next_rule_iter = rule_iter;
   if (rule_iter != manifest->rules.begin()) {
     --rule_iter;
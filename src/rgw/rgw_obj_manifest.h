@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "rgw_common.h"
 #include "rgw_compression_types.h"
 #include "rgw_sal.h"
@@ -174,6 +177,50 @@ struct RGWObjTier {
 };
 WRITE_CLASS_ENCODER(RGWObjTier)
 
+/*
+ * the keys of a large offset map in a flat array, so that finding the entry
+ * covering an offset is a binary search over contiguous memory instead of a
+ * walk down the tree. must be rebuilt whenever the map changes.
+ */
+template <typename Map>
+class RGWOffsetIndex {
+  static constexpr size_t min_size = 64; /* a tree this small is fast enough */
+
+  std::vector<uint64_t> keys;
+  std::vector<typename Map::const_iterator> iters;
+
+public:
+  void build(const Map& m) {
+    clear();
+    if (m.size() < min_size) {
+      return;
+    }
+    keys.reserve(m.size());
+    iters.reserve(m.size());
+    for (auto i = m.begin(); i != m.end(); ++i) {
+      keys.push_back(i->first);
+      iters.push_back(i);
+    }
+  }
+
+  void clear() {
+    keys = {};
+    iters = {};
+  }
+
+  /* same as m.upper_bound(ofs), m being the map the index was built from */
+  typename Map::const_iterator upper_bound(const Map& m, uint64_t ofs) const {
+    if (keys.empty()) {
+      return m.upper_bound(ofs);
+    }
+    auto k = std::upper_bound(keys.begin(), keys.end(), ofs);
+    if (k == keys.end()) {
+      return m.end();
+    }
+    return iters[k - keys.begin()];
+  }
+};
+
 class RGWObjManifest {
 protected:
   bool explicit_objs{false}; /* really old manifest? */
@@ -196,6 +243,16 @@ protected:
   std::string tier_type;
   RGWObjTier tier_config;
 
+  /* built once a manifest is decoded, so that range reads deep into objects
+   * of thousands of parts seek in O(log n) without chasing tree nodes */
+  RGWOffsetIndex<std::map<uint64_t, RGWObjManifestPart>> objs_index;
+  RGWOffsetIndex<std::map<uint64_t, RGWObjManifestRule>> rules_index;
+
+  void update_index() {
+    objs_index.build(objs);
+    rules_index.build(rules);
+  }
+
   void convert_to_explicit(const DoutPrefixProvider *dpp, const RGWZoneGroup& zonegroup, const RGWZoneParams& zone_params);
   int append_explicit(const DoutPrefixProvider *dpp, RGWObjManifest& m, const RGWZoneGroup& zonegroup, const RGWZoneParams& zone_params);
   void append_rules(RGWObjManifest& m, std::map<uint64_t, RGWObjManifestRule>::iterator& iter, std::string *override_prefix);
@@ -219,6 +276,7 @@ public:
     tail_instance = rhs.tail_instance;
     tier_type = rhs.tier_type;
     tier_config = rhs.tier_config;
+    update_index();
     return *this;
   }
 
@@ -231,6 +289,7 @@ public:
     explicit_objs = true;
     objs.swap(_objs);
     set_obj_size(_size);
+    update_index();
   }
 
   void get_implicit_location(uint64_t cur_part_id, uint64_t cur_stripe, uint64_t ofs,
@@ -240,6 +299,7 @@ public:
     RGWObjManifestRule rule(0, tail_ofs, 0, stripe_max_size);
     rules[0] = rule;
     max_head_size = tail_ofs;
+    rules_index.build(rules);
   }
 
   void set_multipart_part_rule(uint64_t stripe_max_size, uint64_t part_num) {
@@ -247,6 +307,7 @@ public:
     rule.start_part_num = part_num;
     rules[0] = rule;
     max_head_size = 0;
+    rules_index.build(rules);
   }
 
   void encode(bufferlist& bl) const {
@@ -277,6 +338,8 @@ public:
   }
 
   void decode(bufferlist::const_iterator& bl) {
+    objs_index.clear();
+    rules_index.clear();
     DECODE_START_LEGACY_COMPAT_LEN_32(7, 2, 2, bl);
     decode(obj_size, bl);
     decode(objs, bl);
@@ -351,6 +414,7 @@ public:
     }
 
     DECODE_FINISH(bl);
+    update_index();
   }
 
   void dump(Formatter *f) const;
@@ -390,8 +454,12 @@ public:
     head_size = _s;
 
     if (explicit_objs && head_size > 0) {
-      objs[0].loc = obj;
-      objs[0].size = head_size;
+      auto [i, inserted] = objs.try_emplace(0);
+      i->second.loc = obj;
+      i->second.size = head_size;
+      if (inserted) {
+        objs_index.build(objs);
+      }
     }
   }
 
@@ -884,16 +884,11 @@ void rgw_build_iam_environment(rgw::sal::Store* store,
     i = m.find("REMOTE_ADDR");
   }
   if (i != m.end()) {
-    const string* ip = &(i->second);
-    string temp;
+    std::string_view ip = i->second;
     if (remote_addr_param == "HTTP_X_FORWARDED_FOR") {
-      const auto comma = ip->find(',');
-      if (comma != string::npos) {
-	temp.assign(*ip, 0, comma);
-	ip = &temp;
-      }
+      ip = ip.substr(0, ip.find(','));
     }
-    s->env.emplace("aws:SourceIp", *ip);
+    s->env.emplace("aws:SourceIp", ip);
   }
 
   i = m.find("HTTP_USER_AGENT"); {
@@ -2445,6 +2440,7 @@ send_end:
     send_response_begin(false);
   }
   send_response_end();
+  perfcounter->tinc(l_rgw_list_buckets_lat, s->time_elapsed());
 }
 
 void RGWGetUsage::execute(optional_yield y)
@@ -2573,6 +2569,8 @@ void RGWStatAccount::execute(optional_yield y)
     }
     marker = *lastmarker;
   } while (buckets.is_truncated());
+
+  perfcounter->tinc(l_rgw_stat_account_lat, s->time_elapsed());
 }
 
 int RGWGetBucketVersioning::verify_permission(optional_yield y)
@@ -6822,6 +6820,10 @@ void RGWDeleteMultiObj::execute(optional_yield y)
         ++iter) {
     std::string version_id;
     std::unique_ptr<rgw::sal::Object> obj = bucket->get_object(*iter);
+    // don't let the object context grow with the number of keys deleted
+    auto release_state = make_scope_guard([obj_ctx, o = obj->get_obj()] {
+      obj_ctx->release(o);
+    });
     if (s->iam_policy || ! s->iam_user_policies.empty() || !s->session_policies.empty()) {
       auto identity_policy_res = eval_identity_or_session_policies(s->iam_user_policies, s->env,
                                               iter->instance.empty() ?
@@ -7027,6 +7029,7 @@ bool RGWBulkDelete::Deleter::delete_single(const acct_path_t& path, optional_yie
     del_op->params.bucket_owner = bucket_owner;
 
     ret = del_op->delete_obj(dpp, y);
+    static_cast<RGWObjectCtx*>(s->obj_ctx)->release(obj->get_obj());
     if (ret < 0) {
       goto delop_fail;
     }
@@ -4,6 +4,9 @@
 #include "rgw_perf_counters.h"
 #include "common/perf_counters.h"
 #include "common/ceph_context.h"
+#include "common/dout.h"
+
+#define dout_subsys ceph_subsys_rgw
 
 PerfCounters *perfcounter = NULL;
 
@@ -59,12 +62,43 @@ int rgw_perf_start(CephContext *cct)
   plb.add_u64_counter(l_rgw_pubsub_push_failed, "pubsub_push_failed", "Pubsub events failed to be pushed to an endpoint");
   plb.add_u64(l_rgw_pubsub_push_pending, "pubsub_push_pending", "Pubsub events pending reply from endpoint");
   plb.add_u64_counter(l_rgw_pubsub_missing_conf, "pubsub_missing_conf", "Pubsub events could not be handled because of missing configuration");
+
+  plb.add_u64_counter(l_rgw_ec_write_aligned, "ec_write_aligned", "Data writes to erasure coded pools starting on a stripe boundary");
+  plb.add_u64_counter(l_rgw_ec_write_unaligned, "ec_write_unaligned", "Data writes to erasure coded pools needing a partial stripe read-modify-write");
+
+  plb.add_u64_counter(l_rgw_ratelimit_user, "ratelimit_user", "Requests rejected by a per-user rate limit");
+  plb.add_u64_counter(l_rgw_ratelimit_bucket, "ratelimit_bucket", "Requests rejected by a per-bucket rate limit");
+
+  plb.add_time(l_rgw_startup_services, "startup_services", "Time to start the RADOS services at startup");
+  plb.add_time(l_rgw_startup_ctl, "startup_ctl", "Time to initialize the metadata controllers at startup");
+  plb.add_time(l_rgw_startup_init, "startup_init", "Time to open pools and start background work at startup");
+  plb.add_time(l_rgw_startup_sync, "startup_sync", "Time to start the multisite sync threads");
+  plb.add_time(l_rgw_startup_frontends, "startup_frontends", "Time to start the frontends");
+  plb.add_time(l_rgw_startup_total, "startup_total", "Time until the frontends were started");
+  plb.add_u64_counter(l_rgw_sync_init_errors, "sync_init_errors", "Failed attempts to start the multisite sync threads in the background");
+
+  plb.add_time_avg(l_rgw_list_buckets_lat, "list_buckets_lat", "Latency of listing a user's buckets");
+  plb.add_time_avg(l_rgw_stat_account_lat, "stat_account_lat", "Latency of account stats (Swift account HEAD)");
+  plb.add_u64_counter(l_rgw_bucket_stats_cached, "bucket_stats_cached", "Bucket stats taken from the user's bucket list instead of the bucket index");
   
   perfcounter = plb.create_perf_counters();
   cct->get_perfcounters_collection()->add(perfcounter);
   return 0;
 }
 
+void RGWStartupPhase::finish()
+{
+  if (finished) {
+    return;
+  }
+  finished = true;
+  const auto elapsed = ceph::mono_clock::now() - start;
+  ldpp_dout(dpp, 1) << "startup phase " << name << " took " << elapsed << dendl;
+  if (perfcounter) {
+    perfcounter->tinc(counter, elapsed);
+  }
+}
+
 void rgw_perf_stop(CephContext *cct)
 {
   ceph_assert(perfcounter);
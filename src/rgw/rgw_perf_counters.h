@@ -3,6 +3,9 @@
 
 #pragma once
 #include "include/common_fwd.h"
+#include "common/ceph_time.h"
+
+class DoutPrefixProvider;
 
 extern PerfCounters *perfcounter;
 
@@ -50,6 +53,43 @@ enum {
   l_rgw_pubsub_push_pending,
   l_rgw_pubsub_missing_conf,
 
+  l_rgw_ec_write_aligned,
+  l_rgw_ec_write_unaligned,
+
+  l_rgw_ratelimit_user,
+  l_rgw_ratelimit_bucket,
+
+  l_rgw_startup_services,
+  l_rgw_startup_ctl,
+  l_rgw_startup_init,
+  l_rgw_startup_sync,
+  l_rgw_startup_frontends,
+  l_rgw_startup_total,
+  l_rgw_sync_init_errors,
+
+  l_rgw_list_buckets_lat,
+  l_rgw_stat_account_lat,
+  l_rgw_bucket_stats_cached,
+
   l_rgw_last,
 };
 
+/* times a phase of gateway startup. when finished, or at the latest when
+ * destroyed, it logs how long the phase took and records it in the given
+ * l_rgw_startup_* counter */
+class RGWStartupPhase {
+  const DoutPrefixProvider *dpp;
+  int counter;
+  const char *name;
+  ceph::mono_time start;
+  bool finished = false;
+
+public:
+  RGWStartupPhase(const DoutPrefixProvider *dpp, int counter, const char *name)
+    : dpp(dpp), counter(counter), name(name),
+      start(ceph::mono_clock::now()) {}
+  ~RGWStartupPhase() { finish(); }
+
+  void finish();
+};
+
@@ -15,6 +15,7 @@
 #include "rgw_client_io.h"
 #include "rgw_opa.h"
 #include "rgw_perf_counters.h"
+#include "rgw_ratelimit.h"
 #include "rgw_lua.h"
 #include "rgw_lua_request.h"
 #include "rgw_tracer.h"
@@ -42,18 +43,49 @@ void RGWProcess::RGWWQ::_dump_queue()
   }
 } /* RGWProcess::RGWWQ::_dump_queue */
 
+/* with rgw_dmclock_client_key set, data and metadata requests get a
+ * dmclock client of their own per tenant or user, so that one of them
+ * can't starve the others. the name comes from the authenticated
+ * identity, so these requests are only scheduled once that is known */
+static bool dmclock_client_named(const req_state *s, RGWOp *op)
+{
+  namespace dmc = rgw::dmclock;
+  const auto id = op->dmclock_client();
+  if (id != dmc::client_id::data && id != dmc::client_id::metadata) {
+    return false;
+  }
+  return s->cct->_conf.get_val<std::string>("rgw_dmclock_client_key") != "none";
+}
+
+static rgw::dmclock::client_key dmclock_client(const req_state *s, RGWOp *op)
+{
+  rgw::dmclock::client_key client{op->dmclock_client()};
+  if (!dmclock_client_named(s, op) || !s->auth.identity ||
+      s->auth.identity->is_anonymous()) {
+    // anonymous requests share their class's client
+    return client;
+  }
+  const auto key = s->cct->_conf.get_val<std::string>("rgw_dmclock_client_key");
+  if (key == "tenant") {
+    client.name = s->bucket_tenant;
+  } else if (key == "user") {
+    client.name = s->user->get_id().to_str();
+  }
+  return client;
+}
+
 auto schedule_request(Scheduler *scheduler, req_state *s, RGWOp *op)
 {
   using rgw::dmclock::SchedulerCompleter;
   if (!scheduler)
     return std::make_pair(0,SchedulerCompleter{});
 
-  const auto client = op->dmclock_client();
+  const auto client = dmclock_client(s, op);
   const auto cost = op->dmclock_cost();
   if (s->cct->_conf->subsys.should_gather(ceph_subsys_rgw, 10)) {
     ldpp_dout(op,10) << "scheduling with "
 		     << s->cct->_conf.get_val<std::string>("rgw_scheduler_type")
-		     << " client=" << static_cast<int>(client)
+		     << " client=" << client
 		     << " cost=" << cost << dendl;
   }
   return scheduler->schedule_request(client, {},
@@ -62,6 +94,91 @@ auto schedule_request(Scheduler *scheduler, req_state *s, RGWOp *op)
                                      s->yield);
 }
 
+/* requests with a named dmclock client authenticate before they are
+ * scheduled under that name. hold a slot of the auth class meanwhile, so
+ * that authentication (which may call out to keystone or ldap) stays
+ * under rgw_max_concurrent_requests */
+static auto schedule_auth(Scheduler *scheduler, req_state *s, RGWOp *op)
+{
+  using rgw::dmclock::SchedulerCompleter;
+  if (!scheduler)
+    return std::make_pair(0,SchedulerCompleter{});
+
+  const rgw::dmclock::client_key client{rgw::dmclock::client_id::auth};
+  ldpp_dout(op,10) << "scheduling authentication with client=" << client
+                   << dendl;
+  return scheduler->schedule_request(client, {},
+                                     req_state::Clock::to_double(s->time),
+                                     1, s->yield);
+}
+
+static bool ratelimit_is_read(const req_state *s)
+{
+  return s->op == OP_GET || s->op == OP_HEAD;
+}
+
+static std::string ratelimit_user_key(const req_state *s)
+{
+  if (rgw::sal::User::empty(s->user.get()) ||
+      s->user->get_id().id == RGW_USER_ANON_ID) {
+    return {};
+  }
+  return "user:" + s->user->get_id().to_str();
+}
+
+static std::string ratelimit_bucket_key(const req_state *s)
+{
+  if (s->bucket_name.empty()) {
+    return {};
+  }
+  return "bucket:" + rgw_make_bucket_entry_name(s->bucket_tenant,
+                                                s->bucket_name);
+}
+
+/* take a token for the request from its user's and its bucket's rate
+ * limits. returns false if either of them is used up */
+static bool ratelimit_acquire(rgw::RateLimiter *ratelimiter, req_state *s,
+                              RGWOp *op)
+{
+  if (!ratelimiter || s->system_request) {
+    return true;
+  }
+  const bool is_read = ratelimit_is_read(s);
+  const auto now = rgw::RateLimiter::clock::now();
+
+  const auto user_limits = ratelimiter->get_user_limits();
+  const auto user_key = ratelimit_user_key(s);
+  if (user_limits.enabled() && !user_key.empty() &&
+      !ratelimiter->acquire(user_key, user_limits, is_read, now)) {
+    ldpp_dout(op, 5) << "rate limit exceeded for " << user_key << dendl;
+    perfcounter->inc(l_rgw_ratelimit_user);
+    return false;
+  }
+  const auto bucket_limits = ratelimiter->get_bucket_limits();
+  const auto bucket_key = ratelimit_bucket_key(s);
+  if (bucket_limits.enabled() && !bucket_key.empty() &&
+      !ratelimiter->acquire(bucket_key, bucket_limits, is_read, now)) {
+    ldpp_dout(op, 5) << "rate limit exceeded for " << bucket_key << dendl;
+    perfcounter->inc(l_rgw_ratelimit_bucket);
+    return false;
+  }
+  return true;
+}
+
+/* charge the bytes an admitted request transferred to its rate limits */
+static void ratelimit_charge(rgw::RateLimiter *ratelimiter, req_state *s)
+{
+  const bool is_read = ratelimit_is_read(s);
+  const uint64_t bytes = is_read ? ACCOUNTING_IO(s)->get_bytes_sent()
+                                 : ACCOUNTING_IO(s)->get_bytes_received();
+  if (const auto key = ratelimit_user_key(s); !key.empty()) {
+    ratelimiter->charge(key, is_read, bytes);
+  }
+  if (const auto key = ratelimit_bucket_key(s); !key.empty()) {
+    ratelimiter->charge(key, is_read, bytes);
+  }
+}
+
 bool RGWProcess::RGWWQ::_enqueue(RGWRequest* req) {
   process->m_req_queue.push_back(req);
   perfcounter->inc(l_rgw_qlen);
@@ -192,6 +309,7 @@ int process_request(rgw::sal::Store* const store,
                     OpsLogSink* const olog,
                     optional_yield yield,
 		    rgw::dmclock::Scheduler *scheduler,
+                    rgw::RateLimiter *ratelimiter,
                     string* user,
                     ceph::coarse_real_clock::duration* latency,
                     int* http_ret)
@@ -229,12 +347,15 @@ int process_request(rgw::sal::Store* const store,
   RGWOp* op = nullptr;
   int init_error = 0;
   bool should_log = false;
+  bool ratelimit_admitted = false;
+  bool schedule_after_auth = false;
   RGWRESTMgr *mgr;
   RGWHandler_REST *handler = rest->get_handler(store, s,
                                                auth_registry,
                                                frontend_prefix,
                                                client_io, &mgr, &init_error);
   rgw::dmclock::SchedulerCompleter c;
+  std::optional<rgw::dmclock::SchedulerCompleter> auth_slot;
 
   if (init_error != 0) {
     abort_early(s, nullptr, init_error, nullptr, yield);
@@ -264,7 +385,14 @@ int process_request(rgw::sal::Store* const store,
       }
     }
   }
-  std::tie(ret,c) = schedule_request(scheduler, s, op);
+  schedule_after_auth = dmclock_client_named(s, op);
+  if (schedule_after_auth) {
+    auto [r, slot] = schedule_auth(scheduler, s, op);
+    ret = r;
+    auth_slot.emplace(std::move(slot));
+  } else {
+    std::tie(ret,c) = schedule_request(scheduler, s, op);
+  }
   if (ret < 0) {
     if (ret == -EAGAIN) {
       ret = -ERR_RATE_LIMITED;
@@ -306,6 +434,27 @@ int process_request(rgw::sal::Store* const store,
       goto done;
     }
 
+    if (schedule_after_auth) {
+      // give the auth slot back before waiting for the named one, so that
+      // requests in this phase never hold one slot while waiting for another
+      auth_slot.reset();
+      std::tie(ret,c) = schedule_request(scheduler, s, op);
+      if (ret < 0) {
+        if (ret == -EAGAIN) {
+          ret = -ERR_RATE_LIMITED;
+        }
+        ldpp_dout(op,0) << "Scheduling request failed with " << ret << dendl;
+        abort_early(s, op, ret, handler, yield);
+        goto done;
+      }
+    }
+
+    if (!ratelimit_acquire(ratelimiter, s, op)) {
+      abort_early(s, op, -ERR_RATE_LIMITED, handler, yield);
+      goto done;
+    }
+    ratelimit_admitted = ratelimiter != nullptr;
+
     const auto trace_name = std::string(op->name()) + " " + s->trans_id;
     s->trace = tracing::rgw::tracer.start_trace(trace_name);
     s->trace->SetAttribute(tracing::rgw::OP, op->name());
@@ -358,6 +507,10 @@ done:
     rgw_log_op(rest, s, (op ? op->name() : "unknown"), olog);
   }
 
+  if (ratelimit_admitted) {
+    ratelimit_charge(ratelimiter, s);
+  }
+
   if (http_ret != nullptr) {
     *http_ret = s->err.http_ret;
   }
@@ -31,6 +31,10 @@ namespace rgw::dmclock {
   class Scheduler;
 }
 
+namespace rgw {
+  class RateLimiter;
+}
+
 struct RGWProcessEnv {
   rgw::sal::Store* store;
   RGWREST *rest;
@@ -38,6 +42,7 @@ struct RGWProcessEnv {
   int port;
   std::string uri_prefix;
   std::shared_ptr<rgw::auth::StrategyRegistry> auth_registry;
+  rgw::RateLimiter *ratelimiter = nullptr;
 };
 
 class RGWFrontendConfig;
@@ -172,6 +177,7 @@ extern int process_request(rgw::sal::Store* store,
                            OpsLogSink* olog,
                            optional_yield y,
                            rgw::dmclock::Scheduler *scheduler,
+                           rgw::RateLimiter *ratelimiter,
                            std::string* user,
                            ceph::coarse_real_clock::duration* latency,
                            int* http_ret = nullptr);
@@ -19,6 +19,7 @@
 #include "rgw_compression.h"
 #include "services/svc_sys_obj.h"
 #include "rgw_sal_rados.h"
+#include "rgw_perf_counters.h"
 
 #define dout_subsys ceph_subsys_rgw
 
@@ -101,6 +102,15 @@ int RadosWriter::process(bufferlist&& bl, uint64_t offset)
   if (cost == 0) { // no empty writes, use aio directly for creates
     return 0;
   }
+  if (alignment && perfcounter) {
+    if (offset % alignment == 0) {
+      perfcounter->inc(l_rgw_ec_write_aligned);
+    } else {
+      ldpp_dout(dpp, 20) << "write at offset " << offset
+          << " is not aligned to the stripe width " << alignment << dendl;
+      perfcounter->inc(l_rgw_ec_write_unaligned);
+    }
+  }
   librados::ObjectWriteOperation op;
   add_write_hint(op);
   if (offset == 0) {
@@ -237,7 +247,8 @@ int AtomicObjectProcessor::prepare(optional_yield y)
   if (head_obj->get_bucket()->get_placement_rule() != tail_placement_rule) {
     if (!head_obj->placement_rules_match(head_obj->get_bucket()->get_placement_rule(), tail_placement_rule)) {
       same_pool = false;
-      r = dynamic_cast<rgw::sal::RadosObject*>(head_obj.get())->get_max_chunk_size(dpp, tail_placement_rule, &chunk_size);
+      // the stripes only hold tail data, so size them for the tail pool
+      r = dynamic_cast<rgw::sal::RadosObject*>(head_obj.get())->get_max_chunk_size(dpp, tail_placement_rule, &chunk_size, &alignment);
       if (r < 0) {
         return r;
       }
@@ -276,6 +287,7 @@ int AtomicObjectProcessor::prepare(optional_yield y)
   }
 
   set_head_chunk_size(head_max_size);
+  writer.set_alignment(alignment);
   // initialize the processors
   chunk = ChunkProcessor(&writer, chunk_size);
   stripe = StripeProcessor(&chunk, this, head_max_size);
@@ -407,6 +419,7 @@ int MultipartObjectProcessor::prepare_head()
   }
   stripe_size = manifest_gen.cur_stripe_max_size();
   set_head_chunk_size(stripe_size);
+  writer.set_alignment(alignment);
 
   chunk = ChunkProcessor(&writer, chunk_size);
   stripe = StripeProcessor(&chunk, this, stripe_size);
@@ -576,7 +589,20 @@ int AppendObjectProcessor::prepare(optional_yield y)
     manifest.set_prefix(cur_manifest->get_prefix());
     astate->keep_tail = true;
   }
-  manifest.set_multipart_part_rule(store->ctx()->_conf->rgw_obj_stripe_size, cur_part_num);
+  // each append is a new part whose stripes hold tail data; size them for
+  // the tail pool like a multipart part
+  uint64_t tail_chunk_size;
+  uint64_t alignment;
+  r = dynamic_cast<rgw::sal::RadosObject*>(head_obj.get())->get_max_chunk_size(dpp,
+                                          tail_placement_rule, &tail_chunk_size, &alignment);
+  if (r < 0) {
+    return r;
+  }
+  uint64_t part_stripe_size;
+  dynamic_cast<rgw::sal::RadosObject*>(head_obj.get())->get_max_aligned_size(
+                                        store->ctx()->_conf->rgw_obj_stripe_size,
+                                        alignment, &part_stripe_size);
+  manifest.set_multipart_part_rule(part_stripe_size, cur_part_num);
 
   rgw_obj obj = head_obj->get_obj();
 
@@ -600,6 +626,7 @@ int AppendObjectProcessor::prepare(optional_yield y)
 
   uint64_t max_head_size = std::min(chunk_size, stripe_size);
   set_head_chunk_size(max_head_size);
+  writer.set_alignment(alignment);
 
   // initialize the processors
   chunk = ChunkProcessor(&writer, chunk_size);
@@ -71,6 +71,7 @@ class RadosWriter : public rgw::sal::DataProcessor {
   std::unique_ptr<rgw::sal::Object> head_obj;
   RGWSI_RADOS::Obj stripe_obj; // current stripe object
   RawObjSet written; // set of written objects for deletion
+  uint64_t alignment = 0; // stripe width of an erasure coded data pool
   const DoutPrefixProvider *dpp;
   optional_yield y;
 
@@ -83,7 +84,8 @@ class RadosWriter : public rgw::sal::DataProcessor {
   {}
   RadosWriter(RadosWriter&& r)
     : aio(r.aio), store(r.store),
-      obj_ctx(r.obj_ctx), head_obj(std::move(r.head_obj)), dpp(r.dpp), y(r.y)
+      obj_ctx(r.obj_ctx), head_obj(std::move(r.head_obj)),
+      alignment(r.alignment), dpp(r.dpp), y(r.y)
   {}
 
   ~RadosWriter();
@@ -94,6 +96,10 @@ class RadosWriter : public rgw::sal::DataProcessor {
   // change the current stripe object
   int set_stripe_obj(const rgw_raw_obj& obj);
 
+  // stripe width of the data pool, used to account for writes that don't
+  // start on a stripe boundary
+  void set_alignment(uint64_t a) { alignment = a; }
+
   // write the data at the given offset of the current stripe object
   int process(bufferlist&& data, uint64_t stripe_offset) override;
 
@@ -0,0 +1,124 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/* query parameters that select the S3 operation of a request. RGWHTTPArgs
+ * records which of them a request has in a bitmask as it parses the query,
+ * so op selection tests bits instead of looking names up in the maps */
+enum RGWQueryParam {
+  RGW_QP_ACL,
+  RGW_QP_CORS,
+  RGW_QP_DELETE,
+  RGW_QP_ENCRYPTION,
+  RGW_QP_LAYOUT,
+  RGW_QP_LEGAL_HOLD,
+  RGW_QP_LIFECYCLE,
+  RGW_QP_LOCATION,
+  RGW_QP_LOGGING,
+  RGW_QP_MDSEARCH,
+  RGW_QP_NOTIFICATION,
+  RGW_QP_OBJECT_LOCK,
+  RGW_QP_POLICY,
+  RGW_QP_POLICY_STATUS,
+  RGW_QP_PUBLIC_ACCESS_BLOCK,
+  RGW_QP_REPLICATION,
+  RGW_QP_REQUEST_PAYMENT,
+  RGW_QP_RETENTION,
+  RGW_QP_SELECT_TYPE,
+  RGW_QP_TAGGING,
+  RGW_QP_UPLOAD_ID,
+  RGW_QP_UPLOADS,
+  RGW_QP_USAGE,
+  RGW_QP_VERSIONING,
+  RGW_QP_WEBSITE,
+  RGW_QP_MAX,
+};
+
+static_assert(RGW_QP_MAX <= 64, "query params must fit in a uint64_t mask");
+
+constexpr uint64_t rgw_query_param_bit(RGWQueryParam p) {
+  return uint64_t(1) << p;
+}
+
+namespace rgw::query_param {
+
+inline constexpr std::array<std::string_view, RGW_QP_MAX> names = {
+  "acl",
+  "cors",
+  "delete",
+  "encryption",
+  "layout",
+  "legal-hold",
+  "lifecycle",
+  "location",
+  "logging",
+  "mdsearch",
+  "notification",
+  "object-lock",
+  "policy",
+  "policyStatus",
+  "publicAccessBlock",
+  "replication",
+  "requestPayment",
+  "retention",
+  "select-type",
+  "tagging",
+  "uploadId",
+  "uploads",
+  "usage",
+  "versioning",
+  "website",
+};
+
+/* a perfect hash of the names above: their length and first and last
+ * characters give each a different slot. adding a name may need new
+ * factors, which the static_assert below checks for */
+inline constexpr size_t num_slots = 64;
+
+constexpr size_t slot(std::string_view name) {
+  return (name.size() + 4 * static_cast<unsigned char>(name.front()) +
+          14 * static_cast<unsigned char>(name.back())) % num_slots;
+}
+
+constexpr std::array<int8_t, num_slots> make_slots() {
+  std::array<int8_t, num_slots> slots{};
+  for (auto& s : slots) {
+    s = -1;
+  }
+  for (size_t i = 0; i < names.size(); i++) {
+    slots[slot(names[i])] = static_cast<int8_t>(i);
+  }
+  return slots;
+}
+
+inline constexpr std::array<int8_t, num_slots> slots = make_slots();
+
+constexpr bool is_perfect() {
+  for (size_t i = 0; i < names.size(); i++) {
+    if (slots[slot(names[i])] != static_cast<int8_t>(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(is_perfect(), "query param names collide");
+
+} // namespace rgw::query_param
+
+/// return the param with the given name, or RGW_QP_MAX if there is none
+constexpr RGWQueryParam rgw_query_param_lookup(std::string_view name) {
+  using namespace rgw::query_param;
+  if (name.empty()) {
+    return RGW_QP_MAX;
+  }
+  const int8_t i = slots[slot(name)];
+  if (i < 0 || names[i] != name) {
+    return RGW_QP_MAX;
+  }
+  return static_cast<RGWQueryParam>(i);
+}
@@ -47,10 +47,12 @@
 #include "rgw_etag_verifier.h"
 #include "rgw_worker.h"
 #include "rgw_notify.h"
+#include "rgw_perf_counters.h"
 
 #undef fork // fails to compile RGWPeriod::fork() below
 
 #include "common/Clock.h"
+#include "common/Thread.h"
 
 using namespace librados;
 
@@ -237,61 +239,113 @@ RGWObjState::RGWObjState(const RGWObjState& rhs) : obj (rhs.obj) {
   compressed = rhs.compressed;
 }
 
+size_t RGWObjectCtx::obj_hash(const rgw_obj& obj)
+{
+  // the fields rgw_obj::operator< compares, which decide what is the same
+  // object here
+  size_t h = std::hash<std::string>{}(obj.key.name);
+  for (const auto* f : {&obj.bucket.bucket_id, &obj.key.ns, &obj.key.instance}) {
+    h ^= std::hash<std::string>{}(*f) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  }
+  return h;
+}
+
+RGWObjectCtx::ObjStateMap::iterator
+RGWObjectCtx::find(ObjStateMap& m, size_t hash, const rgw_obj& obj)
+{
+  auto [i, end] = m.equal_range(hash);
+  for (; i != end; ++i) {
+    const auto& o = i->second.obj;
+    if (o.key.name == obj.key.name &&
+        o.bucket.bucket_id == obj.bucket.bucket_id &&
+        o.key.ns == obj.key.ns &&
+        o.key.instance == obj.key.instance) {
+      return i;
+    }
+  }
+  return m.end();
+}
+
+RGWObjState& RGWObjectCtx::find_or_create(ObjStateMap& m, size_t hash,
+                                          const rgw_obj& obj)
+{
+  auto i = find(m, hash, obj);
+  if (i == m.end()) {
+    i = m.emplace(hash, ObjEntry{obj, {}});
+  }
+  return i->second.state;
+}
+
 RGWObjState *RGWObjectCtx::get_state(const rgw_obj& obj) {
-  RGWObjState *result;
-  typename std::map<rgw_obj, RGWObjState>::iterator iter;
-  lock.lock_shared();
   assert (!obj.empty());
-  iter = objs_state.find(obj);
-  if (iter != objs_state.end()) {
-    result = &iter->second;
-    lock.unlock_shared();
-  } else {
-    lock.unlock_shared();
-    lock.lock();
-    result = &objs_state[obj];
-    lock.unlock();
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  {
+    std::shared_lock rl{shard.lock};
+    auto i = find(shard.objs_state, hash, obj);
+    if (i != shard.objs_state.end()) {
+      return &i->second.state;
+    }
   }
-  return result;
+  std::unique_lock wl{shard.lock};
+  return &find_or_create(shard.objs_state, hash, obj);
 }
 
 void RGWObjectCtx::set_compressed(const rgw_obj& obj) {
-  std::unique_lock wl{lock};
   assert (!obj.empty());
-  objs_state[obj].compressed = true;
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  std::unique_lock wl{shard.lock};
+  find_or_create(shard.objs_state, hash, obj).compressed = true;
 }
 
 void RGWObjectCtx::set_atomic(rgw_obj& obj) {
-  std::unique_lock wl{lock};
   assert (!obj.empty());
-  objs_state[obj].is_atomic = true;
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  std::unique_lock wl{shard.lock};
+  find_or_create(shard.objs_state, hash, obj).is_atomic = true;
 }
 void RGWObjectCtx::set_prefetch_data(const rgw_obj& obj) {
-  std::unique_lock wl{lock};
   assert (!obj.empty());
-  objs_state[obj].prefetch_data = true;
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  std::unique_lock wl{shard.lock};
+  find_or_create(shard.objs_state, hash, obj).prefetch_data = true;
 }
 
 void RGWObjectCtx::invalidate(const rgw_obj& obj) {
-  std::unique_lock wl{lock};
-  auto iter = objs_state.find(obj);
-  if (iter == objs_state.end()) {
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  std::unique_lock wl{shard.lock};
+  auto iter = find(shard.objs_state, hash, obj);
+  if (iter == shard.objs_state.end()) {
     return;
   }
-  bool is_atomic = iter->second.is_atomic;
-  bool prefetch_data = iter->second.prefetch_data;
-  bool compressed = iter->second.compressed;
+  bool is_atomic = iter->second.state.is_atomic;
+  bool prefetch_data = iter->second.state.prefetch_data;
+  bool compressed = iter->second.state.compressed;
 
-  objs_state.erase(iter);
+  shard.objs_state.erase(iter);
 
   if (is_atomic || prefetch_data || compressed) {
-    auto& state = objs_state[obj];
+    auto& state = find_or_create(shard.objs_state, hash, obj);
     state.is_atomic = is_atomic;
     state.prefetch_data = prefetch_data;
     state.compressed = compressed;
   }
 }
 
+void RGWObjectCtx::release(const rgw_obj& obj) {
+  const auto hash = obj_hash(obj);
+  auto& shard = shard_for(hash);
+  std::unique_lock wl{shard.lock};
+  auto iter = find(shard.objs_state, hash, obj);
+  if (iter != shard.objs_state.end()) {
+    shard.objs_state.erase(iter);
+  }
+}
+
 void RGWObjVersionTracker::generate_new_write_ver(CephContext *cct)
 {
   write_version.ver = 1;
@@ -725,6 +779,38 @@ int RGWRados::get_required_alignment(const DoutPrefixProvider *dpp, const rgw_po
   return 0;
 }
 
+// like get_required_alignment(), but also reports the stripe width of
+// erasure coded pools with overwrites: they take writes at any offset, but
+// every write that doesn't start on a stripe boundary costs the OSDs a
+// read-modify-write of the partial stripe
+int RGWRados::get_preferred_alignment(const DoutPrefixProvider *dpp, const rgw_pool& pool, uint64_t *alignment)
+{
+  if (!cct->_conf.get_val<bool>("rgw_ec_stripe_aligned_writes")) {
+    return get_required_alignment(dpp, pool, alignment);
+  }
+
+  IoCtx ioctx;
+  int r = open_pool_ctx(dpp, pool, ioctx, false);
+  if (r < 0) {
+    ldpp_dout(dpp, 0) << "ERROR: open_pool_ctx() returned " << r << dendl;
+    return r;
+  }
+
+  // this is the stripe width for erasure coded pools, 0 otherwise
+  uint64_t align;
+  r = ioctx.pool_required_alignment2(&align);
+  if (r < 0) {
+    ldpp_dout(dpp, 0) << "ERROR: ioctx.pool_required_alignment2() returned "
+      << r << dendl;
+    return r;
+  }
+  if (align != 0) {
+    ldpp_dout(dpp, 20) << "preferred alignment=" << align << dendl;
+  }
+  *alignment = align;
+  return 0;
+}
+
 void RGWRados::get_max_aligned_size(uint64_t size, uint64_t alignment, uint64_t *max_size)
 {
   if (alignment == 0) {
@@ -743,7 +829,7 @@ void RGWRados::get_max_aligned_size(uint64_t size, uint64_t alignment, uint64_t
 int RGWRados::get_max_chunk_size(const rgw_pool& pool, uint64_t *max_chunk_size, const DoutPrefixProvider *dpp, uint64_t *palignment)
 {
   uint64_t alignment;
-  int r = get_required_alignment(dpp, pool, &alignment);
+  int r = get_preferred_alignment(dpp, pool, &alignment);
   if (r < 0) {
     return r;
   }
@@ -1037,9 +1123,19 @@ bool RGWIndexCompletionManager::handle_completion(completion_t cb, complete_op_d
 
 void RGWRados::finalize()
 {
+  if (sync_init_thread.joinable()) {
+    {
+      std::lock_guard l{sync_init_lock};
+      sync_init_stopping = true;
+    }
+    sync_init_cond.notify_all();
+    sync_init_thread.join();
+  }
   if (run_sync_thread) {
     std::lock_guard l{meta_sync_thread_lock};
-    meta_sync_processor_thread->stop();
+    if (meta_sync_processor_thread) {
+      meta_sync_processor_thread->stop();
+    }
 
     std::lock_guard dl{data_sync_thread_lock};
     for (auto iter : data_sync_processor_threads) {
@@ -1266,16 +1362,6 @@ int RGWRados::init_complete(const DoutPrefixProvider *dpp)
                       << pt.second.name << " present in zonegroup" << dendl;
       }
     }
-    auto async_processor = svc.rados->get_async_processor();
-    std::lock_guard l{meta_sync_thread_lock};
-    meta_sync_processor_thread = new RGWMetaSyncProcessorThread(this->store, async_processor);
-    ret = meta_sync_processor_thread->init(dpp);
-    if (ret < 0) {
-      ldpp_dout(dpp, 0) << "ERROR: failed to initialize meta sync thread" << dendl;
-      return ret;
-    }
-    meta_sync_processor_thread->start();
-
     // configure the bucket trim manager
     rgw::BucketTrimConfig config;
     rgw::configure_bucket_trim(cct, config);
@@ -1288,27 +1374,39 @@ int RGWRados::init_complete(const DoutPrefixProvider *dpp)
     }
     svc.datalog_rados->set_observer(&*bucket_trim);
 
-    std::lock_guard dl{data_sync_thread_lock};
-    for (auto source_zone : svc.zone->get_data_sync_source_zones()) {
-      ldpp_dout(dpp, 5) << "starting data sync thread for zone " << source_zone->name << dendl;
-      auto *thread = new RGWDataSyncProcessorThread(this->store, svc.rados->get_async_processor(), source_zone);
-      ret = thread->init(dpp);
-      if (ret < 0) {
-        ldpp_dout(dpp, 0) << "ERROR: failed to initialize data sync thread" << dendl;
-        return ret;
-      }
-      thread->start();
-      data_sync_processor_threads[rgw_zone_id(source_zone->id)] = thread;
-    }
-    auto interval = cct->_conf->rgw_sync_log_trim_interval;
-    if (interval > 0) {
-      sync_log_trimmer = new RGWSyncLogTrimThread(this->store, &*bucket_trim, interval);
-      ret = sync_log_trimmer->init(dpp);
+    if (cct->_conf.get_val<bool>("rgw_sync_init_async")) {
+      /* initializing the sync threads waits on the other zones, and requests
+       * can be served without them, so don't hold up the frontends */
+      sync_init_thread = make_named_thread("rgw_sync_init", [this] {
+        const DoutPrefix dp(cct, dout_subsys, "rgw sync init: ");
+        RGWStartupPhase phase(&dp, l_rgw_startup_sync, "sync");
+        /* nothing else would restart sync on failure, so keep retrying the
+         * threads that didn't start until finalize() stops us */
+        auto backoff = std::chrono::seconds(5);
+        constexpr auto max_backoff = std::chrono::minutes(5);
+        std::unique_lock l{sync_init_lock};
+        while (!sync_init_stopping) {
+          l.unlock();
+          int r = start_sync_threads(&dp);
+          l.lock();
+          if (r >= 0 || sync_init_stopping) {
+            break;
+          }
+          if (perfcounter) {
+            perfcounter->inc(l_rgw_sync_init_errors);
+          }
+          ldpp_dout(&dp, -1) << "ERROR: failed to start sync threads, r="
+                             << r << ", retrying in " << backoff << dendl;
+          sync_init_cond.wait_for(l, backoff, [this] { return sync_init_stopping; });
+          backoff = std::min<std::chrono::seconds>(backoff * 2, max_backoff);
+        }
+      });
+    } else {
+      RGWStartupPhase phase(dpp, l_rgw_startup_sync, "sync");
+      ret = start_sync_threads(dpp);
       if (ret < 0) {
-        ldpp_dout(dpp, 0) << "ERROR: failed to initialize sync log trim thread" << dendl;
         return ret;
       }
-      sync_log_trimmer->start();
     }
   }
   data_notifier = new RGWDataNotifier(this);
@@ -1363,6 +1461,70 @@ int RGWRados::init_complete(const DoutPrefixProvider *dpp)
   return ret;
 }
 
+bool RGWRados::sync_init_stopped()
+{
+  std::lock_guard l{sync_init_lock};
+  return sync_init_stopping;
+}
+
+int RGWRados::start_sync_threads(const DoutPrefixProvider *dpp)
+{
+  auto async_processor = svc.rados->get_async_processor();
+  bool meta_started;
+  {
+    std::lock_guard l{meta_sync_thread_lock};
+    meta_started = meta_sync_processor_thread != nullptr;
+  }
+  if (!meta_started) {
+    auto meta_thread = std::make_unique<RGWMetaSyncProcessorThread>(this->store, async_processor);
+    int ret = meta_thread->init(dpp);
+    if (ret < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: failed to initialize meta sync thread" << dendl;
+      return ret;
+    }
+    meta_thread->start();
+    std::lock_guard l{meta_sync_thread_lock};
+    meta_sync_processor_thread = meta_thread.release();
+  }
+
+  for (auto source_zone : svc.zone->get_data_sync_source_zones()) {
+    // each init waits on the source zone, so check for finalize() in between
+    if (sync_init_stopped()) {
+      return -ECANCELED;
+    }
+    const auto zone_id = rgw_zone_id(source_zone->id);
+    {
+      std::lock_guard dl{data_sync_thread_lock};
+      if (data_sync_processor_threads.count(zone_id)) {
+        continue;
+      }
+    }
+    ldpp_dout(dpp, 5) << "starting data sync thread for zone " << source_zone->name << dendl;
+    auto thread = std::make_unique<RGWDataSyncProcessorThread>(this->store, async_processor, source_zone);
+    int ret = thread->init(dpp);
+    if (ret < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: failed to initialize data sync thread for zone "
+                        << source_zone->name << dendl;
+      return ret;
+    }
+    thread->start();
+    std::lock_guard dl{data_sync_thread_lock};
+    data_sync_processor_threads[zone_id] = thread.release();
+  }
+  auto interval = cct->_conf->rgw_sync_log_trim_interval;
+  if (interval > 0 && !sync_log_trimmer) {
+    auto trimmer = std::make_unique<RGWSyncLogTrimThread>(this->store, &*bucket_trim, interval);
+    int ret = trimmer->init(dpp);
+    if (ret < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: failed to initialize sync log trim thread" << dendl;
+      return ret;
+    }
+    trimmer->start();
+    sync_log_trimmer = trimmer.release();
+  }
+  return 0;
+}
+
 int RGWRados::init_svc(bool raw, const DoutPrefixProvider *dpp)
 {
   if (raw) {
@@ -1389,20 +1551,25 @@ int RGWRados::initialize(const DoutPrefixProvider *dpp)
     cct->_conf.get_val<double>("rgw_inject_notify_timeout_probability");
   max_notify_retries = cct->_conf.get_val<uint64_t>("rgw_max_notify_retries");
 
+  RGWStartupPhase services_phase(dpp, l_rgw_startup_services, "services");
   ret = init_svc(false, dpp);
   if (ret < 0) {
     ldpp_dout(dpp, 0) << "ERROR: failed to init services (ret=" << cpp_strerror(-ret) << ")" << dendl;
     return ret;
   }
+  services_phase.finish();
 
+  RGWStartupPhase ctl_phase(dpp, l_rgw_startup_ctl, "ctl");
   ret = init_ctl(dpp);
   if (ret < 0) {
     ldpp_dout(dpp, 0) << "ERROR: failed to init ctls (ret=" << cpp_strerror(-ret) << ")" << dendl;
     return ret;
   }
+  ctl_phase.finish();
 
   host_id = svc.zone_utils->gen_host_id();
 
+  RGWStartupPhase init_phase(dpp, l_rgw_startup_init, "init");
   ret = init_rados();
   if (ret < 0)
     return ret;
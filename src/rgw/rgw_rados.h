@@ -4,7 +4,9 @@
 #ifndef CEPH_RGWRADOS_H
 #define CEPH_RGWRADOS_H
 
+#include <array>
 #include <functional>
+#include <unordered_map>
 #include <boost/container/flat_map.hpp>
 
 #include "include/rados/librados.hpp"
@@ -186,10 +188,31 @@ public:
 
 class RGWObjectCtx {
   rgw::sal::Store* store;
-  ceph::shared_mutex lock = ceph::make_shared_mutex("RGWObjectCtx");
   void *s{nullptr};
 
-  std::map<rgw_obj, RGWObjState> objs_state;
+  /* states are kept in shards by a hash of the fields rgw_obj orders by,
+   * so multi-object ops don't pay for string compares down a tree and
+   * concurrent accesses to different objects rarely share a lock */
+  struct ObjEntry {
+    rgw_obj obj;
+    RGWObjState state;
+  };
+  using ObjStateMap = std::unordered_multimap<size_t, ObjEntry>;
+  struct Shard {
+    ceph::shared_mutex lock = ceph::make_shared_mutex("RGWObjectCtx");
+    ObjStateMap objs_state;
+  };
+  static constexpr size_t num_shards = 8;
+  std::array<Shard, num_shards> shards;
+
+  static size_t obj_hash(const rgw_obj& obj);
+  Shard& shard_for(size_t hash) {
+    return shards[hash % num_shards];
+  }
+  static ObjStateMap::iterator find(ObjStateMap& m, size_t hash,
+                                    const rgw_obj& obj);
+  static RGWObjState& find_or_create(ObjStateMap& m, size_t hash,
+                                     const rgw_obj& obj);
 public:
   explicit RGWObjectCtx(rgw::sal::Store* _store) : store(_store) {}
   explicit RGWObjectCtx(rgw::sal::Store* _store, void *_s) : store(_store), s(_s) {}
@@ -208,6 +231,9 @@ public:
   void set_atomic(rgw_obj& obj);
   void set_prefetch_data(const rgw_obj& obj);
   void invalidate(const rgw_obj& obj);
+  /// drop the state of an object the caller is done with, including the
+  /// flags invalidate() keeps. states returned for it must not be used after
+  void release(const rgw_obj& obj);
 };
 
 
@@ -379,6 +405,11 @@ class RGWRados
 
   boost::optional<rgw::BucketTrimManager> bucket_trim;
   RGWSyncLogTrimThread *sync_log_trimmer{nullptr};
+  std::thread sync_init_thread;
+  ceph::mutex sync_init_lock = ceph::make_mutex("sync_init_lock");
+  ceph::condition_variable sync_init_cond;
+  bool sync_init_stopping = false;
+  bool sync_init_stopped();
 
   ceph::mutex meta_sync_thread_lock = ceph::make_mutex("meta_sync_thread_lock");
   ceph::mutex data_sync_thread_lock = ceph::make_mutex("data_sync_thread_lock");
@@ -559,6 +590,7 @@ public:
   }
 
   int get_required_alignment(const DoutPrefixProvider *dpp, const rgw_pool& pool, uint64_t *alignment);
+  int get_preferred_alignment(const DoutPrefixProvider *dpp, const rgw_pool& pool, uint64_t *alignment);
   void get_max_aligned_size(uint64_t size, uint64_t alignment, uint64_t *max_size);
   int get_max_chunk_size(const rgw_pool& pool, uint64_t *max_chunk_size, const DoutPrefixProvider *dpp, uint64_t *palignment = nullptr);
   int get_max_chunk_size(const rgw_placement_rule& placement_rule, const rgw_obj& obj, uint64_t *max_chunk_size, const DoutPrefixProvider *dpp, uint64_t *palignment = nullptr);
@@ -590,6 +622,9 @@ public:
   int init_ctl(const DoutPrefixProvider *dpp);
   virtual int init_rados();
   int init_complete(const DoutPrefixProvider *dpp);
+  /// create and start the metadata, data and sync log trim threads that
+  /// aren't running yet, so a failed attempt can be retried
+  int start_sync_threads(const DoutPrefixProvider *dpp);
   int initialize(const DoutPrefixProvider *dpp);
   void finalize();
 
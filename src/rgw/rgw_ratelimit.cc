@@ -0,0 +1,439 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#include <algorithm>
+
+#include "common/errno.h"
+#include "common/Thread.h"
+
+#include "rgw_ratelimit.h"
+#include "rgw_tools.h"
+
+#define dout_subsys ceph_subsys_rgw
+
+#undef dout_prefix
+#define dout_prefix (*_dout << "rgw ratelimit: ")
+
+namespace rgw {
+
+RateLimiter::RateLimiter(CephContext *cct)
+  : cct(cct)
+{
+  update(cct->_conf);
+  cct->_conf.add_observer(this);
+}
+
+RateLimiter::~RateLimiter()
+{
+  cct->_conf.remove_observer(this);
+}
+
+RateLimits RateLimiter::get_user_limits() const
+{
+  std::lock_guard l{config_mutex};
+  return user_limits;
+}
+
+RateLimits RateLimiter::get_bucket_limits() const
+{
+  std::lock_guard l{config_mutex};
+  return bucket_limits;
+}
+
+bool RateLimiter::enabled() const
+{
+  std::lock_guard l{config_mutex};
+  return user_limits.enabled() || bucket_limits.enabled();
+}
+
+void RateLimiter::Entry::drain(clock::time_point now)
+{
+  // a counter without a limit has no rate to drain at; it is never
+  // checked, so just drop whatever it holds (e.g. from before the limit
+  // was removed) instead of keeping the entry around forever
+  for (size_t i = 0; i < num_counters; i++) {
+    if (rate[i] == 0) {
+      level[i] = 0;
+    }
+  }
+  const double elapsed = std::chrono::duration<double>(now - last).count();
+  if (elapsed <= 0) {
+    return;
+  }
+  for (size_t i = 0; i < num_counters; i++) {
+    level[i] = std::max(0.0, level[i] - rate[i] * elapsed);
+  }
+  last = now;
+}
+
+RateLimiter::Stripe& RateLimiter::stripe_for(const std::string& key)
+{
+  return stripes[std::hash<std::string>{}(key) % num_stripes];
+}
+
+bool RateLimiter::acquire(const std::string& key, const RateLimits& limits,
+                          bool is_read, clock::time_point now)
+{
+  const size_t ops = is_read ? read_ops : write_ops;
+  const size_t bytes = is_read ? read_bytes : write_bytes;
+  const uint64_t ops_limit = is_read ? limits.read_ops : limits.write_ops;
+  const uint64_t bytes_limit = is_read ? limits.read_bytes : limits.write_bytes;
+
+  auto& stripe = stripe_for(key);
+  std::lock_guard l{stripe.mutex};
+  auto [i, inserted] = stripe.entries.try_emplace(key);
+  auto& e = i->second;
+  if (inserted) {
+    e.last = now;
+  }
+  e.drain(now);
+  e.seen = now;
+  e.rate = {limits.read_ops / 60.0, limits.write_ops / 60.0,
+            limits.read_bytes / 60.0, limits.write_bytes / 60.0};
+
+  // bytes aren't known until the request completes, so a request may take
+  // the byte bucket into debt; the next ones wait until it's paid off
+  if (ops_limit && e.level[ops] + 1 > ops_limit) {
+    return false;
+  }
+  if (bytes_limit && e.level[bytes] >= bytes_limit) {
+    return false;
+  }
+  if (ops_limit) {
+    e.level[ops] += 1;
+  }
+  e.pending[ops] += 1;
+  return true;
+}
+
+void RateLimiter::charge(const std::string& key, bool is_read, uint64_t bytes)
+{
+  if (!bytes) {
+    return;
+  }
+  const size_t i = is_read ? read_bytes : write_bytes;
+  auto& stripe = stripe_for(key);
+  std::lock_guard l{stripe.mutex};
+  auto e = stripe.entries.find(key);
+  if (e == stripe.entries.end()) {
+    return;
+  }
+  // a counter without a limit would never drain
+  if (e->second.rate[i] != 0) {
+    e->second.level[i] += bytes;
+  }
+  e->second.pending[i] += bytes;
+}
+
+void RateLimiter::apply(const RateLimitUsage& usage)
+{
+  auto& stripe = stripe_for(usage.key);
+  std::lock_guard l{stripe.mutex};
+  auto e = stripe.entries.find(usage.key);
+  if (e == stripe.entries.end()) {
+    return;
+  }
+  auto& entry = e->second;
+  const std::array<uint64_t, num_counters> used = {
+    usage.read_ops, usage.write_ops, usage.read_bytes, usage.write_bytes};
+  for (size_t i = 0; i < num_counters; i++) {
+    if (entry.rate[i] != 0) {
+      entry.level[i] += used[i];
+    }
+  }
+}
+
+std::vector<RateLimitUsage> RateLimiter::collect()
+{
+  std::vector<RateLimitUsage> usage;
+  for (auto& stripe : stripes) {
+    std::lock_guard l{stripe.mutex};
+    for (auto& [key, e] : stripe.entries) {
+      auto& p = e.pending;
+      if (!p[read_ops] && !p[write_ops] && !p[read_bytes] && !p[write_bytes]) {
+        continue;
+      }
+      usage.push_back({key, p[read_ops], p[write_ops],
+                       p[read_bytes], p[write_bytes]});
+      p.fill(0);
+    }
+  }
+  return usage;
+}
+
+void RateLimiter::trim(clock::time_point now, clock::duration idle)
+{
+  for (auto& stripe : stripes) {
+    std::lock_guard l{stripe.mutex};
+    for (auto i = stripe.entries.begin(); i != stripe.entries.end(); ) {
+      auto& e = i->second;
+      if (now - e.seen < idle) {
+        ++i;
+        continue;
+      }
+      e.drain(now);
+      const bool drained = std::all_of(e.level.begin(), e.level.end(),
+                                       [] (double l) { return l == 0; });
+      const bool synced = std::all_of(e.pending.begin(), e.pending.end(),
+                                      [] (uint64_t p) { return p == 0; });
+      if (drained && synced) {
+        i = stripe.entries.erase(i);
+      } else {
+        ++i;
+      }
+    }
+  }
+}
+
+size_t RateLimiter::size() const
+{
+  size_t count = 0;
+  for (const auto& stripe : stripes) {
+    std::lock_guard l{stripe.mutex};
+    count += stripe.entries.size();
+  }
+  return count;
+}
+
+const char** RateLimiter::get_tracked_conf_keys() const
+{
+  static const char* keys[] = {
+    "rgw_ratelimit_user_read_ops",
+    "rgw_ratelimit_user_write_ops",
+    "rgw_ratelimit_user_read_bytes",
+    "rgw_ratelimit_user_write_bytes",
+    "rgw_ratelimit_bucket_read_ops",
+    "rgw_ratelimit_bucket_write_ops",
+    "rgw_ratelimit_bucket_read_bytes",
+    "rgw_ratelimit_bucket_write_bytes",
+    nullptr
+  };
+  return keys;
+}
+
+void RateLimiter::handle_conf_change(const ConfigProxy& conf,
+                                     const std::set<std::string>& changed)
+{
+  update(conf);
+}
+
+void RateLimiter::update(const ConfigProxy& conf)
+{
+  std::lock_guard l{config_mutex};
+  user_limits.read_ops = conf.get_val<uint64_t>("rgw_ratelimit_user_read_ops");
+  user_limits.write_ops = conf.get_val<uint64_t>("rgw_ratelimit_user_write_ops");
+  user_limits.read_bytes = conf.get_val<uint64_t>("rgw_ratelimit_user_read_bytes");
+  user_limits.write_bytes = conf.get_val<uint64_t>("rgw_ratelimit_user_write_bytes");
+  bucket_limits.read_ops = conf.get_val<uint64_t>("rgw_ratelimit_bucket_read_ops");
+  bucket_limits.write_ops = conf.get_val<uint64_t>("rgw_ratelimit_bucket_write_ops");
+  bucket_limits.read_bytes = conf.get_val<uint64_t>("rgw_ratelimit_bucket_read_bytes");
+  bucket_limits.write_bytes = conf.get_val<uint64_t>("rgw_ratelimit_bucket_write_bytes");
+}
+
+
+RateLimitSync::RateLimitSync(const DoutPrefixProvider *dpp, CephContext *cct,
+                             RateLimiter& limiter, const rgw_pool& pool,
+                             const std::string& zone_id)
+  : cct(cct), dpp(dpp), limiter(limiter), pool(pool),
+    oid("ratelimit." + zone_id),
+    interval(cct->_conf.get_val<std::chrono::seconds>(
+        "rgw_ratelimit_sync_interval"))
+{
+  maybe_watch_start();
+  thread = make_named_thread("rgw_ratelimit", &RateLimitSync::run, this);
+}
+
+RateLimitSync::~RateLimitSync()
+{
+  {
+    std::lock_guard l{mutex};
+    stopping = true;
+  }
+  cond.notify_all();
+  thread.join();
+  watch_stop();
+}
+
+void RateLimitSync::handle_notify(uint64_t notify_id, uint64_t cookie,
+                                  uint64_t notifier_id, bufferlist& bl)
+{
+  if (cookie != watch_handle)
+    return;
+
+  bufferlist reply;
+  pool_ctx.notify_ack(watch_oid, notify_id, cookie, reply);
+
+  // our own notifies come back to us too
+  if (notifier_id == rados.get_instance_id())
+    return;
+
+  std::vector<RateLimitUsage> usage;
+  try {
+    using ceph::decode;
+    auto p = bl.cbegin();
+    decode(usage, p);
+  } catch (const buffer::error& e) {
+    lderr(cct) << "Failed to decode rate limit usage from "
+        << notifier_id << dendl;
+    return;
+  }
+  for (const auto& u : usage) {
+    limiter.apply(u);
+  }
+  ldout(cct, 20) << "applied usage of " << usage.size()
+      << " keys from " << notifier_id << dendl;
+}
+
+void RateLimitSync::handle_error(uint64_t cookie, int err)
+{
+  lderr(cct) << "RateLimitSync::handle_error oid=" << watch_oid
+      << " err=" << err << dendl;
+  std::lock_guard l{mutex};
+  if (cookie != watch_handle || watch_oid.empty())
+    return;
+
+  pool_ctx.unwatch2(watch_handle);
+  int r = pool_ctx.watch2(watch_oid, &watch_handle, this);
+  if (r < 0) {
+    lderr(cct) << "Failed to restart watch on " << watch_oid
+        << " with " << cpp_strerror(-r) << dendl;
+    pool_ctx.close();
+    watch_oid.clear();
+  }
+}
+
+int RateLimitSync::watch_start()
+{
+  // a failed watch restart leaves the client connected for the next try
+  if (!connected) {
+    int r = rados.init_with_context(cct);
+    if (r < 0) {
+      ldpp_dout(dpp, -1) << "Rados client initialization failed with "
+          << cpp_strerror(-r) << dendl;
+      return r;
+    }
+    r = rados.connect();
+    if (r < 0) {
+      ldpp_dout(dpp, -1) << "Rados client connection failed with "
+          << cpp_strerror(-r) << dendl;
+      rados.shutdown();
+      return r;
+    }
+    connected = true;
+  }
+  librados::IoCtx ctx;
+  int r = rgw_init_ioctx(dpp, &rados, pool, ctx, true);
+  if (r < 0) {
+    ldpp_dout(dpp, -1) << "Failed to open pool " << pool
+        << " with " << cpp_strerror(-r) << dendl;
+    return r;
+  }
+
+  // the control object must exist to be watched
+  r = ctx.create(oid, false);
+  if (r < 0) {
+    ldpp_dout(dpp, -1) << "Failed to create " << oid
+        << " with " << cpp_strerror(-r) << dendl;
+    return r;
+  }
+
+  std::lock_guard l{mutex};
+  pool_ctx = std::move(ctx);
+  r = pool_ctx.watch2(oid, &watch_handle, this);
+  if (r < 0) {
+    ldpp_dout(dpp, -1) << "Failed to watch " << oid
+        << " with " << cpp_strerror(-r) << dendl;
+    pool_ctx.close();
+    return r;
+  }
+
+  ldpp_dout(dpp, 10) << "Watching " << oid << dendl;
+  watch_oid = oid;
+  return 0;
+}
+
+void RateLimitSync::maybe_watch_start()
+{
+  // a gateway without limits has nothing to share, so it doesn't pay for
+  // the Rados client and the watch until a limit is configured
+  if (interval == std::chrono::seconds::zero() || !limiter.enabled()) {
+    return;
+  }
+  {
+    std::lock_guard l{mutex};
+    if (!watch_oid.empty()) {
+      return;
+    }
+  }
+  int r = watch_start();
+  if (r < 0) {
+    ldpp_dout(dpp, -1) << "Failed to establish a watch for rate limit sync, "
+        "rate limits will only apply per gateway until it is retried." << dendl;
+  }
+}
+
+void RateLimitSync::watch_stop()
+{
+  if (!watch_oid.empty()) {
+    pool_ctx.unwatch2(watch_handle);
+    pool_ctx.close();
+    watch_oid.clear();
+  }
+}
+
+void RateLimitSync::send(std::vector<RateLimitUsage>&& usage)
+{
+  using ceph::encode;
+  bufferlist bl;
+  encode(usage, bl);
+
+  // nobody waits for the acks: a gateway that misses a round of usage
+  // only limits a little less strictly until the next one
+  std::lock_guard l{mutex};
+  if (watch_oid.empty()) {
+    return;
+  }
+  auto c = librados::Rados::aio_create_completion();
+  int r = pool_ctx.aio_notify(watch_oid, c, bl,
+                              std::chrono::milliseconds(interval).count(),
+                              nullptr);
+  c->release();
+  if (r < 0) {
+    lderr(cct) << "Failed to send rate limit usage with "
+        << cpp_strerror(-r) << dendl;
+  }
+}
+
+void RateLimitSync::run()
+{
+  // keys are trimmed only after their minute has drained
+  constexpr auto idle = std::chrono::minutes(2);
+  constexpr auto trim_interval = std::chrono::seconds(30);
+
+  auto next_trim = RateLimiter::clock::now() + trim_interval;
+  std::unique_lock l{mutex};
+  while (!stopping) {
+    // until the watch is up, wake up to trim and to retry it
+    const auto wait = watch_oid.empty() ? trim_interval : interval;
+    cond.wait_for(l, wait, [this] { return stopping; });
+    if (stopping) {
+      break;
+    }
+    l.unlock();
+
+    maybe_watch_start();
+    auto usage = limiter.collect();
+    if (!usage.empty()) {
+      send(std::move(usage));
+    }
+    const auto now = RateLimiter::clock::now();
+    if (now >= next_trim) {
+      limiter.trim(now, idle);
+      next_trim = now + trim_interval;
+    }
+
+    l.lock();
+  }
+}
+
+} // namespace rgw
@@ -0,0 +1,181 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab ft=cpp
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "include/encoding.h"
+#include "include/rados/librados.hpp"
+#include "common/ceph_context.h"
+#include "common/ceph_time.h"
+#include "common/config_obs.h"
+#include "common/dout.h"
+#include "rgw_basic_types.h"
+
+namespace rgw {
+
+/// per-minute limits of a user or bucket, 0 meaning unlimited
+struct RateLimits {
+  uint64_t read_ops = 0;
+  uint64_t write_ops = 0;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+
+  bool enabled() const {
+    return read_ops || write_ops || read_bytes || write_bytes;
+  }
+};
+
+/// what a gateway consumed of one limit key since its last sync
+struct RateLimitUsage {
+  std::string key;
+  uint64_t read_ops = 0;
+  uint64_t write_ops = 0;
+  uint64_t read_bytes = 0;
+  uint64_t write_bytes = 0;
+
+  void encode(bufferlist& bl) const {
+    ENCODE_START(1, 1, bl);
+    encode(key, bl);
+    encode(read_ops, bl);
+    encode(write_ops, bl);
+    encode(read_bytes, bl);
+    encode(write_bytes, bl);
+    ENCODE_FINISH(bl);
+  }
+  void decode(bufferlist::const_iterator& bl) {
+    DECODE_START(1, bl);
+    decode(key, bl);
+    decode(read_ops, bl);
+    decode(write_ops, bl);
+    decode(read_bytes, bl);
+    decode(write_bytes, bl);
+    DECODE_FINISH(bl);
+  }
+};
+WRITE_CLASS_ENCODER(RateLimitUsage)
+
+/**
+ * RateLimiter keeps a token bucket per limit key ("user:<id>" or
+ * "bucket:<tenant/name>") for read and write requests and bytes. A bucket
+ * is kept as the amount consumed, which drains at the configured rate, so
+ * consumption reported by other gateways can be added to it no matter what
+ * its limits are. Keys are spread over lock stripes so that requests for
+ * different users and buckets rarely contend.
+ */
+class RateLimiter : public md_config_obs_t {
+ public:
+  using clock = ceph::coarse_mono_clock;
+  static constexpr size_t num_stripes = 64;
+
+  explicit RateLimiter(CephContext *cct);
+  ~RateLimiter() override;
+
+  RateLimits get_user_limits() const;
+  RateLimits get_bucket_limits() const;
+  /// whether any user or bucket limit is configured
+  bool enabled() const;
+
+  /// admit a request for the key, unless its requests or bytes for the
+  /// minute are used up. returns false if it should be rejected
+  bool acquire(const std::string& key, const RateLimits& limits,
+               bool is_read, clock::time_point now);
+  /// charge the bytes transferred by a request acquire() admitted
+  void charge(const std::string& key, bool is_read, uint64_t bytes);
+
+  /// add consumption reported by another gateway. keys this gateway hasn't
+  /// seen are skipped, as they have nothing to limit here yet
+  void apply(const RateLimitUsage& usage);
+  /// return and reset the local consumption since the last call
+  std::vector<RateLimitUsage> collect();
+  /// drop keys that have fully drained and were idle for the given duration
+  void trim(clock::time_point now, clock::duration idle);
+
+  size_t size() const;
+
+  const char** get_tracked_conf_keys() const override;
+  void handle_conf_change(const ConfigProxy& conf,
+                          const std::set<std::string>& changed) override;
+
+ private:
+  enum { read_ops, write_ops, read_bytes, write_bytes, num_counters };
+
+  struct Entry {
+    std::array<double, num_counters> level{}; //< consumed, not yet drained
+    std::array<double, num_counters> rate{}; //< drained per second
+    std::array<uint64_t, num_counters> pending{}; //< not yet synced
+    clock::time_point last; //< last drained
+    clock::time_point seen; //< last acquired
+
+    void drain(clock::time_point now);
+  };
+
+  struct alignas(64) Stripe {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  Stripe& stripe_for(const std::string& key);
+
+  CephContext *const cct;
+  std::array<Stripe, num_stripes> stripes;
+
+  mutable std::mutex config_mutex;
+  RateLimits user_limits;
+  RateLimits bucket_limits;
+
+  void update(const ConfigProxy& conf);
+};
+
+/**
+ * RateLimitSync periodically sends the local consumption of a RateLimiter
+ * to the other gateways of the zone with a notify on a shared control
+ * object, and adds theirs as it's received. It also trims idle keys from
+ * the limiter. The watch is only set up once a limit is configured.
+ */
+class RateLimitSync : public librados::WatchCtx2 {
+ public:
+  RateLimitSync(const DoutPrefixProvider *dpp, CephContext *cct,
+                RateLimiter& limiter, const rgw_pool& pool,
+                const std::string& zone_id);
+  ~RateLimitSync() override;
+
+  void handle_notify(uint64_t notify_id, uint64_t cookie,
+                     uint64_t notifier_id, bufferlist& bl) override;
+  void handle_error(uint64_t cookie, int err) override;
+
+ private:
+  CephContext *const cct;
+  const DoutPrefixProvider *const dpp;
+  RateLimiter& limiter;
+  const rgw_pool pool;
+  const std::string oid;
+  const std::chrono::seconds interval;
+
+  /// a separate Rados client, so the sync outlives realm reconfiguration
+  librados::Rados rados;
+  bool connected = false;
+  librados::IoCtx pool_ctx;
+  uint64_t watch_handle = 0;
+  std::string watch_oid;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool stopping = false;
+  std::thread thread;
+
+  int watch_start();
+  void maybe_watch_start();
+  void watch_stop();
+  void run();
+  void send(std::vector<RateLimitUsage>&& usage);
+};
+
+} // namespace rgw
@@ -276,12 +276,12 @@ int RGWRESTConn::get_obj(const DoutPrefixProvider *dpp, const rgw::sal::Object*
     /* add original headers that start with HTTP_X_AMZ_ */
     static constexpr char SEARCH_AMZ_PREFIX[] = "HTTP_X_AMZ_";
     for (auto iter= orig_map.lower_bound(SEARCH_AMZ_PREFIX); iter != orig_map.end(); ++iter) {
-      const string& name = iter->first;
+      const auto& name = iter->first;
       if (name == "HTTP_X_AMZ_DATE") /* don't forward date from original request */
         continue;
       if (name.compare(0, strlen(SEARCH_AMZ_PREFIX), SEARCH_AMZ_PREFIX) != 0)
         break;
-      extra_headers[iter->first] = iter->second;
+      extra_headers[std::string(name)] = iter->second;
     }
   }
 
@@ -3,6 +3,7 @@
 
 #include <errno.h>
 #include <array>
+#include <optional>
 #include <string.h>
 #include <string_view>
 
@@ -4267,6 +4268,52 @@ void RGWGetBucketPublicAccessBlock_ObjStore_S3::send_response()
   rgw_flush_formatter_and_reset(s, s->formatter);
 }
 
+namespace {
+
+/* an entry of the op table of a handler method: requests with the query
+ * param get the op it creates, which may be null to reject them */
+template <typename Handler>
+struct S3OpRoute {
+  RGWQueryParam param;
+  RGWOp* (*create)(Handler *h);
+};
+
+template <typename Op, typename Handler>
+RGWOp* s3_new_op(Handler*)
+{
+  return new Op;
+}
+
+template <typename Handler, size_t N>
+constexpr uint64_t s3_route_mask(const S3OpRoute<Handler> (&routes)[N])
+{
+  uint64_t mask = 0;
+  for (const auto& r : routes) {
+    mask |= rgw_query_param_bit(r.param);
+  }
+  return mask;
+}
+
+/* the routes are in order of precedence. most requests carry none of the
+ * params, and are sent to the default op of the method after a single test
+ * of the bits RGWHTTPArgs collected while parsing */
+template <typename Handler, size_t N>
+std::optional<RGWOp*> s3_route_op(Handler *h, uint64_t params,
+                                  const S3OpRoute<Handler> (&routes)[N])
+{
+  if (!(params & s3_route_mask(routes))) {
+    return std::nullopt;
+  }
+  for (const auto& r : routes) {
+    if (params & rgw_query_param_bit(r.param)) {
+      return r.create(h);
+    }
+  }
+  return std::nullopt;
+}
+
+} // anonymous namespace
+
 RGWOp *RGWHandler_REST_Service_S3::op_get()
 {
   if (is_usage_op()) {
@@ -4344,164 +4391,142 @@ RGWOp *RGWHandler_REST_Bucket_S3::get_obj_op(bool get_data) const
   }
 }
 
-RGWOp *RGWHandler_REST_Bucket_S3::op_get()
+uint64_t RGWHandler_REST_Bucket_S3::get_query_params() const
 {
-  if (s->info.args.sub_resource_exists("encryption"))
-    return nullptr;
-
-  if (s->info.args.sub_resource_exists("logging"))
-    return new RGWGetBucketLogging_ObjStore_S3;
-
-  if (s->info.args.sub_resource_exists("location"))
-    return new RGWGetBucketLocation_ObjStore_S3;
-
-  if (s->info.args.sub_resource_exists("versioning"))
-    return new RGWGetBucketVersioning_ObjStore_S3;
+  uint64_t params = s->info.args.get_query_params();
+  if (!enable_pubsub) {
+    params &= ~rgw_query_param_bit(RGW_QP_NOTIFICATION);
+  }
+  return params;
+}
 
-  if (s->info.args.sub_resource_exists("website")) {
-    if (!s->cct->_conf->rgw_enable_static_website) {
-      return NULL;
-    }
-    return new RGWGetBucketWebsite_ObjStore_S3;
-  }
-
-  if (s->info.args.exists("mdsearch")) {
-    return new RGWGetBucketMetaSearch_ObjStore_S3;
-  }
-
-  if (is_acl_op()) {
-    return new RGWGetACLs_ObjStore_S3;
-  } else if (is_cors_op()) {
-    return new RGWGetCORS_ObjStore_S3;
-  } else if (is_request_payment_op()) {
-    return new RGWGetRequestPayment_ObjStore_S3;
-  } else if (s->info.args.exists("uploads")) {
-    return new RGWListBucketMultiparts_ObjStore_S3;
-  } else if(is_lc_op()) {
-    return new RGWGetLC_ObjStore_S3;
-  } else if(is_policy_op()) {
-    return new RGWGetBucketPolicy;
-  } else if (is_tagging_op()) {
-    return new RGWGetBucketTags_ObjStore_S3;
-  } else if (is_object_lock_op()) {
-    return new RGWGetBucketObjectLock_ObjStore_S3;
-  } else if (is_notification_op()) {
-    return RGWHandler_REST_PSNotifs_S3::create_get_op();
-  } else if (is_replication_op()) {
-    return new RGWGetBucketReplication_ObjStore_S3;
-  } else if (is_policy_status_op()) {
-    return new RGWGetBucketPolicyStatus_ObjStore_S3;
-  } else if (is_block_public_access_op()) {
-    return new RGWGetBucketPublicAccessBlock_ObjStore_S3;
-  } else if (is_bucket_encryption_op()) {
-    return new RGWGetBucketEncryption_ObjStore_S3;
+RGWOp *RGWHandler_REST_Bucket_S3::op_get()
+{
+  using H = RGWHandler_REST_Bucket_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_LOGGING, s3_new_op<RGWGetBucketLogging_ObjStore_S3>},
+    {RGW_QP_LOCATION, s3_new_op<RGWGetBucketLocation_ObjStore_S3>},
+    {RGW_QP_VERSIONING, s3_new_op<RGWGetBucketVersioning_ObjStore_S3>},
+    {RGW_QP_WEBSITE, [] (H *h) -> RGWOp* {
+      if (!h->s->cct->_conf->rgw_enable_static_website) {
+        return nullptr;
+      }
+      return new RGWGetBucketWebsite_ObjStore_S3;
+    }},
+    {RGW_QP_MDSEARCH, s3_new_op<RGWGetBucketMetaSearch_ObjStore_S3>},
+    {RGW_QP_ACL, s3_new_op<RGWGetACLs_ObjStore_S3>},
+    {RGW_QP_CORS, s3_new_op<RGWGetCORS_ObjStore_S3>},
+    {RGW_QP_REQUEST_PAYMENT, s3_new_op<RGWGetRequestPayment_ObjStore_S3>},
+    {RGW_QP_UPLOADS, s3_new_op<RGWListBucketMultiparts_ObjStore_S3>},
+    {RGW_QP_LIFECYCLE, s3_new_op<RGWGetLC_ObjStore_S3>},
+    {RGW_QP_POLICY, s3_new_op<RGWGetBucketPolicy>},
+    {RGW_QP_TAGGING, s3_new_op<RGWGetBucketTags_ObjStore_S3>},
+    {RGW_QP_OBJECT_LOCK, s3_new_op<RGWGetBucketObjectLock_ObjStore_S3>},
+    {RGW_QP_NOTIFICATION, [] (H*) -> RGWOp* {
+      return RGWHandler_REST_PSNotifs_S3::create_get_op();
+    }},
+    {RGW_QP_REPLICATION, s3_new_op<RGWGetBucketReplication_ObjStore_S3>},
+    {RGW_QP_POLICY_STATUS, s3_new_op<RGWGetBucketPolicyStatus_ObjStore_S3>},
+    {RGW_QP_PUBLIC_ACCESS_BLOCK, s3_new_op<RGWGetBucketPublicAccessBlock_ObjStore_S3>},
+    {RGW_QP_ENCRYPTION, s3_new_op<RGWGetBucketEncryption_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, get_query_params(), routes); op) {
+    return *op;
   }
   return get_obj_op(true);
 }
 
 RGWOp *RGWHandler_REST_Bucket_S3::op_head()
 {
-  if (is_acl_op()) {
-    return new RGWGetACLs_ObjStore_S3;
-  } else if (s->info.args.exists("uploads")) {
-    return new RGWListBucketMultiparts_ObjStore_S3;
+  using H = RGWHandler_REST_Bucket_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_ACL, s3_new_op<RGWGetACLs_ObjStore_S3>},
+    {RGW_QP_UPLOADS, s3_new_op<RGWListBucketMultiparts_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, get_query_params(), routes); op) {
+    return *op;
   }
   return get_obj_op(false);
 }
 
 RGWOp *RGWHandler_REST_Bucket_S3::op_put()
 {
-  if (s->info.args.sub_resource_exists("logging") ||
-      s->info.args.sub_resource_exists("encryption"))
-    return nullptr;
-  if (s->info.args.sub_resource_exists("versioning"))
-    return new RGWSetBucketVersioning_ObjStore_S3;
-  if (s->info.args.sub_resource_exists("website")) {
-    if (!s->cct->_conf->rgw_enable_static_website) {
-      return NULL;
-    }
-    return new RGWSetBucketWebsite_ObjStore_S3;
-  }
-  if (is_tagging_op()) {
-    return new RGWPutBucketTags_ObjStore_S3;
-  } else if (is_acl_op()) {
-    return new RGWPutACLs_ObjStore_S3;
-  } else if (is_cors_op()) {
-    return new RGWPutCORS_ObjStore_S3;
-  } else if (is_request_payment_op()) {
-    return new RGWSetRequestPayment_ObjStore_S3;
-  } else if(is_lc_op()) {
-    return new RGWPutLC_ObjStore_S3;
-  } else if(is_policy_op()) {
-    return new RGWPutBucketPolicy;
-  } else if (is_object_lock_op()) {
-    return new RGWPutBucketObjectLock_ObjStore_S3;
-  } else if (is_notification_op()) {
-    return RGWHandler_REST_PSNotifs_S3::create_put_op();
-  } else if (is_replication_op()) {
-    auto sync_policy_handler = static_cast<rgw::sal::RadosStore*>(store)->svc()->zone->get_sync_policy_handler(nullopt);
-    if (!sync_policy_handler ||
-        sync_policy_handler->is_legacy_config()) {
-      return nullptr;
-    }
-
-    return new RGWPutBucketReplication_ObjStore_S3;
-  } else if (is_block_public_access_op()) {
-    return new RGWPutBucketPublicAccessBlock_ObjStore_S3;
-  } else if (is_bucket_encryption_op()) {
-    return new RGWPutBucketEncryption_ObjStore_S3;
+  using H = RGWHandler_REST_Bucket_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_LOGGING, [] (H*) -> RGWOp* { return nullptr; }},
+    {RGW_QP_VERSIONING, s3_new_op<RGWSetBucketVersioning_ObjStore_S3>},
+    {RGW_QP_WEBSITE, [] (H *h) -> RGWOp* {
+      if (!h->s->cct->_conf->rgw_enable_static_website) {
+        return nullptr;
+      }
+      return new RGWSetBucketWebsite_ObjStore_S3;
+    }},
+    {RGW_QP_TAGGING, s3_new_op<RGWPutBucketTags_ObjStore_S3>},
+    {RGW_QP_ACL, s3_new_op<RGWPutACLs_ObjStore_S3>},
+    {RGW_QP_CORS, s3_new_op<RGWPutCORS_ObjStore_S3>},
+    {RGW_QP_REQUEST_PAYMENT, s3_new_op<RGWSetRequestPayment_ObjStore_S3>},
+    {RGW_QP_LIFECYCLE, s3_new_op<RGWPutLC_ObjStore_S3>},
+    {RGW_QP_POLICY, s3_new_op<RGWPutBucketPolicy>},
+    {RGW_QP_OBJECT_LOCK, s3_new_op<RGWPutBucketObjectLock_ObjStore_S3>},
+    {RGW_QP_NOTIFICATION, [] (H*) -> RGWOp* {
+      return RGWHandler_REST_PSNotifs_S3::create_put_op();
+    }},
+    {RGW_QP_REPLICATION, [] (H *h) -> RGWOp* {
+      auto sync_policy_handler = static_cast<rgw::sal::RadosStore*>(h->store)->svc()->zone->get_sync_policy_handler(nullopt);
+      if (!sync_policy_handler ||
+          sync_policy_handler->is_legacy_config()) {
+        return nullptr;
+      }
+      return new RGWPutBucketReplication_ObjStore_S3;
+    }},
+    {RGW_QP_PUBLIC_ACCESS_BLOCK, s3_new_op<RGWPutBucketPublicAccessBlock_ObjStore_S3>},
+    {RGW_QP_ENCRYPTION, s3_new_op<RGWPutBucketEncryption_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, get_query_params(), routes); op) {
+    return *op;
   }
   return new RGWCreateBucket_ObjStore_S3;
 }
 
 RGWOp *RGWHandler_REST_Bucket_S3::op_delete()
 {
-  if (s->info.args.sub_resource_exists("logging") ||
-      s->info.args.sub_resource_exists("encryption"))
-    return nullptr;
-
-  if (is_tagging_op()) {
-    return new RGWDeleteBucketTags_ObjStore_S3;
-  } else if (is_cors_op()) {
-    return new RGWDeleteCORS_ObjStore_S3;
-  } else if(is_lc_op()) {
-    return new RGWDeleteLC_ObjStore_S3;
-  } else if(is_policy_op()) {
-    return new RGWDeleteBucketPolicy;
-  } else if (is_notification_op()) {
-    return RGWHandler_REST_PSNotifs_S3::create_delete_op();
-  } else if (is_replication_op()) {
-    return new RGWDeleteBucketReplication_ObjStore_S3;
-  } else if (is_block_public_access_op()) {
-    return new RGWDeleteBucketPublicAccessBlock;
-  } else if (is_bucket_encryption_op()) {
-    return new RGWDeleteBucketEncryption_ObjStore_S3;
-  }
-
-  if (s->info.args.sub_resource_exists("website")) {
-    if (!s->cct->_conf->rgw_enable_static_website) {
-      return NULL;
-    }
-    return new RGWDeleteBucketWebsite_ObjStore_S3;
-  }
-
-  if (s->info.args.exists("mdsearch")) {
-    return new RGWDelBucketMetaSearch_ObjStore_S3;
+  using H = RGWHandler_REST_Bucket_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_LOGGING, [] (H*) -> RGWOp* { return nullptr; }},
+    {RGW_QP_TAGGING, s3_new_op<RGWDeleteBucketTags_ObjStore_S3>},
+    {RGW_QP_CORS, s3_new_op<RGWDeleteCORS_ObjStore_S3>},
+    {RGW_QP_LIFECYCLE, s3_new_op<RGWDeleteLC_ObjStore_S3>},
+    {RGW_QP_POLICY, s3_new_op<RGWDeleteBucketPolicy>},
+    {RGW_QP_NOTIFICATION, [] (H*) -> RGWOp* {
+      return RGWHandler_REST_PSNotifs_S3::create_delete_op();
+    }},
+    {RGW_QP_REPLICATION, s3_new_op<RGWDeleteBucketReplication_ObjStore_S3>},
+    {RGW_QP_PUBLIC_ACCESS_BLOCK, s3_new_op<RGWDeleteBucketPublicAccessBlock>},
+    {RGW_QP_ENCRYPTION, s3_new_op<RGWDeleteBucketEncryption_ObjStore_S3>},
+    {RGW_QP_WEBSITE, [] (H *h) -> RGWOp* {
+      if (!h->s->cct->_conf->rgw_enable_static_website) {
+        return nullptr;
+      }
+      return new RGWDeleteBucketWebsite_ObjStore_S3;
+    }},
+    {RGW_QP_MDSEARCH, s3_new_op<RGWDelBucketMetaSearch_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, get_query_params(), routes); op) {
+    return *op;
   }
-
   return new RGWDeleteBucket_ObjStore_S3;
 }
 
 RGWOp *RGWHandler_REST_Bucket_S3::op_post()
 {
-  if (s->info.args.exists("delete")) {
-    return new RGWDeleteMultiObj_ObjStore_S3;
-  }
-
-  if (s->info.args.exists("mdsearch")) {
-    return new RGWConfigBucketMetaSearch_ObjStore_S3;
+  using H = RGWHandler_REST_Bucket_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_DELETE, s3_new_op<RGWDeleteMultiObj_ObjStore_S3>},
+    {RGW_QP_MDSEARCH, s3_new_op<RGWConfigBucketMetaSearch_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, get_query_params(), routes); op) {
+    return *op;
   }
-
   return new RGWPostObj_ObjStore_S3;
 }
 
@@ -4519,42 +4544,45 @@ RGWOp *RGWHandler_REST_Obj_S3::get_obj_op(bool get_data)
 
 RGWOp *RGWHandler_REST_Obj_S3::op_get()
 {
-  if (is_acl_op()) {
-    return new RGWGetACLs_ObjStore_S3;
-  } else if (s->info.args.exists("uploadId")) {
-    return new RGWListMultipart_ObjStore_S3;
-  } else if (s->info.args.exists("layout")) {
-    return new RGWGetObjLayout_ObjStore_S3;
-  } else if (is_tagging_op()) {
-    return new RGWGetObjTags_ObjStore_S3;
-  } else if (is_obj_retention_op()) {
-    return new RGWGetObjRetention_ObjStore_S3;
-  } else if (is_obj_legal_hold_op()) {
-    return new RGWGetObjLegalHold_ObjStore_S3;
+  using H = RGWHandler_REST_Obj_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_ACL, s3_new_op<RGWGetACLs_ObjStore_S3>},
+    {RGW_QP_UPLOAD_ID, s3_new_op<RGWListMultipart_ObjStore_S3>},
+    {RGW_QP_LAYOUT, s3_new_op<RGWGetObjLayout_ObjStore_S3>},
+    {RGW_QP_TAGGING, s3_new_op<RGWGetObjTags_ObjStore_S3>},
+    {RGW_QP_RETENTION, s3_new_op<RGWGetObjRetention_ObjStore_S3>},
+    {RGW_QP_LEGAL_HOLD, s3_new_op<RGWGetObjLegalHold_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, s->info.args.get_query_params(), routes); op) {
+    return *op;
   }
   return get_obj_op(true);
 }
 
 RGWOp *RGWHandler_REST_Obj_S3::op_head()
 {
-  if (is_acl_op()) {
-    return new RGWGetACLs_ObjStore_S3;
-  } else if (s->info.args.exists("uploadId")) {
-    return new RGWListMultipart_ObjStore_S3;
+  using H = RGWHandler_REST_Obj_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_ACL, s3_new_op<RGWGetACLs_ObjStore_S3>},
+    {RGW_QP_UPLOAD_ID, s3_new_op<RGWListMultipart_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, s->info.args.get_query_params(), routes); op) {
+    return *op;
   }
   return get_obj_op(false);
 }
 
 RGWOp *RGWHandler_REST_Obj_S3::op_put()
 {
-  if (is_acl_op()) {
-    return new RGWPutACLs_ObjStore_S3;
-  } else if (is_tagging_op()) {
-    return new RGWPutObjTags_ObjStore_S3;
-  } else if (is_obj_retention_op()) {
-    return new RGWPutObjRetention_ObjStore_S3;
-  } else if (is_obj_legal_hold_op()) {
-    return new RGWPutObjLegalHold_ObjStore_S3;
+  using H = RGWHandler_REST_Obj_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_ACL, s3_new_op<RGWPutACLs_ObjStore_S3>},
+    {RGW_QP_TAGGING, s3_new_op<RGWPutObjTags_ObjStore_S3>},
+    {RGW_QP_RETENTION, s3_new_op<RGWPutObjRetention_ObjStore_S3>},
+    {RGW_QP_LEGAL_HOLD, s3_new_op<RGWPutObjLegalHold_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, s->info.args.get_query_params(), routes); op) {
+    return *op;
   }
 
   if (s->init_state.src_bucket.empty())
@@ -4568,25 +4596,24 @@ RGWOp *RGWHandler_REST_Obj_S3::op_delete()
   if (is_tagging_op()) {
     return new RGWDeleteObjTags_ObjStore_S3;
   }
-  string upload_id = s->info.args.get("uploadId");
-
-  if (upload_id.empty())
-    return new RGWDeleteObj_ObjStore_S3;
-  else
+  if (s->info.args.exists(RGW_QP_UPLOAD_ID) &&
+      !s->info.args.get("uploadId").empty()) {
     return new RGWAbortMultipart_ObjStore_S3;
+  }
+  return new RGWDeleteObj_ObjStore_S3;
 }
 
 RGWOp *RGWHandler_REST_Obj_S3::op_post()
 {
-  if (s->info.args.exists("uploadId"))
-    return new RGWCompleteMultipart_ObjStore_S3;
-
-  if (s->info.args.exists("uploads"))
-    return new RGWInitMultipart_ObjStore_S3;
-  
-  if (is_select_op())
-    return new RGWSelectObj_ObjStore_S3;
-
+  using H = RGWHandler_REST_Obj_S3;
+  static constexpr S3OpRoute<H> routes[] = {
+    {RGW_QP_UPLOAD_ID, s3_new_op<RGWCompleteMultipart_ObjStore_S3>},
+    {RGW_QP_UPLOADS, s3_new_op<RGWInitMultipart_ObjStore_S3>},
+    {RGW_QP_SELECT_TYPE, s3_new_op<RGWSelectObj_ObjStore_S3>},
+  };
+  if (auto op = s3_route_op(this, s->info.args.get_query_params(), routes); op) {
+    return *op;
+  }
   return new RGWPostObj_ObjStore_S3;
 }
 
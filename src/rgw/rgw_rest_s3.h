@@ -670,7 +670,7 @@ protected:
   const bool isIAMEnabled;
   const bool isPSEnabled;
   bool is_usage_op() const {
-    return s->info.args.exists("usage");
+    return s->info.args.exists(RGW_QP_USAGE);
   }
   RGWOp *op_get() override;
   RGWOp *op_head() override;
@@ -686,48 +686,50 @@ class RGWHandler_REST_Bucket_S3 : public RGWHandler_REST_S3 {
   const bool enable_pubsub;
 protected:
   bool is_acl_op() const {
-    return s->info.args.exists("acl");
+    return s->info.args.exists(RGW_QP_ACL);
   }
   bool is_cors_op() const {
-      return s->info.args.exists("cors");
+      return s->info.args.exists(RGW_QP_CORS);
   }
   bool is_lc_op() const {
-      return s->info.args.exists("lifecycle");
+      return s->info.args.exists(RGW_QP_LIFECYCLE);
   }
   bool is_obj_update_op() const override {
     return is_acl_op() || is_cors_op();
   }
   bool is_tagging_op() const {
-    return s->info.args.exists("tagging");
+    return s->info.args.exists(RGW_QP_TAGGING);
   }
   bool is_request_payment_op() const {
-    return s->info.args.exists("requestPayment");
+    return s->info.args.exists(RGW_QP_REQUEST_PAYMENT);
   }
   bool is_policy_op() const {
-    return s->info.args.exists("policy");
+    return s->info.args.exists(RGW_QP_POLICY);
   }
   bool is_object_lock_op() const {
-    return s->info.args.exists("object-lock");
+    return s->info.args.exists(RGW_QP_OBJECT_LOCK);
   }
   bool is_notification_op() const {
     if (enable_pubsub) {
-        return s->info.args.exists("notification");
+        return s->info.args.exists(RGW_QP_NOTIFICATION);
     }
     return false;
   }
   bool is_replication_op() const {
-    return s->info.args.exists("replication");
+    return s->info.args.exists(RGW_QP_REPLICATION);
   }
   bool is_policy_status_op() {
-    return s->info.args.exists("policyStatus");
+    return s->info.args.exists(RGW_QP_POLICY_STATUS);
   }
   bool is_block_public_access_op() {
-    return s->info.args.exists("publicAccessBlock");
+    return s->info.args.exists(RGW_QP_PUBLIC_ACCESS_BLOCK);
   }
   bool is_bucket_encryption_op() {
-    return s->info.args.exists("encryption");
+    return s->info.args.exists(RGW_QP_ENCRYPTION);
   }
 
+  /// the RGWQueryParams of the request that this handler acts on
+  uint64_t get_query_params() const;
   RGWOp *get_obj_op(bool get_data) const;
   RGWOp *op_get() override;
   RGWOp *op_head() override;
@@ -744,20 +746,20 @@ public:
 class RGWHandler_REST_Obj_S3 : public RGWHandler_REST_S3 {
 protected:
   bool is_acl_op() const {
-    return s->info.args.exists("acl");
+    return s->info.args.exists(RGW_QP_ACL);
   }
   bool is_tagging_op() const {
-    return s->info.args.exists("tagging");
+    return s->info.args.exists(RGW_QP_TAGGING);
   }
   bool is_obj_retention_op() const {
-    return s->info.args.exists("retention");
+    return s->info.args.exists(RGW_QP_RETENTION);
   }
   bool is_obj_legal_hold_op() const {
-    return s->info.args.exists("legal-hold");
+    return s->info.args.exists(RGW_QP_LEGAL_HOLD);
   }
 
   bool is_select_op() const {
-    return s->info.args.exists("select-type");
+    return s->info.args.exists(RGW_QP_SELECT_TYPE);
   }
 
   bool is_obj_update_op() const override {
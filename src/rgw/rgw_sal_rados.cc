@@ -574,24 +574,27 @@ int RadosBucket::load_bucket(const DoutPrefixProvider* dpp, optional_yield y)
 
   RGWSI_MetaBackend_CtxParams bectx_params = RGWSI_MetaBackend_CtxParams_SObj(&obj_ctx);
   RGWObjVersionTracker ep_ot;
+  RGWSI_Bucket::bucket_info_snapshot e;
   if (info.bucket.bucket_id.empty()) {
-    ret = store->ctl()->bucket->read_bucket_info(info.bucket, &info, y, dpp,
+    ret = store->ctl()->bucket->read_bucket_info_snapshot(info.bucket, &e, y, dpp,
 				      RGWBucketCtl::BucketInstance::GetParams()
-				      .set_mtime(&mtime)
-				      .set_attrs(&attrs)
                                       .set_bectx_params(bectx_params),
 				      &ep_ot);
   } else {
-    ret  = store->ctl()->bucket->read_bucket_instance_info(info.bucket, &info, y, dpp,
+    ret  = store->ctl()->bucket->read_bucket_instance_snapshot(info.bucket, &e, y, dpp,
 				      RGWBucketCtl::BucketInstance::GetParams()
-				      .set_mtime(&mtime)
-				      .set_attrs(&attrs)
 				      .set_bectx_params(bectx_params));
   }
   if (ret != 0) {
     return ret;
   }
 
+  /* ops change the bucket's info and attrs in place, so it takes its own
+   * copy of the cached snapshot, the only one made for the request */
+  info = e->info;
+  mtime = e->mtime;
+  attrs = e->attrs;
+
   bucket_version = ep_ot.read_version;
 
   ret = store->ctl()->bucket->read_bucket_stats(info.bucket, &ent, y, dpp);
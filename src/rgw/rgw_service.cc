@@ -84,7 +84,7 @@ int RGWServices_Def::init(CephContext *cct,
   finisher->init();
   bi_rados->init(zone.get(), rados.get(), bilog_rados.get(), datalog_rados.get());
   bilog_rados->init(bi_rados.get());
-  bucket_sobj->init(zone.get(), sysobj.get(), sysobj_cache.get(),
+  bucket_sobj->init(zone.get(), rados.get(), sysobj.get(), sysobj_cache.get(),
                     bi_rados.get(), meta.get(), meta_be_sobj.get(),
                     sync_modules.get(), bucket_sync_sobj.get());
   bucket_sync_sobj->init(zone.get(),
@@ -6,7 +6,9 @@
 
 #include <errno.h>
 #include <stdlib.h>
+#include <strings.h>
 #include <limits.h>
+#include <algorithm>
 #include <string_view>
 #include <string>
 #include <stdexcept>
@@ -21,6 +23,20 @@ struct ltstr_nocase
   }
 };
 
+/* orders like ltstr_nocase, but lets maps be searched with a const char*
+ * or string_view without constructing a std::string for each lookup */
+struct ltstr_nocase_transparent
+{
+  using is_transparent = void;
+
+  bool operator()(std::string_view s1, std::string_view s2) const
+  {
+    const int r = strncasecmp(s1.data(), s2.data(),
+                              std::min(s1.size(), s2.size()));
+    return r < 0 || (r == 0 && s1.size() < s2.size());
+  }
+};
+
 static inline int stringcasecmp(const std::string& s1, const std::string& s2)
 {
   return strcasecmp(s1.c_str(), s2.c_str());
@@ -23,6 +23,7 @@
 
 #include "rgw_bucket.h"
 #include "rgw_quota.h"
+#include "rgw_perf_counters.h"
 
 #include "services/svc_zone.h"
 #include "services/svc_sys_obj.h"
@@ -2845,6 +2846,32 @@ int RGWUserCtl::remove_bucket(const DoutPrefixProvider *dpp,
   });
 }
 
+/* whether the bucket stats in the user's bucket list are recent enough to be
+ * used in place of the bucket indexes */
+static bool use_cached_bucket_stats(const DoutPrefixProvider *dpp,
+                                    RGWSI_User *user_svc,
+                                    RGWSI_MetaBackend::Context *ctx,
+                                    const rgw_user& user,
+                                    optional_yield y)
+{
+  const auto max_age = user_svc->ctx()->_conf.get_val<std::chrono::seconds>(
+    "rgw_list_buckets_cached_stats_max_age");
+  if (max_age.count() == 0) {
+    return false;
+  }
+
+  RGWStorageStats stats;
+  ceph::real_time last_stats_sync;
+  int ret = user_svc->read_stats(dpp, ctx, user, &stats, &last_stats_sync,
+                                 nullptr, y);
+  if (ret < 0) {
+    ldpp_dout(dpp, 10) << "WARNING: could not read user stats for user=" << user
+                       << ", reading bucket stats from the index: ret=" << ret << dendl;
+    return false;
+  }
+  return ceph::real_clock::now() - last_stats_sync < max_age;
+}
+
 int RGWUserCtl::list_buckets(const DoutPrefixProvider *dpp, 
                              const rgw_user& user,
                              const string& marker,
@@ -2868,11 +2895,16 @@ int RGWUserCtl::list_buckets(const DoutPrefixProvider *dpp,
     }
     if (need_stats) {
       map<string, RGWBucketEnt>& m = buckets->get_buckets();
-      ret = ctl.bucket->read_buckets_stats(m, y, dpp);
+      const bool cached_stats = use_cached_bucket_stats(dpp, svc.user, op->ctx(),
+                                                        user, y);
+      ret = ctl.bucket->read_buckets_stats(m, cached_stats, y, dpp);
       if (ret < 0 && ret != -ENOENT) {
         ldpp_dout(dpp, 0) << "ERROR: could not get stats for buckets" << dendl;
         return ret;
       }
+      if (ret >= 0 && cached_stats && perfcounter) {
+        perfcounter->inc(l_rgw_bucket_stats_cached, m.size());
+      }
     }
     return 0;
   });
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "rgw/rgw_service.h"
 
 class RGWBucketInfo;
@@ -37,6 +39,15 @@ public:
                          RGWBucketEnt *stats,
                          optional_yield y) = 0;
 
+  /* reads the stats of several buckets, with the index reads of all of them
+   * in flight together, at most max_aio at a time. returns the first error,
+   * after filling in the stats of the buckets whose reads succeeded */
+  virtual int read_stats(const DoutPrefixProvider *dpp,
+                         const std::vector<const RGWBucketInfo*>& bucket_infos,
+                         const std::vector<RGWBucketEnt*>& stats,
+                         uint32_t max_aio,
+                         optional_yield y) = 0;
+
   virtual int handle_overwrite(const DoutPrefixProvider *dpp, 
                                const RGWBucketInfo& info,
                                const RGWBucketInfo& orig_info) = 0;
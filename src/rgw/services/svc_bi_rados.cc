@@ -5,6 +5,7 @@
 #include "svc_bilog_rados.h"
 #include "svc_zone.h"
 
+#include "rgw/rgw_aio_throttle.h"
 #include "rgw/rgw_bucket.h"
 #include "rgw/rgw_zone.h"
 #include "rgw/rgw_datalog.h"
@@ -399,6 +400,83 @@ int RGWSI_BucketIndex_RADOS::read_stats(const DoutPrefixProvider *dpp,
   return 0;
 }
 
+int RGWSI_BucketIndex_RADOS::read_stats(const DoutPrefixProvider *dpp,
+                                        const vector<const RGWBucketInfo*>& bucket_infos,
+                                        const vector<RGWBucketEnt*>& stats,
+                                        uint32_t max_aio,
+                                        optional_yield y)
+{
+  /* the index shards of all the buckets, and the bucket each belongs to */
+  vector<RGWSI_RADOS::Obj> shards;
+  vector<size_t> shard_buckets;
+  vector<int> bucket_rets(bucket_infos.size(), 0);
+
+  for (size_t i = 0; i < bucket_infos.size(); ++i) {
+    const RGWBucketInfo& bucket_info = *bucket_infos[i];
+    RGWBucketEnt *result = stats[i];
+    result->bucket = bucket_info.bucket;
+    result->count = 0;
+    result->size = 0;
+    result->size_rounded = 0;
+    result->placement_rule = bucket_info.placement_rule;
+
+    RGWSI_RADOS::Pool index_pool;
+    map<int, string> oids;
+    int r = open_bucket_index(dpp, bucket_info, std::nullopt, &index_pool, &oids, nullptr);
+    if (r < 0) {
+      bucket_rets[i] = r;
+      continue;
+    }
+    for (auto& [shard_id, oid] : oids) {
+      shards.push_back(svc.rados->obj(index_pool, oid));
+      shard_buckets.push_back(i);
+    }
+  }
+
+  vector<rgw_cls_list_ret> list_results(shards.size());
+  auto aio = rgw::make_throttle(max_aio, y);
+  auto handle_completions = [&] (rgw::AioResultList&& completed) {
+    for (auto& e : completed) {
+      int& r = bucket_rets[shard_buckets[e.id]];
+      if (e.result < 0 && r == 0) {
+        r = e.result;
+      }
+    }
+  };
+  for (size_t j = 0; j < shards.size(); ++j) {
+    librados::ObjectReadOperation op;
+    cls_rgw_bucket_list_op(op, cls_rgw_obj_key(), string(), string(), 0, false,
+                           &list_results[j]);
+    handle_completions(aio->get(shards[j], rgw::Aio::librados_op(std::move(op), y),
+                                1, j));
+  }
+  handle_completions(aio->drain());
+
+  for (size_t j = 0; j < shards.size(); ++j) {
+    const size_t i = shard_buckets[j];
+    if (bucket_rets[i] < 0) {
+      continue;
+    }
+    const auto& header = list_results[j].dir.header;
+    auto iter = header.stats.find(RGWObjCategory::Main);
+    if (iter != header.stats.end()) {
+      const struct rgw_bucket_category_stats& s = iter->second;
+      stats[i]->count += s.num_entries;
+      stats[i]->size += s.total_size;
+      stats[i]->size_rounded += s.total_size_rounded;
+    }
+  }
+
+  for (size_t i = 0; i < bucket_rets.size(); ++i) {
+    if (bucket_rets[i] < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): failed to read the index of bucket="
+                        << bucket_infos[i]->bucket << " r=" << bucket_rets[i] << dendl;
+      return bucket_rets[i];
+    }
+  }
+  return 0;
+}
+
 int RGWSI_BucketIndex_RADOS::get_reshard_status(const DoutPrefixProvider *dpp, const RGWBucketInfo& bucket_info, list<cls_rgw_bucket_instance_entry> *status)
 {
   map<int, string> bucket_objs;
@@ -107,6 +107,12 @@ public:
                  RGWBucketEnt *stats,
                  optional_yield y) override;
 
+  int read_stats(const DoutPrefixProvider *dpp,
+                 const std::vector<const RGWBucketInfo*>& bucket_infos,
+                 const std::vector<RGWBucketEnt*>& stats,
+                 uint32_t max_aio,
+                 optional_yield y) override;
+
   int get_reshard_status(const DoutPrefixProvider *dpp, const RGWBucketInfo& bucket_info,
                          std::list<cls_rgw_bucket_instance_entry> *status);
 
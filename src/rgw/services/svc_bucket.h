@@ -24,6 +24,18 @@
 class RGWSI_Bucket : public RGWServiceInstance
 {
 public:
+  struct bucket_info_cache_entry {
+    RGWBucketInfo info;
+    real_time mtime;
+    std::map<std::string, bufferlist> attrs;
+  };
+
+  /* an immutable snapshot of a bucket instance, as held by the bucket info
+   * cache. readers that only look at the info share it instead of copying,
+   * and a refresh replaces the cached pointer, leaving readers with the
+   * snapshot they got */
+  using bucket_info_snapshot = std::shared_ptr<const bucket_info_cache_entry>;
+
   RGWSI_Bucket(CephContext *cct) : RGWServiceInstance(cct) {}
   virtual ~RGWSI_Bucket() {}
 
@@ -70,6 +82,14 @@ public:
                                 rgw_cache_entry_info *cache_info = nullptr,
                                 boost::optional<obj_version> refresh_version = boost::none) = 0;
 
+  virtual int read_bucket_instance_snapshot(RGWSI_Bucket_BI_Ctx& ctx,
+                                            const std::string& key,
+                                            bucket_info_snapshot *snapshot,
+                                            optional_yield y,
+                                            const DoutPrefixProvider *dpp,
+                                            rgw_cache_entry_info *cache_info = nullptr,
+                                            boost::optional<obj_version> refresh_version = boost::none) = 0;
+
   virtual int read_bucket_info(RGWSI_Bucket_X_Ctx& ep_ctx,
                        const rgw_bucket& bucket,
                        RGWBucketInfo *info,
@@ -79,6 +99,13 @@ public:
                        optional_yield y,
                        const DoutPrefixProvider *dpp) = 0;
 
+  virtual int read_bucket_info_snapshot(RGWSI_Bucket_X_Ctx& ep_ctx,
+                                        const rgw_bucket& bucket,
+                                        bucket_info_snapshot *snapshot,
+                                        boost::optional<obj_version> refresh_version,
+                                        optional_yield y,
+                                        const DoutPrefixProvider *dpp) = 0;
+
   virtual int store_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
                                  const std::string& key,
                                  RGWBucketInfo& info,
@@ -103,8 +130,11 @@ public:
                         optional_yield y,
                         const DoutPrefixProvider *dpp) = 0;
 
+  /* with cached_stats, the entries already hold the stats from the user's
+   * bucket list, and only their placement rule is filled in */
   virtual int read_buckets_stats(RGWSI_Bucket_X_Ctx& ctx,
                                  std::map<std::string, RGWBucketEnt>& m,
+                                 bool cached_stats,
                                  optional_yield y,
                                  const DoutPrefixProvider *dpp) = 0;
 };
@@ -4,6 +4,7 @@
 
 #include "svc_bucket_sobj.h"
 #include "svc_zone.h"
+#include "svc_rados.h"
 #include "svc_sys_obj.h"
 #include "svc_sys_obj_cache.h"
 #include "svc_bi.h"
@@ -11,6 +12,7 @@
 #include "svc_meta_be_sobj.h"
 #include "svc_sync_modules.h"
 
+#include "rgw/rgw_aio_throttle.h"
 #include "rgw/rgw_bucket.h"
 #include "rgw/rgw_tools.h"
 #include "rgw/rgw_zone.h"
@@ -144,7 +146,8 @@ RGWSI_Bucket_SObj::RGWSI_Bucket_SObj(CephContext *cct): RGWSI_Bucket(cct) {
 RGWSI_Bucket_SObj::~RGWSI_Bucket_SObj() {
 }
 
-void RGWSI_Bucket_SObj::init(RGWSI_Zone *_zone_svc, RGWSI_SysObj *_sysobj_svc,
+void RGWSI_Bucket_SObj::init(RGWSI_Zone *_zone_svc, RGWSI_RADOS *_rados_svc,
+                             RGWSI_SysObj *_sysobj_svc,
                              RGWSI_SysObj_Cache *_cache_svc, RGWSI_BucketIndex *_bi,
                              RGWSI_Meta *_meta_svc, RGWSI_MetaBackend *_meta_be_svc,
                              RGWSI_SyncModules *_sync_modules_svc,
@@ -152,6 +155,7 @@ void RGWSI_Bucket_SObj::init(RGWSI_Zone *_zone_svc, RGWSI_SysObj *_sysobj_svc,
 {
   svc.bucket = this;
   svc.zone = _zone_svc;
+  svc.rados = _rados_svc;
   svc.sysobj = _sysobj_svc;
   svc.cache = _cache_svc;
   svc.bi = _bi;
@@ -163,7 +167,7 @@ void RGWSI_Bucket_SObj::init(RGWSI_Zone *_zone_svc, RGWSI_SysObj *_sysobj_svc,
 
 int RGWSI_Bucket_SObj::do_start(optional_yield, const DoutPrefixProvider *dpp)
 {
-  binfo_cache.reset(new RGWChainedCacheImpl<bucket_info_cache_entry>);
+  binfo_cache.reset(new RGWChainedCacheImpl_bucket_info_cache_entry);
   binfo_cache->init(svc.cache);
 
   /* create first backend handler for bucket entrypoints */
@@ -277,35 +281,55 @@ int RGWSI_Bucket_SObj::read_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
                                                  const DoutPrefixProvider *dpp,
                                                  rgw_cache_entry_info *cache_info,
                                                  boost::optional<obj_version> refresh_version)
+{
+  bucket_info_snapshot e;
+  int ret = read_bucket_instance_snapshot(ctx, key, &e, y, dpp,
+                                          cache_info, refresh_version);
+  if (ret < 0) {
+    *info = RGWBucketInfo();
+    return ret;
+  }
+
+  *info = e->info;
+  if (pmtime) {
+    *pmtime = e->mtime;
+  }
+  if (pattrs) {
+    *pattrs = e->attrs;
+  }
+  return 0;
+}
+
+int RGWSI_Bucket_SObj::read_bucket_instance_snapshot(RGWSI_Bucket_BI_Ctx& ctx,
+                                                     const string& key,
+                                                     bucket_info_snapshot *snapshot,
+                                                     optional_yield y,
+                                                     const DoutPrefixProvider *dpp,
+                                                     rgw_cache_entry_info *cache_info,
+                                                     boost::optional<obj_version> refresh_version)
 {
   string cache_key("bi/");
   cache_key.append(key);
 
   if (auto e = binfo_cache->find(cache_key)) {
     if (refresh_version &&
-        e->info.objv_tracker.read_version.compare(&(*refresh_version))) {
+        (*e)->info.objv_tracker.read_version.compare(&(*refresh_version))) {
       ldpp_dout(dpp, -1) << "WARNING: The bucket info cache is inconsistent. This is "
         << "a failure that should be debugged. I am a nice machine, "
         << "so I will try to recover." << dendl;
-      binfo_cache->invalidate(key);
+      binfo_cache->invalidate(cache_key);
     } else {
-      *info = e->info;
-      if (pattrs)
-	*pattrs = e->attrs;
-      if (pmtime)
-	*pmtime = e->mtime;
+      *snapshot = std::move(*e);
       return 0;
     }
   }
 
-  bucket_info_cache_entry e;
+  auto e = std::make_shared<bucket_info_cache_entry>();
   rgw_cache_entry_info ci;
 
   int ret = do_read_bucket_instance_info(ctx, key,
-                                  &e.info, &e.mtime, &e.attrs,
+                                  &e->info, &e->mtime, &e->attrs,
                                   &ci, refresh_version, y, dpp);
-  *info = e.info;
-
   if (ret < 0) {
     if (ret != -ENOENT) {
       ldpp_dout(dpp, -1) << "ERROR: do_read_bucket_instance_info failed: " << ret << dendl;
@@ -315,28 +339,25 @@ int RGWSI_Bucket_SObj::read_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
     return ret;
   }
 
-  if (pmtime) {
-    *pmtime = e.mtime;
-  }
-  if (pattrs) {
-    *pattrs = e.attrs;
-  }
   if (cache_info) {
     *cache_info = ci;
   }
 
+  bucket_info_snapshot entry = std::move(e);
+
   /* chain to only bucket instance and *not* bucket entrypoint */
-  if (!binfo_cache->put(dpp, svc.cache, cache_key, &e, {&ci})) {
+  if (!binfo_cache->put(dpp, svc.cache, cache_key, &entry, {&ci})) {
     ldpp_dout(dpp, 20) << "couldn't put binfo cache entry, might have raced with data changes" << dendl;
   }
 
   if (refresh_version &&
-      refresh_version->compare(&info->objv_tracker.read_version)) {
+      *refresh_version == entry->info.objv_tracker.read_version) {
     ldpp_dout(dpp, -1) << "WARNING: The OSD has the same version I have. Something may "
                << "have gone squirrelly. An administrator may have forced a "
                << "change; otherwise there is a problem somewhere." << dendl;
   }
 
+  *snapshot = std::move(entry);
   return 0;
 }
 
@@ -379,16 +400,39 @@ int RGWSI_Bucket_SObj::read_bucket_info(RGWSI_Bucket_X_Ctx& ctx,
                                         boost::optional<obj_version> refresh_version,
                                         optional_yield y,
                                         const DoutPrefixProvider *dpp)
+{
+  bucket_info_snapshot e;
+  int ret = read_bucket_info_snapshot(ctx, bucket, &e, refresh_version, y, dpp);
+  if (ret < 0) {
+    /* only init these fields */
+    *info = RGWBucketInfo();
+    info->bucket = bucket;
+    return ret;
+  }
+
+  *info = e->info;
+  if (pmtime) {
+    *pmtime = e->mtime;
+  }
+  if (pattrs) {
+    *pattrs = e->attrs;
+  }
+  return 0;
+}
+
+int RGWSI_Bucket_SObj::read_bucket_info_snapshot(RGWSI_Bucket_X_Ctx& ctx,
+                                                 const rgw_bucket& bucket,
+                                                 bucket_info_snapshot *snapshot,
+                                                 boost::optional<obj_version> refresh_version,
+                                                 optional_yield y,
+                                                 const DoutPrefixProvider *dpp)
 {
   rgw_cache_entry_info cache_info;
 
   if (!bucket.bucket_id.empty()) {
-    return read_bucket_instance_info(ctx.bi, get_bi_meta_key(bucket),
-                                     info,
-                                     pmtime, pattrs,
-                                     y,
-                                     dpp,
-                                     &cache_info, refresh_version);
+    return read_bucket_instance_snapshot(ctx.bi, get_bi_meta_key(bucket),
+                                         snapshot, y, dpp,
+                                         &cache_info, refresh_version);
   }
 
   string bucket_entry = get_entrypoint_meta_key(bucket);
@@ -396,92 +440,80 @@ int RGWSI_Bucket_SObj::read_bucket_info(RGWSI_Bucket_X_Ctx& ctx,
   cache_key.append(bucket_entry);
 
   if (auto e = binfo_cache->find(cache_key)) {
+    const auto& entry = **e;
     bool found_version = (bucket.bucket_id.empty() ||
-                          bucket.bucket_id == e->info.bucket.bucket_id);
+                          bucket.bucket_id == entry.info.bucket.bucket_id);
 
     if (!found_version ||
         (refresh_version &&
-         e->info.objv_tracker.read_version.compare(&(*refresh_version)))) {
+         entry.info.objv_tracker.read_version.compare(&(*refresh_version)))) {
       ldpp_dout(dpp, -1) << "WARNING: The bucket info cache is inconsistent. This is "
         << "a failure that should be debugged. I am a nice machine, "
         << "so I will try to recover." << dendl;
       binfo_cache->invalidate(cache_key);
     } else {
-      *info = e->info;
-      if (pattrs)
-	*pattrs = e->attrs;
-      if (pmtime)
-	*pmtime = e->mtime;
+      *snapshot = std::move(*e);
       return 0;
     }
   }
 
   RGWBucketEntryPoint entry_point;
   real_time ep_mtime;
+  map<string, bufferlist> ep_attrs;
   RGWObjVersionTracker ot;
   rgw_cache_entry_info entry_cache_info;
   int ret = read_bucket_entrypoint_info(ctx.ep, bucket_entry,
-                                        &entry_point, &ot, &ep_mtime, pattrs,
+                                        &entry_point, &ot, &ep_mtime, &ep_attrs,
                                         y,
                                         dpp,
                                         &entry_cache_info, refresh_version);
   if (ret < 0) {
-    /* only init these fields */
-    info->bucket = bucket;
     return ret;
   }
 
   if (entry_point.has_bucket_info) {
-    *info = entry_point.old_bucket_info;
-    info->bucket.tenant = bucket.tenant;
-    ldpp_dout(dpp, 20) << "rgw_get_bucket_info: old bucket info, bucket=" << info->bucket << " owner " << info->owner << dendl;
+    auto e = std::make_shared<bucket_info_cache_entry>();
+    e->info = std::move(entry_point.old_bucket_info);
+    e->info.bucket.tenant = bucket.tenant;
+    e->mtime = ep_mtime;
+    e->attrs = std::move(ep_attrs);
+    ldpp_dout(dpp, 20) << "rgw_get_bucket_info: old bucket info, bucket=" << e->info.bucket << " owner " << e->info.owner << dendl;
+    *snapshot = std::move(e);
     return 0;
   }
 
-  /* data is in the bucket instance object, we need to get attributes from there, clear everything
-   * that we got
-   */
-  if (pattrs) {
-    pattrs->clear();
-  }
+  /* data is in the bucket instance object, attributes come from there too */
 
   ldpp_dout(dpp, 20) << "rgw_get_bucket_info: bucket instance: " << entry_point.bucket << dendl;
 
 
   /* read bucket instance info */
 
-  bucket_info_cache_entry e;
+  bucket_info_snapshot e;
 
-  ret = read_bucket_instance_info(ctx.bi, get_bi_meta_key(entry_point.bucket),
-                                  &e.info, &e.mtime, &e.attrs,
-                                  y,
-                                  dpp,
-                                  &cache_info, refresh_version);
-  *info = e.info;
+  ret = read_bucket_instance_snapshot(ctx.bi, get_bi_meta_key(entry_point.bucket),
+                                      &e, y, dpp,
+                                      &cache_info, refresh_version);
   if (ret < 0) {
     ldpp_dout(dpp, -1) << "ERROR: read_bucket_instance_from_oid failed: " << ret << dendl;
-    info->bucket = bucket;
     // XXX and why return anything in case of an error anyway?
     return ret;
   }
 
-  if (pmtime)
-    *pmtime = e.mtime;
-  if (pattrs)
-    *pattrs = e.attrs;
-
-  /* chain to both bucket entry point and bucket instance */
+  /* chain to both bucket entry point and bucket instance, sharing the
+   * instance's snapshot */
   if (!binfo_cache->put(dpp, svc.cache, cache_key, &e, {&entry_cache_info, &cache_info})) {
     ldpp_dout(dpp, 20) << "couldn't put binfo cache entry, might have raced with data changes" << dendl;
   }
 
   if (refresh_version &&
-      refresh_version->compare(&info->objv_tracker.read_version)) {
+      *refresh_version == e->info.objv_tracker.read_version) {
     ldpp_dout(dpp, -1) << "WARNING: The OSD has the same version I have. Something may "
                << "have gone squirrelly. An administrator may have forced a "
                << "change; otherwise there is a problem somewhere." << dendl;
   }
 
+  *snapshot = std::move(e);
   return 0;
 }
 
@@ -625,17 +657,159 @@ int RGWSI_Bucket_SObj::read_bucket_stats(RGWSI_Bucket_X_Ctx& ctx,
   return read_bucket_stats(bucket_info, ent, y, dpp);
 }
 
+int RGWSI_Bucket_SObj::read_shared_bucket_info(RGWSI_Bucket_X_Ctx& ctx,
+                                               const rgw_bucket& bucket,
+                                               std::shared_ptr<const RGWBucketInfo> *info,
+                                               optional_yield y,
+                                               const DoutPrefixProvider *dpp)
+{
+  if (!bucket.bucket_id.empty()) {
+    bucket_info_snapshot e;
+    int ret = read_bucket_instance_snapshot(ctx.bi, get_bi_meta_key(bucket),
+                                            &e, y, dpp);
+    if (ret < 0) {
+      return ret;
+    }
+    *info = std::shared_ptr<const RGWBucketInfo>(e, &e->info);
+    return 0;
+  }
+
+  auto bucket_info = std::make_shared<RGWBucketInfo>();
+  int ret = read_bucket_info(ctx, bucket, bucket_info.get(), nullptr, nullptr,
+                             boost::none, y, dpp);
+  if (ret < 0) {
+    return ret;
+  }
+  *info = std::move(bucket_info);
+  return 0;
+}
+
+int RGWSI_Bucket_SObj::read_bucket_instances(const vector<const rgw_bucket*>& buckets,
+                                             vector<std::shared_ptr<const RGWBucketInfo>> *infos,
+                                             uint32_t max_aio,
+                                             optional_yield y,
+                                             const DoutPrefixProvider *dpp)
+{
+  auto module = static_cast<RGWSI_MBSObj_Handler_Module *>(bi_be_module.get());
+  vector<int> rets(buckets.size(), 0);
+  infos->resize(buckets.size());
+
+  auto aio = rgw::make_throttle(max_aio, y);
+  auto handle_completions = [&] (rgw::AioResultList&& completed) {
+    for (auto& e : completed) {
+      if (e.result < 0) {
+        rets[e.id] = e.result;
+        continue;
+      }
+      auto info = std::make_shared<RGWBucketInfo>();
+      auto iter = e.data.cbegin();
+      try {
+        decode(*info, iter);
+      } catch (buffer::error& err) {
+        ldpp_dout(dpp, 0) << "ERROR: could not decode buffer info, caught buffer::error" << dendl;
+        rets[e.id] = -EIO;
+        continue;
+      }
+      (*infos)[e.id] = std::move(info);
+    }
+  };
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    rgw_pool pool;
+    string oid;
+    module->get_pool_and_oid(get_bi_meta_key(*buckets[i]), &pool, &oid);
+
+    auto obj = svc.rados->obj(rgw_raw_obj(pool, oid));
+    int r = obj.open(dpp);
+    if (r < 0) {
+      rets[i] = r;
+      continue;
+    }
+    librados::ObjectReadOperation op;
+    op.read(0, 0, nullptr, nullptr);
+    handle_completions(aio->get(obj, rgw::Aio::librados_op(std::move(op), y),
+                                1, i));
+  }
+  handle_completions(aio->drain());
+
+  for (size_t i = 0; i < rets.size(); ++i) {
+    if (rets[i] == -ENOENT) {
+      ldpp_dout(dpp, 20) << __func__ << "(): bucket instance not found (bucket=" << *buckets[i] << ")" << dendl;
+      return rets[i];
+    }
+    if (rets[i] < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): failed to read bucket instance of bucket="
+                        << *buckets[i] << " r=" << rets[i] << dendl;
+      return rets[i];
+    }
+  }
+  return 0;
+}
+
 int RGWSI_Bucket_SObj::read_buckets_stats(RGWSI_Bucket_X_Ctx& ctx,
                                           map<string, RGWBucketEnt>& m,
+                                          bool cached_stats,
                                           optional_yield y,
                                           const DoutPrefixProvider *dpp)
 {
-  map<string, RGWBucketEnt>::iterator iter;
-  for (iter = m.begin(); iter != m.end(); ++iter) {
-    RGWBucketEnt& ent = iter->second;
-    int r = read_bucket_stats(ctx, ent.bucket, &ent, y, dpp);
+  const auto max_aio = cct->_conf.get_val<uint64_t>("rgw_list_buckets_stats_max_aio");
+
+  /* the buckets' infos, in the order of m */
+  vector<std::shared_ptr<const RGWBucketInfo>> infos;
+  vector<RGWBucketEnt*> ents;
+  infos.reserve(m.size());
+  ents.reserve(m.size());
+
+  /* the buckets whose instance isn't cached, to be read together */
+  vector<const rgw_bucket*> missed;
+  vector<size_t> missed_pos;
+
+  for (auto& [name, ent] : m) {
+    std::shared_ptr<const RGWBucketInfo> info;
+    if (ent.bucket.bucket_id.empty()) {
+      int r = read_shared_bucket_info(ctx, ent.bucket, &info, y, dpp);
+      if (r < 0) {
+        ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): read_bucket_info returned r=" << r << dendl;
+        return r;
+      }
+    } else if (auto e = binfo_cache->find("bi/" + get_bi_meta_key(ent.bucket))) {
+      info = std::shared_ptr<const RGWBucketInfo>(*e, &(*e)->info);
+    } else {
+      missed.push_back(&ent.bucket);
+      missed_pos.push_back(infos.size());
+    }
+    infos.push_back(std::move(info));
+    ents.push_back(&ent);
+  }
+
+  if (!missed.empty()) {
+    vector<std::shared_ptr<const RGWBucketInfo>> missed_infos;
+    int r = read_bucket_instances(missed, &missed_infos, max_aio, y, dpp);
+    if (r < 0) {
+      ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): read_bucket_instances returned r=" << r << dendl;
+      return r;
+    }
+    for (size_t i = 0; i < missed.size(); ++i) {
+      infos[missed_pos[i]] = std::move(missed_infos[i]);
+    }
+  }
+
+  if (cached_stats) {
+    for (size_t i = 0; i < ents.size(); ++i) {
+      ents[i]->placement_rule = infos[i]->placement_rule;
+    }
+    return m.size();
+  }
+
+  if (!ents.empty()) {
+    /* read the index headers of all the buckets together */
+    vector<const RGWBucketInfo*> bucket_infos;
+    bucket_infos.reserve(infos.size());
+    for (const auto& info : infos) {
+      bucket_infos.push_back(info.get());
+    }
+    int r = svc.bi->read_stats(dpp, bucket_infos, ents, max_aio, y);
     if (r < 0) {
-      ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): read_bucket_stats returned r=" << r << dendl;
+      ldpp_dout(dpp, 0) << "ERROR: " << __func__ << "(): read_stats returned r=" << r << dendl;
       return r;
     }
   }
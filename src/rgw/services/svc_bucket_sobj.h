@@ -24,6 +24,7 @@
 #include "svc_bucket.h"
 
 class RGWSI_Zone;
+class RGWSI_RADOS;
 class RGWSI_SysObj;
 class RGWSI_SysObj_Cache;
 class RGWSI_Meta;
@@ -37,15 +38,6 @@ class RGWChainedCacheImpl;
 
 class RGWSI_Bucket_SObj : public RGWSI_Bucket
 {
-  struct bucket_info_cache_entry {
-    RGWBucketInfo info;
-    real_time mtime;
-    std::map<std::string, bufferlist> attrs;
-  };
-
-  using RGWChainedCacheImpl_bucket_info_cache_entry = RGWChainedCacheImpl<bucket_info_cache_entry>;
-  std::unique_ptr<RGWChainedCacheImpl_bucket_info_cache_entry> binfo_cache;
-
   RGWSI_Bucket_BE_Handler ep_be_handler;
   std::unique_ptr<RGWSI_MetaBackend::Module> ep_be_module;
   RGWSI_BucketInstance_BE_Handler bi_be_handler;
@@ -53,26 +45,50 @@ class RGWSI_Bucket_SObj : public RGWSI_Bucket
 
   int do_start(optional_yield, const DoutPrefixProvider *dpp) override;
 
-  int do_read_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
-                                   const std::string& key,
-                                   RGWBucketInfo *info,
-                                   real_time *pmtime,
-                                   std::map<std::string, bufferlist> *pattrs,
-                                   rgw_cache_entry_info *cache_info,
-                                   boost::optional<obj_version> refresh_version,
-                                   optional_yield y,
-                                   const DoutPrefixProvider *dpp);
-
   int read_bucket_stats(const RGWBucketInfo& bucket_info,
                         RGWBucketEnt *ent,
                         optional_yield y,
                         const DoutPrefixProvider *dpp);
 
+  /* the bucket info, shared with the cache when the bucket instance is
+   * known */
+  int read_shared_bucket_info(RGWSI_Bucket_X_Ctx& ctx,
+                              const rgw_bucket& bucket,
+                              std::shared_ptr<const RGWBucketInfo> *info,
+                              optional_yield y,
+                              const DoutPrefixProvider *dpp);
+
+  /* reads the bucket instances of the given buckets straight from rados,
+   * up to max_aio at a time; these are neither looked up in nor added to
+   * binfo_cache */
+  int read_bucket_instances(const std::vector<const rgw_bucket*>& buckets,
+                            std::vector<std::shared_ptr<const RGWBucketInfo>> *infos,
+                            uint32_t max_aio,
+                            optional_yield y,
+                            const DoutPrefixProvider *dpp);
+
+protected:
+  using RGWChainedCacheImpl_bucket_info_cache_entry = RGWChainedCacheImpl<bucket_info_snapshot>;
+  std::unique_ptr<RGWChainedCacheImpl_bucket_info_cache_entry> binfo_cache;
+
+  /* reads the bucket instance from the metadata backend, bypassing
+   * binfo_cache */
+  virtual int do_read_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
+                                           const std::string& key,
+                                           RGWBucketInfo *info,
+                                           real_time *pmtime,
+                                           std::map<std::string, bufferlist> *pattrs,
+                                           rgw_cache_entry_info *cache_info,
+                                           boost::optional<obj_version> refresh_version,
+                                           optional_yield y,
+                                           const DoutPrefixProvider *dpp);
+
 public:
   struct Svc {
     RGWSI_Bucket_SObj *bucket{nullptr};
     RGWSI_BucketIndex *bi{nullptr};
     RGWSI_Zone *zone{nullptr};
+    RGWSI_RADOS *rados{nullptr};
     RGWSI_SysObj *sysobj{nullptr};
     RGWSI_SysObj_Cache *cache{nullptr};
     RGWSI_Meta *meta{nullptr};
@@ -93,6 +109,7 @@ public:
   }
 
   void init(RGWSI_Zone *_zone_svc,
+            RGWSI_RADOS *_rados_svc,
             RGWSI_SysObj *_sysobj_svc,
 	    RGWSI_SysObj_Cache *_cache_svc,
             RGWSI_BucketIndex *_bi,
@@ -139,6 +156,14 @@ public:
                                 rgw_cache_entry_info *cache_info = nullptr,
                                 boost::optional<obj_version> refresh_version = boost::none) override;
 
+  int read_bucket_instance_snapshot(RGWSI_Bucket_BI_Ctx& ctx,
+                                    const std::string& key,
+                                    bucket_info_snapshot *snapshot,
+                                    optional_yield y,
+                                    const DoutPrefixProvider *dpp,
+                                    rgw_cache_entry_info *cache_info = nullptr,
+                                    boost::optional<obj_version> refresh_version = boost::none) override;
+
   int read_bucket_info(RGWSI_Bucket_X_Ctx& ep_ctx,
                        const rgw_bucket& bucket,
                        RGWBucketInfo *info,
@@ -148,6 +173,13 @@ public:
                        optional_yield y,
                        const DoutPrefixProvider *dpp) override;
 
+  int read_bucket_info_snapshot(RGWSI_Bucket_X_Ctx& ep_ctx,
+                                const rgw_bucket& bucket,
+                                bucket_info_snapshot *snapshot,
+                                boost::optional<obj_version> refresh_version,
+                                optional_yield y,
+                                const DoutPrefixProvider *dpp) override;
+
   int store_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
                                  const std::string& key,
                                  RGWBucketInfo& info,
@@ -174,6 +206,7 @@ public:
 
   int read_buckets_stats(RGWSI_Bucket_X_Ctx& ctx,
                          std::map<std::string, RGWBucketEnt>& m,
+                         bool cached_stats,
                          optional_yield y,
                          const DoutPrefixProvider *dpp) override;
 };
@@ -81,16 +81,15 @@ void RGWSI_Bucket_Sync_SObj::get_hint_entities(RGWSI_Bucket_X_Ctx& ctx,
   hint_buckets.reserve(buckets.size());
 
   for (auto& b : buckets) {
-    RGWBucketInfo hint_bucket_info;
-    int ret = svc.bucket_sobj->read_bucket_info(ctx, b, &hint_bucket_info,
-                                                nullptr, nullptr, boost::none,
-                                                y, dpp);
+    RGWSI_Bucket::bucket_info_snapshot hint_bucket_info;
+    int ret = svc.bucket_sobj->read_bucket_info_snapshot(ctx, b, &hint_bucket_info,
+                                                         boost::none, y, dpp);
     if (ret < 0) {
       ldpp_dout(dpp, 20) << "could not init bucket info for hint bucket=" << b << " ... skipping" << dendl;
       continue;
     }
 
-    hint_buckets.emplace_back(std::move(hint_bucket_info.bucket));
+    hint_buckets.emplace_back(hint_bucket_info->info.bucket);
   }
 
   for (auto& zone : zones) {
@@ -192,20 +191,17 @@ int RGWSI_Bucket_Sync_SObj::do_get_policy_handler(RGWSI_Bucket_X_Ctx& ctx,
   bucket_sync_policy_cache_entry e;
   rgw_cache_entry_info cache_info;
 
-  RGWBucketInfo bucket_info;
-  map<string, bufferlist> attrs;
-
-  int r = svc.bucket_sobj->read_bucket_instance_info(ctx.bi,
-                                                     bucket_key,
-                                                     &bucket_info,
-                                                     nullptr,
-                                                     &attrs,
-                                                     y,
-                                                     dpp,
-                                                     &cache_info);
+  RGWSI_Bucket::bucket_info_snapshot bucket_info;
+
+  int r = svc.bucket_sobj->read_bucket_instance_snapshot(ctx.bi,
+                                                         bucket_key,
+                                                         &bucket_info,
+                                                         y,
+                                                         dpp,
+                                                         &cache_info);
   if (r < 0) {
     if (r != -ENOENT) {
-      ldpp_dout(dpp, 0) << "ERROR: svc.bucket->read_bucket_instance_info(key=" << bucket_key << ") returned r=" << r << dendl;
+      ldpp_dout(dpp, 0) << "ERROR: svc.bucket->read_bucket_instance_snapshot(key=" << bucket_key << ") returned r=" << r << dendl;
     }
     return r;
   }
@@ -216,7 +212,10 @@ int RGWSI_Bucket_Sync_SObj::do_get_policy_handler(RGWSI_Bucket_X_Ctx& ctx,
     return -ENOENT;
   }
 
-  e.handler.reset(zone_policy_handler->alloc_child(bucket_info, std::move(attrs)));
+  /* the handler keeps the cached snapshot alive rather than copying it */
+  e.handler.reset(zone_policy_handler->alloc_child(
+      std::shared_ptr<const RGWBucketInfo>(bucket_info, &bucket_info->info),
+      std::shared_ptr<const map<string, bufferlist>>(bucket_info, &bucket_info->attrs)));
 
   r = e.handler->init(dpp, y);
   if (r < 0) {
@@ -104,9 +104,9 @@ public:
     cache.set_ctx(cct);
   }
 
-  bool chain_cache_entry(const DoutPrefixProvider *dpp,
-                         std::initializer_list<rgw_cache_entry_info *> cache_info_entries,
-                         RGWChainedCache::Entry *chained_entry);
+  virtual bool chain_cache_entry(const DoutPrefixProvider *dpp,
+                                 std::initializer_list<rgw_cache_entry_info *> cache_info_entries,
+                                 RGWChainedCache::Entry *chained_entry);
   void register_chained_cache(RGWChainedCache *cc);
   void unregister_chained_cache(RGWChainedCache *cc);
 
@@ -147,7 +147,7 @@ public:
 template <class T>
 class RGWChainedCacheImpl : public RGWChainedCache {
   RGWSI_SysObj_Cache *svc{nullptr};
-  ceph::timespan expiry;
+  ceph::timespan expiry = ceph::timespan::zero();
   RWLock lock;
 
   std::unordered_map<std::string, std::pair<T, ceph::coarse_mono_time>> entries;
@@ -17,6 +17,7 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <iostream>
 
 using namespace std;
 
@@ -605,3 +606,173 @@ TEST_F(TestClsQueue, WrapAround)
   }
 }
 
+
+TEST_F(TestClsQueue, BulkDequeue)
+{
+  const std::string queue_name = "my-queue";
+  const uint64_t queue_size = 1024*1024;
+  librados::ObjectWriteOperation op;
+  op.create(true);
+  cls_queue_init(op, queue_name, queue_size);
+  ASSERT_EQ(0, ioctx.operate(queue_name, &op));
+  const auto number_of_ops = 10;
+  const auto number_of_elements = 100;
+
+  test_enqueue(queue_name, number_of_ops, number_of_elements, 0);
+
+  // dequeue everything, 42 at a time, in the order it was enqueued
+  const auto max_elements = 42;
+  bool truncated = false;
+  auto total_elements = 0;
+  do {
+    std::vector<cls_queue_entry> entries;
+    const auto ret = cls_queue_dequeue(ioctx, queue_name, max_elements, entries, &truncated);
+    ASSERT_EQ(0, ret);
+    ASSERT_LE(entries.size(), max_elements);
+    for (auto& entry : entries) {
+      const auto i = total_elements / number_of_elements;
+      const auto j = total_elements % number_of_elements;
+      ASSERT_EQ(entry.data.to_str(), "op-" + to_string(i) + "-element-" + to_string(j));
+      ++total_elements;
+    }
+  } while (truncated);
+  ASSERT_EQ(total_elements, number_of_ops*number_of_elements);
+
+  // make sure queue is empty
+  std::vector<cls_queue_entry> entries;
+  const auto ret = cls_queue_dequeue(ioctx, queue_name, max_elements, entries, &truncated);
+  ASSERT_EQ(0, ret);
+  ASSERT_EQ(entries.size(), 0);
+  ASSERT_EQ(truncated, false);
+}
+
+TEST_F(TestClsQueue, DequeueZero)
+{
+  const std::string queue_name = "my-queue";
+  const uint64_t queue_size = 1024*1024;
+  librados::ObjectWriteOperation op;
+  op.create(true);
+  cls_queue_init(op, queue_name, queue_size);
+  ASSERT_EQ(0, ioctx.operate(queue_name, &op));
+  test_enqueue(queue_name, 2, 10, 0);
+
+  bool truncated;
+  std::vector<cls_queue_entry> entries;
+  ASSERT_EQ(-EINVAL, cls_queue_dequeue(ioctx, queue_name, 0, entries, &truncated));
+
+  // nothing was removed
+  const std::string marker;
+  std::string next_marker;
+  const auto ret = cls_queue_list_entries(ioctx, queue_name, marker, 100, entries, &truncated, next_marker);
+  ASSERT_EQ(0, ret);
+  ASSERT_EQ(entries.size(), 20);
+}
+
+TEST_F(TestClsQueue, BulkMultiProducer)
+{
+  const std::string queue_name = "my-queue";
+  const uint64_t queue_size = 16*1024*1024;
+  librados::ObjectWriteOperation op;
+  op.create(true);
+  cls_queue_init(op, queue_name, queue_size);
+  ASSERT_EQ(0, ioctx.operate(queue_name, &op));
+
+  const int max_producer_count = 8;
+  std::atomic<int> producer_count = max_producer_count;
+  const int number_of_ops = 20;
+  const int number_of_elements = 500;
+
+  std::vector<std::thread> producers(max_producer_count);
+  for (auto& p : producers) {
+    p = std::thread([this, &queue_name, &producer_count] {
+		      test_enqueue(queue_name, number_of_ops, number_of_elements, 0);
+		      --producer_count;
+		    });
+  }
+
+  auto consume_count = 0U;
+  std::thread consumer([this, &queue_name, &consume_count, &producer_count] {
+          const auto max_elements = 1000;
+          bool truncated = false;
+          std::vector<cls_queue_entry> entries;
+          // keep going until a dequeue that started after the last
+          // producer finished comes back with everything
+          for (;;) {
+            const bool done = (producer_count == 0);
+            const auto ret = cls_queue_dequeue(ioctx, queue_name, max_elements, entries, &truncated);
+            ASSERT_EQ(0, ret);
+            consume_count += entries.size();
+            if (done && !truncated) {
+              break;
+            }
+          }
+       });
+
+  for (auto& p : producers) {
+      p.join();
+  }
+  consumer.join();
+  ASSERT_EQ(consume_count, number_of_ops*number_of_elements*max_producer_count);
+
+  // every entry was dequeued exactly once, nothing is left behind
+  const std::string marker;
+  bool truncated;
+  std::string next_marker;
+  std::vector<cls_queue_entry> entries;
+  const auto ret = cls_queue_list_entries(ioctx, queue_name, marker, 10, entries, &truncated, next_marker);
+  ASSERT_EQ(0, ret);
+  ASSERT_EQ(truncated, false);
+  ASSERT_EQ(entries.size(), 0);
+}
+
+// enqueue/dequeue rate with concurrent producers; run it explicitly with
+// --gtest_also_run_disabled_tests --gtest_filter=*BulkThroughput
+TEST_F(TestClsQueue, DISABLED_BulkThroughput)
+{
+  const std::string queue_name = "my-queue";
+  const uint64_t queue_size = 16*1024*1024;
+  librados::ObjectWriteOperation op;
+  op.create(true);
+  cls_queue_init(op, queue_name, queue_size);
+  ASSERT_EQ(0, ioctx.operate(queue_name, &op));
+
+  const int max_producer_count = 8;
+  std::atomic<int> producer_count = max_producer_count;
+  const int number_of_ops = 20;
+  const int number_of_elements = 500;
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> producers(max_producer_count);
+  for (auto& p : producers) {
+    p = std::thread([this, &queue_name, &producer_count] {
+		      test_enqueue(queue_name, number_of_ops, number_of_elements, 0);
+		      --producer_count;
+		    });
+  }
+
+  auto consume_count = 0U;
+  std::thread consumer([this, &queue_name, &consume_count, &producer_count] {
+          const auto max_elements = 1000;
+          bool truncated = false;
+          std::vector<cls_queue_entry> entries;
+          for (;;) {
+            const bool done = (producer_count == 0);
+            const auto ret = cls_queue_dequeue(ioctx, queue_name, max_elements, entries, &truncated);
+            ASSERT_EQ(0, ret);
+            consume_count += entries.size();
+            if (done && !truncated) {
+              break;
+            }
+          }
+       });
+
+  for (auto& p : producers) {
+      p.join();
+  }
+  consumer.join();
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  const auto total = number_of_ops*number_of_elements*max_producer_count;
+  ASSERT_EQ(consume_count, total);
+  std::cout << "enqueued and dequeued " << total << " entries in "
+            << elapsed.count() << "s (" << total/elapsed.count() << " entries/s)" << std::endl;
+}
@@ -368,6 +368,59 @@ TEST_F(IsaErasureCodeTest, encode)
   }
 }
 
+TEST_F(IsaErasureCodeTest, encode_decode_stripes)
+{
+  ErasureCodeIsaDefault Isa(tcache);
+  ErasureCodeProfile profile;
+  profile["k"] = "8";
+  profile["m"] = "3";
+  Isa.init(profile, &cerr);
+
+  const unsigned chunk_size = 4096;
+  const unsigned stripes = 16;
+  const unsigned stripe_width = 8 * chunk_size;
+  bufferlist in;
+  for (unsigned i = 0; i < stripes * stripe_width; i++) {
+    in.append((char)(rand() & 0xff));
+  }
+  set<int> want_to_encode;
+  for (int i = 0; i < 11; i++) {
+    want_to_encode.insert(i);
+  }
+
+  // one stripe at a time is the reference
+  map<int,bufferlist> expected;
+  for (unsigned off = 0; off < in.length(); off += stripe_width) {
+    bufferlist stripe;
+    stripe.substr_of(in, off, stripe_width);
+    map<int,bufferlist> encoded;
+    EXPECT_EQ(0, Isa.encode(want_to_encode, stripe, &encoded));
+    for (auto& [shard, bl] : encoded) {
+      ASSERT_EQ(chunk_size, bl.length());
+      expected[shard].claim_append(bl);
+    }
+  }
+
+  map<int,bufferlist> encoded;
+  EXPECT_EQ(0, Isa.encode_stripes(want_to_encode, in, chunk_size, &encoded));
+  ASSERT_EQ(11u, encoded.size());
+  for (auto& [shard, bl] : expected) {
+    ASSERT_EQ(stripes * chunk_size, encoded[shard].length());
+    EXPECT_TRUE(bl.contents_equal(encoded[shard])) << "shard " << shard;
+  }
+
+  // lose a data and a coding chunk and recover all stripes at once
+  map<int,bufferlist> degraded = encoded;
+  degraded.erase(2);
+  degraded.erase(9);
+  set<int> want_to_read = { 2, 9 };
+  map<int,bufferlist> decoded;
+  EXPECT_EQ(0, Isa.decode_stripes(want_to_read, degraded, chunk_size,
+				  &decoded));
+  EXPECT_TRUE(expected[2].contents_equal(decoded[2]));
+  EXPECT_TRUE(expected[9].contents_equal(decoded[9]));
+}
+
 TEST_F(IsaErasureCodeTest, sanity_check_k)
 {
   ErasureCodeIsaDefault Isa(tcache);
@@ -45,6 +45,11 @@ int ErasureCodeBench::setup(int argc, char** argv) {
     ("verbose,v", "explain what happens")
     ("size,s", po::value<int>()->default_value(1024 * 1024),
      "size of the buffer to be encoded")
+    ("stripes,S", po::value<int>()->default_value(1),
+     "split the buffer into this many stripes, each encoded or decoded"
+     " separately as the OSD does")
+    ("batch,b", "hand all the stripes to a single encode_stripes() or"
+     " decode_stripes() call instead of one call per stripe")
     ("iterations,i", po::value<int>()->default_value(1),
      "number of encode/decode runs")
     ("plugin,p", po::value<string>()->default_value("jerasure"),
@@ -110,6 +115,8 @@ int ErasureCodeBench::setup(int argc, char** argv) {
   }
 
   in_size = vm["size"].as<int>();
+  stripes = vm["stripes"].as<int>();
+  batch = vm.count("batch") > 0;
   max_iterations = vm["iterations"].as<int>();
   plugin = vm["plugin"].as<string>();
   workload = vm["workload"].as<string>();
@@ -138,6 +145,16 @@ int ErasureCodeBench::setup(int argc, char** argv) {
     return -EINVAL;
   } 
 
+  if (stripes <= 0 || in_size / stripes < k) {
+    cout << "parameter stripes is " << stripes << ". But it needs to be > 0"
+	 << " and leave at least k bytes per stripe." << endl;
+    return -EINVAL;
+  }
+  if (stripes > 1 && workload != "encode" && exhaustive_erasures) {
+    cout << "--stripes cannot be combined with exhaustive erasures" << endl;
+    return -EINVAL;
+  }
+
   verbose = vm.count("verbose") > 0 ? true : false;
 
   return 0;
@@ -153,6 +170,54 @@ int ErasureCodeBench::run() {
     return decode();
 }
 
+int ErasureCodeBench::encode_stripes(ErasureCodeInterfaceRef erasure_code,
+				     const set<int> &want_to_encode,
+				     const bufferlist &in,
+				     unsigned chunk_size,
+				     map<int,bufferlist> *encoded)
+{
+  if (batch)
+    return erasure_code->encode_stripes(want_to_encode, in, chunk_size,
+					encoded);
+  unsigned stripe_width = k * chunk_size;
+  for (unsigned off = 0; off < in.length(); off += stripe_width) {
+    bufferlist stripe;
+    stripe.substr_of(in, off, stripe_width);
+    map<int,bufferlist> stripe_encoded;
+    int code = erasure_code->encode(want_to_encode, stripe, &stripe_encoded);
+    if (code)
+      return code;
+    for (auto& [shard, bl] : stripe_encoded)
+      (*encoded)[shard].claim_append(bl);
+  }
+  return 0;
+}
+
+int ErasureCodeBench::decode_stripes(ErasureCodeInterfaceRef erasure_code,
+				     const set<int> &want_to_read,
+				     const map<int,bufferlist> &chunks,
+				     unsigned chunk_size,
+				     map<int,bufferlist> *decoded)
+{
+  if (batch)
+    return erasure_code->decode_stripes(want_to_read, chunks, chunk_size,
+					decoded);
+  unsigned length = chunks.begin()->second.length();
+  for (unsigned off = 0; off < length; off += chunk_size) {
+    map<int,bufferlist> stripe_chunks;
+    for (auto& [shard, bl] : chunks)
+      stripe_chunks[shard].substr_of(bl, off, chunk_size);
+    map<int,bufferlist> stripe_decoded;
+    int code = erasure_code->decode(want_to_read, stripe_chunks,
+				    &stripe_decoded, chunk_size);
+    if (code)
+      return code;
+    for (auto shard : want_to_read)
+      (*decoded)[shard].claim_append(stripe_decoded[shard]);
+  }
+  return 0;
+}
+
 int ErasureCodeBench::encode()
 {
   ErasureCodePluginRegistry &instance = ErasureCodePluginRegistry::instance();
@@ -166,8 +231,12 @@ int ErasureCodeBench::encode()
     return code;
   }
 
+  unsigned chunk_size = erasure_code->get_chunk_size(in_size / stripes);
   bufferlist in;
-  in.append(string(in_size, 'X'));
+  if (stripes > 1)
+    in.append(string(stripes * k * chunk_size, 'X'));
+  else
+    in.append(string(in_size, 'X'));
   in.rebuild_aligned(ErasureCode::SIMD_ALIGN);
   set<int> want_to_encode;
   for (int i = 0; i < k + m; i++) {
@@ -176,12 +245,16 @@ int ErasureCodeBench::encode()
   utime_t begin_time = ceph_clock_now();
   for (int i = 0; i < max_iterations; i++) {
     map<int,bufferlist> encoded;
-    code = erasure_code->encode(want_to_encode, in, &encoded);
+    if (stripes > 1)
+      code = encode_stripes(erasure_code, want_to_encode, in, chunk_size,
+			    &encoded);
+    else
+      code = erasure_code->encode(want_to_encode, in, &encoded);
     if (code)
       return code;
   }
   utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << endl;
+  cout << (end_time - begin_time) << "\t" << (max_iterations * (in.length() / 1024)) << endl;
   return 0;
 }
 
@@ -261,8 +334,12 @@ int ErasureCodeBench::decode()
     return code;
   }
 
+  unsigned chunk_size = erasure_code->get_chunk_size(in_size / stripes);
   bufferlist in;
-  in.append(string(in_size, 'X'));
+  if (stripes > 1)
+    in.append(string(stripes * k * chunk_size, 'X'));
+  else
+    in.append(string(in_size, 'X'));
   in.rebuild_aligned(ErasureCode::SIMD_ALIGN);
 
   set<int> want_to_encode;
@@ -271,7 +348,11 @@ int ErasureCodeBench::decode()
   }
 
   map<int,bufferlist> encoded;
-  code = erasure_code->encode(want_to_encode, in, &encoded);
+  if (stripes > 1)
+    code = erasure_code->encode_stripes(want_to_encode, in, chunk_size,
+					&encoded);
+  else
+    code = erasure_code->encode(want_to_encode, in, &encoded);
   if (code)
     return code;
 
@@ -293,7 +374,11 @@ int ErasureCodeBench::decode()
 	return code;
     } else if (erased.size() > 0) {
       map<int,bufferlist> decoded;
-      code = erasure_code->decode(want_to_read, encoded, &decoded, 0);
+      if (stripes > 1)
+	code = decode_stripes(erasure_code, want_to_read, encoded, chunk_size,
+			      &decoded);
+      else
+	code = erasure_code->decode(want_to_read, encoded, &decoded, 0);
       if (code)
 	return code;
     } else {
@@ -306,13 +391,17 @@ int ErasureCodeBench::decode()
 	chunks.erase(erasure);
       }
       map<int,bufferlist> decoded;
-      code = erasure_code->decode(want_to_read, chunks, &decoded, 0);
+      if (stripes > 1)
+	code = decode_stripes(erasure_code, want_to_read, chunks, chunk_size,
+			      &decoded);
+      else
+	code = erasure_code->decode(want_to_read, chunks, &decoded, 0);
       if (code)
 	return code;
     }
   }
   utime_t end_time = ceph_clock_now();
-  cout << (end_time - begin_time) << "\t" << (max_iterations * (in_size / 1024)) << endl;
+  cout << (end_time - begin_time) << "\t" << (max_iterations * (in.length() / 1024)) << endl;
   return 0;
 }
 
@@ -24,6 +24,8 @@ using namespace std;
 
 class ErasureCodeBench {
   int in_size;
+  int stripes;
+  bool batch;
   int max_iterations;
   int erasures;
   int k;
@@ -49,6 +51,16 @@ public:
 		      ErasureCodeInterfaceRef erasure_code);
   int decode();
   int encode();
+  int encode_stripes(ErasureCodeInterfaceRef erasure_code,
+		     const set<int> &want_to_encode,
+		     const bufferlist &in,
+		     unsigned chunk_size,
+		     map<int,bufferlist> *encoded);
+  int decode_stripes(ErasureCodeInterfaceRef erasure_code,
+		     const set<int> &want_to_read,
+		     const map<int,bufferlist> &chunks,
+		     unsigned chunk_size,
+		     map<int,bufferlist> *decoded);
 };
 
 #endif
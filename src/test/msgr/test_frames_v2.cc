@@ -205,10 +205,12 @@ protected:
       comp_meta.con_mode = Compressor::COMP_FORCE;
       comp_meta.con_method = Compressor::COMP_ALG_SNAPPY;
       m_tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+        /*min_compress_dict_size=*/COMP_THRESHOLD
       );
       m_rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
-        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD
+        g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+        /*min_compress_dict_size=*/COMP_THRESHOLD
       );
     }
   }
@@ -468,6 +470,49 @@ INSTANTIATE_TEST_SUITE_P(
         ::testing::ValuesIn(round_trip_perf_instances),
         ::testing::ValuesIn(modes)));
 
+TEST(CompressDictTest, RoundTrip) {
+  CompConnectionMeta comp_meta;
+  comp_meta.con_mode = Compressor::COMP_FORCE;
+  comp_meta.con_method = Compressor::COMP_ALG_ZSTD;
+  comp_meta.con_dict = true;
+  auto tx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+    g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+    /*min_compress_dict_size=*/0);
+  auto rx_comp = ceph::compression::onwire::rxtx_t::create_handler_pair(
+    g_ceph_context, comp_meta, /*min_compress_size=*/COMP_THRESHOLD,
+    /*min_compress_dict_size=*/0);
+  if (!tx_comp.tx || !tx_comp.tx->has_dict()) {
+    GTEST_SKIP() << "zstd plugin not available";
+  }
+  ceph::crypto::onwire::rxtx_t no_crypto;
+  FrameAssembler tx_frame_asm(&no_crypto, true, true, &tx_comp);
+  FrameAssembler rx_frame_asm(&no_crypto, true, true, &rx_comp);
+
+  uint32_t first_onwire_len = 0;
+  for (int i = 0; i < 4; i++) {
+    // small frames differing only in a few bytes, far below the
+    // non-dictionary threshold
+    bufferlist front;
+    front.append("set_omap " + std::string(200, 'k') + std::to_string(i));
+    auto tx_frame = TestFrame::Encode({}, front, {}, {});
+    auto onwire_bl = tx_frame.get_buffer(tx_frame_asm);
+    ASSERT_EQ(i + 1u, tx_comp.tx->get_total_stats().frames);
+    if (i == 0) {
+      first_onwire_len = tx_frame_asm.get_frame_onwire_len();
+    } else {
+      EXPECT_LT(tx_frame_asm.get_frame_onwire_len(), first_onwire_len);
+    }
+
+    Tag rx_tag;
+    segment_bls_t rx_segment_bls;
+    ASSERT_TRUE(disassemble_frame(rx_frame_asm, onwire_bl, rx_tag,
+                                  rx_segment_bls));
+    auto rx_frame = TestFrame::Decode(rx_segment_bls);
+    EXPECT_TRUE(front.contents_equal(rx_frame.front()));
+  }
+  EXPECT_EQ(4u, rx_comp.rx->get_total_stats().frames);
+}
+
 }  // namespace ceph::msgr::v2
 
 int main(int argc, char* argv[]) {
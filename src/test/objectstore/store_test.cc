@@ -5919,6 +5919,229 @@ TEST_P(StoreTest, OMapIterator) {
   }
 }
 
+#if defined(WITH_BLUESTORE)
+TEST_P(StoreTest, OmapTrimRangeDelete) {
+  if (string(GetParam()) != "bluestore")
+    return;
+  SetVal(g_conf(), "bluestore_omap_trim_range_delete_keys", "8");
+  SetVal(g_conf(), "bluestore_omap_trim_compact_ranges", "4");
+  g_conf().apply_changes(nullptr);
+
+  int r;
+  coll_t cid;
+  ghobject_t hoid(hobject_t("trim_log", "", CEPH_NOSNAP, 0, 0, ""));
+  const PerfCounters* logger = store->get_perf_counters();
+  auto ch = store->create_new_collection(cid);
+  auto key = [](unsigned n) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%08u", n);
+    return string(buf);
+  };
+  const unsigned batch = 16;
+  const unsigned rounds = 10;
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    t.touch(cid, hoid);
+    map<string, bufferlist> to_set;
+    for (unsigned n = 0; n < (rounds + 1) * batch; ++n) {
+      to_set[key(n)].append("entry");
+    }
+    t.omap_setkeys(cid, hoid, to_set);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  uint64_t range_deletes = logger->get(l_bluestore_omap_trim_range_deletes);
+  uint64_t compactions = logger->get(l_bluestore_omap_trim_compactions);
+  // trim from the front the way a log is, every batch is large enough to
+  // become a range tombstone
+  for (unsigned i = 1; i <= rounds; ++i) {
+    {
+      ObjectStore::Transaction t;
+      t.omap_rmkeyrange(cid, hoid, string(), key(i * batch));
+      r = queue_transaction(store, ch, std::move(t));
+      ASSERT_EQ(r, 0);
+    }
+    ObjectMap::ObjectMapIterator iter = store->get_omap_iterator(ch, hoid);
+    iter->seek_to_first();
+    ASSERT_TRUE(iter->valid());
+    ASSERT_EQ(key(i * batch), iter->key());
+    iter->lower_bound(key(i * batch - 1));
+    ASSERT_TRUE(iter->valid());
+    ASSERT_EQ(key(i * batch), iter->key());
+  }
+  ASSERT_EQ(range_deletes + rounds,
+	    logger->get(l_bluestore_omap_trim_range_deletes));
+  ASSERT_LT(compactions, logger->get(l_bluestore_omap_trim_compactions));
+
+  // too few keys for a range tombstone
+  range_deletes = logger->get(l_bluestore_omap_trim_range_deletes);
+  {
+    ObjectStore::Transaction t;
+    t.omap_rmkeyrange(cid, hoid, string(), key(rounds * batch + 4));
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  ASSERT_EQ(range_deletes, logger->get(l_bluestore_omap_trim_range_deletes));
+  {
+    set<string> keys;
+    r = store->omap_get_keys(ch, hoid, &keys);
+    ASSERT_EQ(r, 0);
+    ASSERT_EQ(batch - 4, keys.size());
+    ASSERT_EQ(key(rounds * batch + 4), *keys.begin());
+  }
+  {
+    ObjectStore::Transaction t;
+    t.omap_clear(cid, hoid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  {
+    set<string> keys;
+    r = store->omap_get_keys(ch, hoid, &keys);
+    ASSERT_EQ(r, 0);
+    ASSERT_TRUE(keys.empty());
+  }
+  {
+    ObjectStore::Transaction t;
+    t.remove(cid, hoid);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+
+// Writes and reads back many tiny objects with and without inline data,
+// reporting IOPS and data space, then checks that inline objects migrate
+// to blobs as they grow.
+TEST_P(StoreTest, SmallObjectInlineData) {
+  if (string(GetParam()) != "bluestore")
+    return;
+  if (smr) {
+    cout << "SKIP (smr)" << std::endl;
+    return;
+  }
+  int r;
+  coll_t cid;
+  const PerfCounters* logger = store->get_perf_counters();
+  auto ch = store->create_new_collection(cid);
+  {
+    ObjectStore::Transaction t;
+    t.create_collection(cid, 0);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  const unsigned num_objects = 100;
+  const unsigned obj_size = 700;
+  bufferlist data;
+  for (unsigned i = 0; i < obj_size; ++i) {
+    data.append((char)('a' + i % 26));
+  }
+  auto oid = [](const string& prefix, unsigned n) {
+    return ghobject_t(hobject_t(sobject_t(prefix + stringify(n), CEPH_NOSNAP)));
+  };
+  auto run = [&](const string& prefix, uint64_t* allocated) {
+    struct store_statfs_t before, after;
+    ASSERT_EQ(0, store->statfs(&before));
+    for (unsigned n = 0; n < num_objects; ++n) {
+      ObjectStore::Transaction t;
+      t.write(cid, oid(prefix, n), 0, data.length(), data);
+      ASSERT_EQ(0, queue_transaction(store, ch, std::move(t)));
+    }
+    for (unsigned n = 0; n < num_objects; ++n) {
+      bufferlist bl;
+      ASSERT_EQ((int)obj_size, store->read(ch, oid(prefix, n), 0, obj_size, bl));
+      ASSERT_TRUE(bl_eq(data, bl));
+    }
+    ASSERT_EQ(0, store->statfs(&after));
+    *allocated = after.allocated - before.allocated;
+  };
+
+  uint64_t plain_allocated, inline_allocated;
+  run("plain_", &plain_allocated);
+  SetVal(g_conf(), "bluestore_inline_data_max_size", "4096");
+  g_conf().apply_changes(nullptr);
+  uint64_t inline_writes = logger->get(l_bluestore_write_inline);
+  run("inline_", &inline_allocated);
+  ASSERT_EQ(inline_writes + num_objects, logger->get(l_bluestore_write_inline));
+  ASSERT_EQ(0u, inline_allocated);
+  ASSERT_LT(0u, plain_allocated);
+
+  // zero and truncate stay inline, growing past the limit moves the data
+  ghobject_t hoid = oid("inline_", 0);
+  {
+    ObjectStore::Transaction t;
+    t.zero(cid, hoid, 10, 10);
+    t.truncate(cid, hoid, 1000);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  bufferlist expected;
+  expected.substr_of(data, 0, 10);
+  expected.append_zero(10);
+  expected.append(data.c_str() + 20, obj_size - 20);
+  expected.append_zero(1000 - obj_size);
+  {
+    bufferlist bl;
+    ASSERT_EQ(1000, store->read(ch, hoid, 0, 1000, bl));
+    ASSERT_TRUE(bl_eq(expected, bl));
+  }
+  uint64_t migrated = logger->get(l_bluestore_inline_migrated);
+  {
+    ObjectStore::Transaction t;
+    t.write(cid, hoid, 8192, data.length(), data);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  ASSERT_EQ(migrated + 1, logger->get(l_bluestore_inline_migrated));
+  expected.append_zero(8192 - 1000);
+  expected.append(data);
+  {
+    bufferlist bl;
+    ASSERT_EQ((int)expected.length(),
+	      store->read(ch, hoid, 0, expected.length(), bl));
+    ASSERT_TRUE(bl_eq(expected, bl));
+  }
+
+  // clones of inline objects are inline as well
+  ghobject_t hoid2 = oid("inline_", 1);
+  ghobject_t hoid3 = oid("inline_clone_", 1);
+  {
+    ObjectStore::Transaction t;
+    t.clone(cid, hoid2, hoid3);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+  {
+    bufferlist bl;
+    ASSERT_EQ((int)obj_size, store->read(ch, hoid3, 0, obj_size, bl));
+    ASSERT_TRUE(bl_eq(data, bl));
+  }
+
+  ch.reset();
+  EXPECT_EQ(store->umount(), 0);
+  ASSERT_EQ(store->fsck(false), 0);
+  EXPECT_EQ(store->mount(), 0);
+  ch = store->open_collection(cid);
+  {
+    bufferlist bl;
+    ASSERT_EQ((int)obj_size, store->read(ch, hoid2, 0, obj_size, bl));
+    ASSERT_TRUE(bl_eq(data, bl));
+  }
+  {
+    ObjectStore::Transaction t;
+    for (unsigned n = 0; n < num_objects; ++n) {
+      t.remove(cid, oid("plain_", n));
+      t.remove(cid, oid("inline_", n));
+    }
+    t.remove(cid, hoid3);
+    t.remove_collection(cid);
+    r = queue_transaction(store, ch, std::move(t));
+    ASSERT_EQ(r, 0);
+  }
+}
+#endif
+
 TEST_P(StoreTest, XattrTest) {
   coll_t cid;
   ghobject_t hoid(hobject_t("tesomap", "", CEPH_NOSNAP, 0, 0, ""));
@@ -9,6 +9,7 @@
 #include "os/bluestore/BlueStore.h"
 #include "os/bluestore/AvlAllocator.h"
 #include "common/ceph_argparse.h"
+#include "common/ceph_json.h"
 #include "global/global_init.h"
 #include "global/global_context.h"
 
@@ -1194,6 +1195,87 @@ TEST(ExtentMap, compress_extent_map)
   ASSERT_EQ(6u, em.extent_map.size());
 }
 
+TEST(OnodeCacheShard, two_q_scan_resistance)
+{
+  BlueStore store(g_ceph_context, "", 4096);
+  BlueStore::OnodeCacheShard *oc = BlueStore::OnodeCacheShard::create(
+    g_ceph_context, "2q", NULL);
+  BlueStore::BufferCacheShard *bc = BlueStore::BufferCacheShard::create(
+    g_ceph_context, "lru", NULL);
+  auto coll = ceph::make_ref<BlueStore::Collection>(&store, oc, bc, coll_t());
+  oc->set_max(16);
+
+  auto make_oid = [](const string& prefix, int i) {
+    return ghobject_t(hobject_t(sobject_t(prefix + stringify(i), CEPH_NOSNAP)));
+  };
+  auto load = [&](const ghobject_t& oid) {
+    BlueStore::OnodeRef o(new BlueStore::Onode(coll.get(), oid, ""));
+    o->exists = true;
+    return coll->onode_map.add(oid, o).get();
+  };
+  // re-reference a cached onode the way a reader would
+  auto touch = [&](BlueStore::Onode *on, uint32_t op_flags) {
+    BlueStore::OnodeRef o(on);
+    o->hint_cache_scan(op_flags);
+  };
+  auto cached = [&](const ghobject_t& oid) {
+    return coll->onode_map.map_any([&](BlueStore::Onode *o) {
+      return o->oid == oid;
+    });
+  };
+
+  // working set, referenced twice by clients
+  for (int i = 0; i < 8; ++i) {
+    touch(load(make_oid("hot", i)), 0);
+  }
+  ASSERT_EQ(8u, oc->promotions);
+  ASSERT_EQ(8u, oc->misses[BlueStore::OnodeCacheShard::ONODE_CLASS_CLIENT]);
+  ASSERT_EQ(8u, oc->hits[BlueStore::OnodeCacheShard::ONODE_CLASS_CLIENT]);
+
+  // a sweep reads each of many objects, some of them twice
+  uint32_t scan = CEPH_OSD_OP_FLAG_FADVISE_DONTNEED;
+  for (int i = 0; i < 200; ++i) {
+    BlueStore::Onode *on = load(make_oid("scan", i));
+    touch(on, scan);
+    touch(on, scan);
+  }
+  ASSERT_EQ(8u, oc->promotions);
+  ASSERT_EQ(400u, oc->hits[BlueStore::OnodeCacheShard::ONODE_CLASS_SCAN]);
+  ASSERT_EQ(0u, oc->evictions[BlueStore::OnodeCacheShard::ONODE_SEG_HOT]);
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(cached(make_oid("hot", i)));
+  }
+  ASSERT_FALSE(cached(make_oid("scan", 0)));
+  oc->trim();
+  ASSERT_EQ(16u, oc->_get_num());
+
+  // the admin socket view reports the same counters
+  JSONFormatter f;
+  f.open_object_section("shard");
+  oc->dump_stats(&f);
+  f.close_section();
+  std::stringstream ss;
+  f.flush(ss);
+  std::string js = ss.str();
+  JSONParser parser;
+  ASSERT_TRUE(parser.parse(js.c_str(), js.size()));
+  JSONObj *shard = parser.find_obj("shard");
+  ASSERT_TRUE(shard);
+  uint64_t v = 0;
+  JSONDecoder::decode_json("onodes", v, shard);
+  ASSERT_EQ(16u, v);
+  JSONDecoder::decode_json("promotions", v, shard);
+  ASSERT_EQ(8u, v);
+  JSONObj *scan_stats = shard->find_obj("scan");
+  ASSERT_TRUE(scan_stats);
+  JSONDecoder::decode_json("hits", v, scan_stats);
+  ASSERT_EQ(400u, v);
+  JSONObj *evictions = shard->find_obj("evictions");
+  ASSERT_TRUE(evictions);
+  JSONDecoder::decode_json("hot", v, evictions);
+  ASSERT_EQ(0u, v);
+}
+
 
 void clear_and_dispose(BlueStore::old_extent_map_t& old_em)
 {
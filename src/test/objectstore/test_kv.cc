@@ -495,6 +495,54 @@ TEST_P(KVTest, RocksDBShardingIteratorTest) {
   fini();
 }
 
+TEST_P(KVTest, RocksDBShardingBoundedIteratorTest) {
+  if(string(GetParam()) != "rocksdb")
+    return;
+
+  // A is hashed on the first two characters only, so a range within one
+  // such prefix lives in a single shard; B has to merge all of its shards
+  std::string cfs("A(6,0-2)=prefix_extractor=rocksdb.CappedPrefix.2 B(6)");
+  ASSERT_EQ(0, db->init(g_conf()->bluestore_rocksdb_options));
+  ASSERT_EQ(0, db->create_and_open(cout, cfs));
+  {
+    KeyValueDB::Transaction t = db->get_transaction();
+    for (int v = 100; v <= 999; v++) {
+      std::string str = to_string(v);
+      bufferlist val;
+      val.append(str);
+      t->set("A", str, val);
+      t->set("B", str, val);
+    }
+    ASSERT_EQ(0, db->submit_transaction_sync(t));
+  }
+  for (auto prefix : {"A", "B"}) {
+    KeyValueDB::Iterator it = db->get_iterator(prefix, 0,
+      KeyValueDB::IteratorBounds{"12", "13"});
+    ASSERT_EQ(it->lower_bound("12"), 0);
+    for (int pos = 120; pos <= 129; pos++) {
+      ASSERT_EQ(it->valid(), true);
+      ASSERT_EQ(it->key(), to_string(pos));
+      it->next();
+    }
+    ASSERT_EQ(it->valid(), false);
+    ASSERT_EQ(it->lower_bound("125"), 0);
+    ASSERT_EQ(it->valid(), true);
+    ASSERT_EQ(it->key(), "125");
+  }
+  {
+    // the prefix extractor must not cut unbounded scans short
+    KeyValueDB::Iterator it = db->get_iterator("A");
+    ASSERT_EQ(it->lower_bound("125"), 0);
+    for (int pos = 125; pos <= 999; pos++) {
+      ASSERT_EQ(it->valid(), true);
+      ASSERT_EQ(it->key(), to_string(pos));
+      it->next();
+    }
+    ASSERT_EQ(it->valid(), false);
+  }
+  fini();
+}
+
 TEST_P(KVTest, RocksDBCFMerge) {
   if(string(GetParam()) != "rocksdb")
     return;
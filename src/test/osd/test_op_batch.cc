@@ -0,0 +1,154 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <random>
+#include <gtest/gtest.h>
+#include "osd/OpBatch.h"
+#include "test/objectstore/store_test_fixture.h"
+
+using namespace std;
+
+// runs the same stream of per-op transactions into two collections, once
+// one op at a time and once through OpBatch, and compares the results
+class OpBatchTest : public StoreTestFixture {
+public:
+  OpBatchTest() : StoreTestFixture("memstore") {}
+
+  coll_t plain_cid{spg_t(pg_t(1, 1))};
+  coll_t batch_cid{spg_t(pg_t(2, 1))};
+  ObjectStore::CollectionHandle plain_ch, batch_ch;
+
+  void SetUp() override {
+    StoreTestFixture::SetUp();
+    ObjectStore::Transaction t;
+    plain_ch = store->create_new_collection(plain_cid);
+    t.create_collection(plain_cid, 0);
+    batch_ch = store->create_new_collection(batch_cid);
+    t.create_collection(batch_cid, 0);
+    ASSERT_EQ(0, store->queue_transaction(plain_ch, std::move(t)));
+  }
+
+  void TearDown() override {
+    plain_ch.reset();
+    batch_ch.reset();
+    StoreTestFixture::TearDown();
+  }
+
+  static ghobject_t obj(unsigned n) {
+    return ghobject_t(hobject_t(sobject_t("obj" + stringify(n), CEPH_NOSNAP)));
+  }
+
+  // one op: a few transactions, each a random update of a few objects
+  static vector<ObjectStore::Transaction> make_op(
+    std::mt19937& rng, const coll_t& cid) {
+    vector<ObjectStore::Transaction> tls(1 + rng() % 2);
+    for (auto& t : tls) {
+      for (unsigned i = 1 + rng() % 3; i > 0; --i) {
+	auto oid = obj(rng() % 4);
+	bufferlist bl;
+	bl.append(string(1 + rng() % 100, 'a' + rng() % 26));
+	switch (rng() % 6) {
+	case 0:
+	  t.write(cid, oid, rng() % 200, bl.length(), bl);
+	  break;
+	case 1:
+	  t.truncate(cid, oid, rng() % 150);
+	  break;
+	case 2:
+	  t.remove(cid, oid);
+	  break;
+	case 3: {
+	  map<string, bufferlist> keys;
+	  keys["k" + stringify(rng() % 5)] = bl;
+	  t.touch(cid, oid);
+	  t.omap_setkeys(cid, oid, keys);
+	  break;
+	}
+	case 4:
+	  t.touch(cid, oid);
+	  t.omap_rmkey(cid, oid, "k" + stringify(rng() % 5));
+	  break;
+	default:
+	  t.setattr(cid, oid, "a", bl);
+	  break;
+	}
+      }
+    }
+    return tls;
+  }
+
+  void check_same() {
+    for (unsigned n = 0; n < 4; ++n) {
+      struct stat st1, st2;
+      int r1 = store->stat(plain_ch, obj(n), &st1);
+      int r2 = store->stat(batch_ch, obj(n), &st2);
+      ASSERT_EQ(r1, r2) << obj(n);
+      if (r1 < 0) {
+	continue;
+      }
+      ASSERT_EQ(st1.st_size, st2.st_size) << obj(n);
+      bufferlist d1, d2;
+      ASSERT_EQ(st1.st_size, store->read(plain_ch, obj(n), 0, st1.st_size, d1));
+      ASSERT_EQ(st2.st_size, store->read(batch_ch, obj(n), 0, st2.st_size, d2));
+      ASSERT_TRUE(d1.contents_equal(d2)) << obj(n);
+      bufferlist h1, h2;
+      map<string, bufferlist> o1, o2;
+      ASSERT_EQ(0, store->omap_get(plain_ch, obj(n), &h1, &o1));
+      ASSERT_EQ(0, store->omap_get(batch_ch, obj(n), &h2, &o2));
+      ASSERT_EQ(o1, o2) << obj(n);
+      map<string, bufferlist, less<>> a1, a2;
+      ASSERT_EQ(0, store->getattrs(plain_ch, obj(n), a1));
+      ASSERT_EQ(0, store->getattrs(batch_ch, obj(n), a2));
+      ASSERT_EQ(a1, a2) << obj(n);
+    }
+  }
+};
+
+TEST_F(OpBatchTest, SameResultAsUnbatched)
+{
+  std::mt19937 plain_rng(11), batch_rng(11), flush_rng(5);
+  OpBatch batch;
+  for (unsigned i = 0; i < 500; ++i) {
+    auto plain = make_op(plain_rng, plain_cid);
+    ASSERT_EQ(0, store->queue_transactions(plain_ch, plain));
+
+    auto batched = make_op(batch_rng, batch_cid);
+    batch.add(batched, OpRequestRef());
+    if (flush_rng() % 8 == 0) {
+      ASSERT_EQ(0, batch.submit(store.get(), batch_ch, nullptr));
+      ASSERT_TRUE(batch.empty());
+      ASSERT_TRUE(batch.ops.empty());
+      check_same();
+    }
+  }
+  ASSERT_EQ(0, batch.submit(store.get(), batch_ch, nullptr));
+  check_same();
+}
+
+TEST_F(OpBatchTest, KeepsOpOrder)
+{
+  // later ops of a batch must win over earlier ones on the same object
+  OpBatch batch;
+  for (char c = 'a'; c <= 'e'; ++c) {
+    vector<ObjectStore::Transaction> tls(1);
+    bufferlist bl;
+    bl.append(string(10, c));
+    tls[0].write(batch_cid, obj(0), 0, bl.length(), bl);
+    batch.add(tls, OpRequestRef());
+  }
+  ASSERT_EQ(5u, batch.ops.size());
+  ASSERT_EQ(5u, batch.tls.size());
+  ASSERT_EQ(0, batch.submit(store.get(), batch_ch, nullptr));
+  bufferlist bl;
+  ASSERT_EQ(10, store->read(batch_ch, obj(0), 0, 10, bl));
+  ASSERT_EQ(string(10, 'e'), bl.to_str());
+}
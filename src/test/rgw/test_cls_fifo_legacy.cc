@@ -13,8 +13,10 @@
  */
 
 #include <cerrno>
+#include <chrono>
 #include <iostream>
 #include <string_view>
+#include <thread>
 
 #include "include/scope_guard.h"
 #include "include/types.h"
@@ -527,6 +529,110 @@ TEST_F(LegacyFIFO, TestPushBatch)
   ASSERT_EQ(info.head_part_num, 4);
 }
 
+TEST_F(LegacyFIFO, TestConcurrentPushers)
+{
+  static constexpr auto max_part_size = 2048ull;
+  static constexpr auto max_entry_size = 128ull;
+  static constexpr auto num_pushers = 16u;
+  static constexpr auto pushes_per_pusher = 64u;
+  static constexpr auto max_entries = num_pushers * pushes_per_pusher;
+
+  std::unique_ptr<RCf::FIFO> f;
+  auto r = RCf::FIFO::create(&dp, ioctx, fifo_id, &f, null_yield, std::nullopt,
+			     std::nullopt, false, max_part_size,
+			     max_entry_size);
+  ASSERT_EQ(0, r);
+
+  /* every pusher pushes its own sequence of entries, one at a time */
+  std::vector<std::thread> pushers;
+  std::vector<int> results(num_pushers, 0);
+  for (auto p = 0u; p < num_pushers; ++p) {
+    pushers.emplace_back([&f, &results, p] {
+      for (auto i = 0u; i < pushes_per_pusher; ++i) {
+	cb::list bl;
+	encode(p, bl);
+	encode(i, bl);
+	auto r = f->push(&dp, bl, null_yield);
+	if (r < 0) {
+	  results[p] = r;
+	  return;
+	}
+      }
+    });
+  }
+  for (auto& t : pushers) {
+    t.join();
+  }
+  for (auto r : results) {
+    ASSERT_EQ(0, r);
+  }
+
+  /* all entries are there, each pusher's in the order it pushed them */
+  std::vector<RCf::list_entry> result;
+  bool more = false;
+  r = f->list(&dp, max_entries, std::nullopt, &result, &more, null_yield);
+  ASSERT_EQ(0, r);
+  ASSERT_EQ(false, more);
+  ASSERT_EQ(max_entries, result.size());
+  std::vector<std::uint32_t> next(num_pushers, 0);
+  for (const auto& e : result) {
+    std::uint32_t p, i;
+    auto bi = e.data.cbegin();
+    decode(p, bi);
+    decode(i, bi);
+    ASSERT_LT(p, num_pushers);
+    ASSERT_EQ(next[p], i);
+    ++next[p];
+  }
+
+  /* the part after the head was created ahead of time */
+  auto& info = f->meta();
+  ASSERT_GT(info.head_part_num, 0);
+  ASSERT_GT(info.max_push_part_num, info.head_part_num);
+}
+
+/* throughput of many single-entry pushers; run it explicitly with
+ * --gtest_also_run_disabled_tests --gtest_filter=*BenchConcurrentPushers */
+TEST_F(LegacyFIFO, DISABLED_BenchConcurrentPushers)
+{
+  static constexpr auto num_pushers = 64u;
+  static constexpr auto pushes_per_pusher = 1024u;
+  static constexpr auto max_entries = num_pushers * pushes_per_pusher;
+
+  std::unique_ptr<RCf::FIFO> f;
+  auto r = RCf::FIFO::create(&dp, ioctx, fifo_id, &f, null_yield);
+  ASSERT_EQ(0, r);
+
+  std::vector<std::thread> pushers;
+  std::vector<int> results(num_pushers, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (auto p = 0u; p < num_pushers; ++p) {
+    pushers.emplace_back([&f, &results, p] {
+      for (auto i = 0u; i < pushes_per_pusher; ++i) {
+	cb::list bl;
+	encode(p, bl);
+	encode(i, bl);
+	auto r = f->push(&dp, bl, null_yield);
+	if (r < 0) {
+	  results[p] = r;
+	  return;
+	}
+      }
+    });
+  }
+  for (auto& t : pushers) {
+    t.join();
+  }
+  auto elapsed = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+  for (auto r : results) {
+    ASSERT_EQ(0, r);
+  }
+  std::cout << num_pushers << " pushers pushed " << max_entries
+	    << " entries in " << elapsed << "s ("
+	    << max_entries / elapsed << " entries/s)" << std::endl;
+}
+
 TEST_F(LegacyFIFO, TestAioTrim)
 {
   static constexpr auto max_part_size = 2048ull;
@@ -0,0 +1,93 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw/rgw_arena.h"
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+
+namespace {
+
+// counts the allocations that reach the heap
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  size_t allocations = 0;
+  size_t outstanding = 0;
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    ++outstanding;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    --outstanding;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+} // anonymous namespace
+
+TEST(RequestArena, Inline)
+{
+  CountingResource heap;
+  {
+    rgw::RequestArena arena{&heap};
+    std::pmr::map<int, int> m{&arena};
+    for (int i = 0; i < 16; i++) {
+      m.emplace(i, i);
+    }
+    m.erase(3);
+    m.emplace(3, 3);
+    EXPECT_EQ(16u, m.size());
+    EXPECT_EQ(0u, heap.allocations);
+  }
+  EXPECT_EQ(0u, heap.outstanding);
+}
+
+TEST(RequestArena, Overflow)
+{
+  CountingResource heap;
+  {
+    rgw::RequestArena arena{&heap};
+    std::pmr::map<std::pmr::string, std::pmr::string> m{&arena};
+    for (int i = 0; i < 1000; i++) {
+      m.emplace("HTTP_X_AMZ_META_" + std::to_string(i),
+                std::string(100, 'x'));
+    }
+    EXPECT_EQ(1000u, m.size());
+    EXPECT_EQ(100u, m["HTTP_X_AMZ_META_500"].size());
+    // blocks grow geometrically rather than one per node and string
+    EXPECT_GT(heap.allocations, 0u);
+    EXPECT_LT(heap.allocations, 20u);
+  }
+  // everything is released with the arena
+  EXPECT_EQ(0u, heap.outstanding);
+}
+
+TEST(RequestArena, MapStrings)
+{
+  CountingResource heap;
+  {
+    rgw::RequestArena arena{&heap};
+    // the shape of rgw_env_map_t: keys and values past the small string
+    // buffer are allocated from the arena along with the nodes
+    std::pmr::map<std::pmr::string, std::pmr::string> m{&arena};
+    const std::string_view value = "a header value that doesn't fit in SSO";
+    for (int i = 0; i < 4; i++) {
+      m.emplace("HTTP_X_AMZ_CONTENT_SHA256_" + std::to_string(i), value);
+    }
+    for (const auto& [k, v] : m) {
+      EXPECT_EQ(&arena, k.get_allocator().resource());
+      EXPECT_EQ(&arena, v.get_allocator().resource());
+      EXPECT_EQ(value, v);
+    }
+    EXPECT_EQ(0u, heap.allocations);
+  }
+  EXPECT_EQ(0u, heap.outstanding);
+}
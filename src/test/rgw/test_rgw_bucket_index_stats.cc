@@ -0,0 +1,170 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw/services/svc_bi_rados.h"
+#include "rgw/rgw_common.h"
+#include "cls/rgw/cls_rgw_client.h"
+#include "common/dout.h"
+
+#include <deque>
+#include <optional>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+struct RadosEnv : public ::testing::Environment {
+ public:
+  static constexpr auto poolname = "ceph_test_rgw_bucket_index_stats";
+
+  static std::optional<RGWSI_RADOS> rados;
+
+  void SetUp() override {
+    rados.emplace(g_ceph_context);
+    const NoDoutPrefix no_dpp(g_ceph_context, 1);
+    ASSERT_EQ(0, rados->start(null_yield, &no_dpp));
+    int r = rados->pool({poolname}).create(&no_dpp);
+    if (r == -EEXIST)
+      r = 0;
+    ASSERT_EQ(0, r);
+  }
+  void TearDown() override {
+    rados->shutdown();
+    rados.reset();
+  }
+};
+std::optional<RGWSI_RADOS> RadosEnv::rados;
+
+auto *const rados_env = ::testing::AddGlobalTestEnvironment(new RadosEnv);
+
+class BucketIndexStats : public ::testing::Test {
+ protected:
+  const NoDoutPrefix dpp{g_ceph_context, 1};
+  RGWSI_BucketIndex_RADOS bi{g_ceph_context};
+  std::deque<RGWBucketInfo> buckets;
+
+  void SetUp() override {
+    // the buckets name their index pool, so no zone is needed
+    bi.init(nullptr, &*RadosEnv::rados, nullptr, nullptr);
+  }
+  void TearDown() override {
+    for (auto& info : buckets) {
+      bi.clean_index(&dpp, info);
+    }
+  }
+
+  static std::string shard_oid(const RGWBucketInfo& info, uint32_t shard) {
+    std::string oid = ".dir." + info.bucket.bucket_id;
+    if (info.layout.current_index.layout.normal.num_shards) {
+      oid += "." + std::to_string(shard);
+    }
+    return oid;
+  }
+
+  RGWSI_RADOS::Obj make_obj(const std::string& oid) {
+    auto obj = RadosEnv::rados->obj({{RadosEnv::poolname}, oid});
+    ceph_assert_always(0 == obj.open(&dpp));
+    return obj;
+  }
+
+  // creates a bucket index with the given number of shards. shard i
+  // accounts i + 1 objects of 'size' bytes in the main category, and
+  // some multipart parts that the stats leave out
+  const RGWBucketInfo& make_bucket(const std::string& name,
+                                   uint32_t num_shards, uint64_t size) {
+    RGWBucketInfo info;
+    info.bucket.name = name;
+    info.bucket.bucket_id = name + "." + std::to_string(getpid());
+    info.bucket.explicit_placement.index_pool = rgw_pool{RadosEnv::poolname};
+    info.placement_rule = rgw_placement_rule{"default-placement", "STANDARD"};
+    info.layout.current_index.layout.normal.num_shards = num_shards;
+    ceph_assert_always(0 == bi.init_index(&dpp, info));
+
+    for (uint32_t i = 0; i < std::max(num_shards, 1u); i++) {
+      std::map<RGWObjCategory, rgw_bucket_category_stats> stats;
+      auto& main = stats[RGWObjCategory::Main];
+      main.num_entries = i + 1;
+      main.total_size = (i + 1) * size;
+      main.total_size_rounded = (i + 1) * ((size + 4095) & ~4095ull);
+      auto& multimeta = stats[RGWObjCategory::MultiMeta];
+      multimeta.num_entries = 1;
+      multimeta.total_size = 1000;
+
+      librados::ObjectWriteOperation op;
+      cls_rgw_bucket_update_stats(op, true, stats);
+      auto obj = make_obj(shard_oid(info, i));
+      ceph_assert_always(0 == obj.operate(&dpp, &op, null_yield));
+    }
+    buckets.push_back(std::move(info));
+    return buckets.back();
+  }
+
+  void remove_shard(const RGWBucketInfo& info, uint32_t shard) {
+    librados::ObjectWriteOperation op;
+    op.remove();
+    auto obj = make_obj(shard_oid(info, shard));
+    ASSERT_EQ(0, obj.operate(&dpp, &op, null_yield));
+  }
+
+  int read_batched(const std::vector<const RGWBucketInfo*>& infos,
+                   uint32_t max_aio, std::vector<RGWBucketEnt>& ents) {
+    std::vector<RGWBucketEnt*> results;
+    ents.resize(infos.size());
+    for (auto& ent : ents) {
+      results.push_back(&ent);
+    }
+    return bi.read_stats(&dpp, infos, results, max_aio, null_yield);
+  }
+};
+
+TEST_F(BucketIndexStats, BatchedMatchesPerBucket)
+{
+  const std::vector<const RGWBucketInfo*> infos = {
+    &make_bucket("unsharded", 0, 100),
+    &make_bucket("one-shard", 1, 5000),
+    &make_bucket("seven-shards", 7, 1),
+    &make_bucket("eleven-shards", 11, 123456),
+  };
+
+  std::vector<RGWBucketEnt> expected(infos.size());
+  for (size_t i = 0; i < infos.size(); i++) {
+    ASSERT_EQ(0, bi.read_stats(&dpp, *infos[i], &expected[i], null_yield));
+  }
+  // 7 shards account 1 + 2 + ... + 7 objects
+  EXPECT_EQ(28u, expected[2].count);
+  EXPECT_EQ(28u, expected[2].size);
+
+  // fewer, as many and more reads in flight than the 20 shards
+  for (uint32_t max_aio : {1, 3, 20, 128}) {
+    std::vector<RGWBucketEnt> ents;
+    ASSERT_EQ(0, read_batched(infos, max_aio, ents));
+    for (size_t i = 0; i < infos.size(); i++) {
+      EXPECT_EQ(expected[i].bucket, ents[i].bucket);
+      EXPECT_EQ(expected[i].count, ents[i].count);
+      EXPECT_EQ(expected[i].size, ents[i].size);
+      EXPECT_EQ(expected[i].size_rounded, ents[i].size_rounded);
+      EXPECT_EQ(expected[i].placement_rule, ents[i].placement_rule);
+    }
+  }
+}
+
+TEST_F(BucketIndexStats, MissingShard)
+{
+  const auto& complete = make_bucket("complete", 3, 10);
+  const auto& broken = make_bucket("missing-shard", 5, 10);
+  const auto& after = make_bucket("after", 2, 10);
+  remove_shard(broken, 3);
+
+  RGWBucketEnt ent;
+  EXPECT_EQ(-ENOENT, bi.read_stats(&dpp, broken, &ent, null_yield));
+
+  for (uint32_t max_aio : {1, 128}) {
+    std::vector<RGWBucketEnt> ents;
+    EXPECT_EQ(-ENOENT, read_batched({&complete, &broken, &after}, max_aio, ents));
+    EXPECT_EQ(-ENOENT, read_batched({&broken}, max_aio, ents));
+  }
+
+  // the other buckets still read
+  std::vector<RGWBucketEnt> ents;
+  ASSERT_EQ(0, read_batched({&complete, &after}, 16, ents));
+  EXPECT_EQ(6u, ents[0].count);
+  EXPECT_EQ(3u, ents[1].count);
+}
@@ -0,0 +1,278 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw/services/svc_bucket_sobj.h"
+#include "rgw/services/svc_sys_obj_cache.h"
+#include "common/ceph_context.h"
+#include "common/dout.h"
+
+#include <memory>
+#include <gtest/gtest.h>
+
+namespace {
+
+// counts the copies made of it, standing in for RGWBucketInfo
+struct counted_entry {
+  static inline int copies = 0;
+  std::string value;
+
+  counted_entry() = default;
+  explicit counted_entry(std::string v) : value(std::move(v)) {}
+  counted_entry(const counted_entry& o) : value(o.value) { ++copies; }
+  counted_entry& operator=(const counted_entry& o) {
+    value = o.value;
+    ++copies;
+    return *this;
+  }
+};
+
+using entry_snapshot = std::shared_ptr<const counted_entry>;
+
+auto cct = new CephContext(CEPH_ENTITY_TYPE_CLIENT);
+NoDoutPrefix dpp{cct, ceph_subsys_rgw};
+
+// accepts every chained entry, as the object cache does for cache_info
+// entries that are still current
+class TestSysObjCache : public RGWSI_SysObj_Cache {
+public:
+  int chained = 0;
+
+  TestSysObjCache() : RGWSI_SysObj_Cache(&dpp, cct) {}
+
+  bool chain_cache_entry(const DoutPrefixProvider *dpp,
+                         std::initializer_list<rgw_cache_entry_info *> cache_info_entries,
+                         RGWChainedCache::Entry *chained_entry) override {
+    ++chained;
+    chained_entry->cache->chain_cb(chained_entry->key, chained_entry->data);
+    return true;
+  }
+};
+
+// serves one bucket in place of the metadata backend and counts the reads
+// that get past binfo_cache
+class TestBucketSvc : public RGWSI_Bucket_SObj {
+public:
+  rgw_bucket bucket{"", "bucket", "marker.1"};
+  obj_version version;
+  int ep_reads = 0;
+  int bi_reads = 0;
+
+  explicit TestBucketSvc(RGWSI_SysObj_Cache *cache) : RGWSI_Bucket_SObj(cct) {
+    svc.cache = cache;
+    binfo_cache = std::make_unique<RGWChainedCacheImpl_bucket_info_cache_entry>();
+    version.ver = 1;
+    version.tag = "tag";
+  }
+
+  int read_bucket_entrypoint_info(RGWSI_Bucket_EP_Ctx& ctx,
+                                  const std::string& key,
+                                  RGWBucketEntryPoint *entry_point,
+                                  RGWObjVersionTracker *objv_tracker,
+                                  real_time *pmtime,
+                                  std::map<std::string, bufferlist> *pattrs,
+                                  optional_yield y,
+                                  const DoutPrefixProvider *dpp,
+                                  rgw_cache_entry_info *cache_info,
+                                  boost::optional<obj_version> refresh_version) override {
+    ++ep_reads;
+    if (key != get_entrypoint_meta_key(bucket)) {
+      return -ENOENT;
+    }
+    entry_point->bucket = bucket;
+    return 0;
+  }
+
+protected:
+  int do_read_bucket_instance_info(RGWSI_Bucket_BI_Ctx& ctx,
+                                   const std::string& key,
+                                   RGWBucketInfo *info,
+                                   real_time *pmtime,
+                                   std::map<std::string, bufferlist> *pattrs,
+                                   rgw_cache_entry_info *cache_info,
+                                   boost::optional<obj_version> refresh_version,
+                                   optional_yield y,
+                                   const DoutPrefixProvider *dpp) override {
+    ++bi_reads;
+    if (key != get_bi_meta_key(bucket)) {
+      return -ENOENT;
+    }
+    info->bucket = bucket;
+    info->objv_tracker.read_version = version;
+    (*pattrs)["user.rgw.acl"].append("acl");
+    return 0;
+  }
+};
+
+} // anonymous namespace
+
+TEST(ChainedCache, ValueHitsCopy)
+{
+  RGWChainedCacheImpl<counted_entry> cache;
+  counted_entry e{"v1"};
+  cache.chain_cb("key", &e);
+
+  counted_entry::copies = 0;
+  for (int i = 0; i < 100; i++) {
+    auto found = cache.find("key");
+    ASSERT_TRUE(found);
+  }
+  EXPECT_EQ(100, counted_entry::copies);
+}
+
+TEST(ChainedCache, SnapshotHitsShare)
+{
+  RGWChainedCacheImpl<entry_snapshot> cache;
+  entry_snapshot e = std::make_shared<const counted_entry>("v1");
+  cache.chain_cb("key", &e);
+
+  counted_entry::copies = 0;
+  for (int i = 0; i < 100; i++) {
+    auto found = cache.find("key");
+    ASSERT_TRUE(found);
+    EXPECT_EQ(e.get(), found->get());
+  }
+  EXPECT_EQ(0, counted_entry::copies);
+
+  // a refresh replaces the cached pointer, and readers keep theirs
+  auto held = cache.find("key");
+  ASSERT_TRUE(held);
+  entry_snapshot e2 = std::make_shared<const counted_entry>("v2");
+  cache.chain_cb("key", &e2);
+  EXPECT_EQ("v1", (*held)->value);
+  auto found = cache.find("key");
+  ASSERT_TRUE(found);
+  EXPECT_EQ("v2", (*found)->value);
+
+  cache.invalidate("key");
+  EXPECT_FALSE(cache.find("key"));
+  EXPECT_EQ("v1", (*held)->value);
+  EXPECT_EQ(2, e.use_count()); // e and held
+}
+
+TEST(ChainedCache, BucketInfoReadsShareSnapshot)
+{
+  // what each request reading a cached bucket instance gets, the way the
+  // sync policy handler holds on to it: no copy of the info or attrs
+  RGWChainedCacheImpl<RGWSI_Bucket::bucket_info_snapshot> cache;
+  auto entry = std::make_shared<RGWSI_Bucket::bucket_info_cache_entry>();
+  entry->info.bucket.name = "bucket";
+  entry->attrs["user.rgw.acl"].append("acl");
+  RGWSI_Bucket::bucket_info_snapshot snapshot = entry;
+  cache.chain_cb("bi/bucket", &snapshot);
+
+  std::vector<std::shared_ptr<const RGWBucketInfo>> infos;
+  std::vector<std::shared_ptr<const std::map<std::string, bufferlist>>> attrs;
+  for (int i = 0; i < 100; i++) {
+    auto found = cache.find("bi/bucket");
+    ASSERT_TRUE(found);
+    const auto& e = *found;
+    infos.emplace_back(e, &e->info);
+    attrs.emplace_back(e, &e->attrs);
+    EXPECT_EQ(&entry->info, infos.back().get());
+    EXPECT_EQ(&entry->attrs, attrs.back().get());
+  }
+  // entry, snapshot, the cache and one per reader
+  EXPECT_EQ(203, entry.use_count());
+
+  cache.invalidate("bi/bucket");
+  EXPECT_EQ("bucket", infos.front()->bucket.name);
+  infos.clear();
+  attrs.clear();
+  EXPECT_EQ(2, entry.use_count());
+}
+
+TEST(BucketInfoCache, InstanceSnapshotReadsShareCache)
+{
+  TestSysObjCache cache;
+  TestBucketSvc svc(&cache);
+  RGWSI_Bucket_BI_Ctx ctx;
+  const auto key = RGWSI_Bucket::get_bi_meta_key(svc.bucket);
+
+  RGWSI_Bucket::bucket_info_snapshot first;
+  ASSERT_EQ(0, svc.read_bucket_instance_snapshot(ctx, key, &first, null_yield, &dpp));
+  EXPECT_EQ(1, svc.bi_reads);
+  EXPECT_EQ(1, cache.chained);
+  EXPECT_EQ("bucket", first->info.bucket.name);
+  EXPECT_EQ(1u, first->attrs.count("user.rgw.acl"));
+
+  for (int i = 0; i < 100; i++) {
+    RGWSI_Bucket::bucket_info_snapshot s;
+    ASSERT_EQ(0, svc.read_bucket_instance_snapshot(ctx, key, &s, null_yield, &dpp));
+    EXPECT_EQ(first.get(), s.get());
+  }
+  EXPECT_EQ(1, svc.bi_reads);
+
+  // the copying reader is served from the same entry
+  RGWBucketInfo info;
+  std::map<std::string, bufferlist> attrs;
+  ASSERT_EQ(0, svc.read_bucket_instance_info(ctx, key, &info, nullptr, &attrs,
+                                             null_yield, &dpp));
+  EXPECT_EQ(svc.bucket, info.bucket);
+  EXPECT_EQ(first->attrs.size(), attrs.size());
+  EXPECT_EQ(1, svc.bi_reads);
+
+  // a refresh of the cached version rereads, and the old snapshot stays
+  // valid for whoever still holds it
+  RGWSI_Bucket::bucket_info_snapshot refreshed;
+  ASSERT_EQ(0, svc.read_bucket_instance_snapshot(ctx, key, &refreshed, null_yield,
+                                                 &dpp, nullptr, svc.version));
+  EXPECT_EQ(2, svc.bi_reads);
+  EXPECT_NE(first.get(), refreshed.get());
+  EXPECT_EQ("bucket", first->info.bucket.name);
+
+  RGWSI_Bucket::bucket_info_snapshot s;
+  ASSERT_EQ(0, svc.read_bucket_instance_snapshot(ctx, key, &s, null_yield, &dpp));
+  EXPECT_EQ(refreshed.get(), s.get());
+  EXPECT_EQ(2, svc.bi_reads);
+}
+
+TEST(BucketInfoCache, InstanceSnapshotNotFound)
+{
+  TestSysObjCache cache;
+  TestBucketSvc svc(&cache);
+  RGWSI_Bucket_BI_Ctx ctx;
+  rgw_bucket missing{"", "bucket", "marker.2"};
+  const auto key = RGWSI_Bucket::get_bi_meta_key(missing);
+
+  RGWSI_Bucket::bucket_info_snapshot s;
+  EXPECT_EQ(-ENOENT, svc.read_bucket_instance_snapshot(ctx, key, &s, null_yield, &dpp));
+  EXPECT_FALSE(s);
+  EXPECT_EQ(-ENOENT, svc.read_bucket_instance_snapshot(ctx, key, &s, null_yield, &dpp));
+  EXPECT_EQ(2, svc.bi_reads);
+  EXPECT_EQ(0, cache.chained);
+}
+
+TEST(BucketInfoCache, EntrypointSharesInstanceSnapshot)
+{
+  TestSysObjCache cache;
+  TestBucketSvc svc(&cache);
+  RGWSI_Bucket_X_Ctx ctx;
+  rgw_bucket by_name{"", "bucket", ""};
+
+  RGWSI_Bucket::bucket_info_snapshot first;
+  ASSERT_EQ(0, svc.read_bucket_info_snapshot(ctx, by_name, &first, boost::none,
+                                             null_yield, &dpp));
+  EXPECT_EQ(1, svc.ep_reads);
+  EXPECT_EQ(1, svc.bi_reads);
+  // chained under both bi/ and b/
+  EXPECT_EQ(2, cache.chained);
+  EXPECT_EQ(svc.bucket, first->info.bucket);
+
+  RGWSI_Bucket::bucket_info_snapshot s;
+  ASSERT_EQ(0, svc.read_bucket_info_snapshot(ctx, by_name, &s, boost::none,
+                                             null_yield, &dpp));
+  EXPECT_EQ(first.get(), s.get());
+
+  // a lookup by instance finds the same snapshot
+  ASSERT_EQ(0, svc.read_bucket_info_snapshot(ctx, svc.bucket, &s, boost::none,
+                                             null_yield, &dpp));
+  EXPECT_EQ(first.get(), s.get());
+
+  // and so do the copying readers
+  RGWBucketInfo info;
+  ASSERT_EQ(0, svc.read_bucket_info(ctx, by_name, &info, nullptr, nullptr,
+                                    boost::none, null_yield, &dpp));
+  EXPECT_EQ(svc.bucket, info.bucket);
+  EXPECT_EQ(1, svc.ep_reads);
+  EXPECT_EQ(1, svc.bi_reads);
+}
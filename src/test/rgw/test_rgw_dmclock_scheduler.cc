@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 #include "acconfig.h"
 #include "global/global_context.h"
+#include "common/Formatter.h"
 
 namespace rgw::dmclock {
 
@@ -40,12 +41,12 @@ auto capture(std::optional<error_code>& opt_ec,
 TEST(Queue, SyncRequest)
 {
   ClientCounters counters(g_ceph_context);
-  auto client_info_f = [] (client_id client) -> ClientInfo* {
+  auto client_info_f = [] (const client_key& client) -> ClientInfo* {
                          static ClientInfo clients[] = {
                                                         {1, 1, 1}, //admin: satisfy by reservation
                                                         {0, 1, 1}, //auth: satisfy by priority
                          };
-                         return &clients[static_cast<size_t>(client)];
+                         return &clients[static_cast<size_t>(client.id)];
                        };
   std::atomic <bool> ready = false;
   auto server_ready_f = [&ready]() -> bool { return ready.load();};
@@ -81,12 +82,12 @@ TEST(Queue, RateLimit)
   boost::asio::io_context context;
   ClientCounters counters(g_ceph_context);
   AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                  [] (client_id client) -> ClientInfo* {
+                  [] (const client_key& client) -> ClientInfo* {
       static ClientInfo clients[] = {
         {1, 1, 1}, // admin
         {0, 1, 1}, // auth
       };
-      return &clients[static_cast<size_t>(client)];
+      return &clients[static_cast<size_t>(client.id)];
     }, AtLimit::Reject);
 
   std::optional<error_code> ec1, ec2, ec3, ec4;
@@ -142,12 +143,12 @@ TEST(Queue, AsyncRequest)
   boost::asio::io_context context;
   ClientCounters counters(g_ceph_context);
   AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                  [] (client_id client) -> ClientInfo* {
+                  [] (const client_key& client) -> ClientInfo* {
       static ClientInfo clients[] = {
         {1, 1, 1}, // admin: satisfy by reservation
         {0, 1, 1}, // auth: satisfy by priority
       };
-      return &clients[static_cast<size_t>(client)];
+      return &clients[static_cast<size_t>(client.id)];
 		  }, AtLimit::Reject
 		  );
 
@@ -190,12 +191,101 @@ TEST(Queue, AsyncRequest)
 }
 
 
+TEST(Queue, NamedClients)
+{
+  boost::asio::io_context context;
+  ClientCounters counters(g_ceph_context);
+  ClientStats stats(g_ceph_context);
+  AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
+                  [] (const client_key& client) -> ClientInfo* {
+      static ClientInfo info{0, 1, 0};
+      return &info;
+    });
+  queue.set_client_stats(&stats);
+
+  std::optional<error_code> ec1, ec2, ec3;
+  std::optional<PhaseType> p1, p2, p3;
+
+  auto now = get_time();
+  queue.async_request({client_id::data, "a"}, {}, now, 1, capture(ec1, p1));
+  queue.async_request({client_id::data, "a"}, {}, now, 1, capture(ec2, p2));
+  queue.async_request({client_id::data, "b"}, {}, now, 1, capture(ec3, p3));
+
+  // named clients still count towards their class
+  EXPECT_EQ(3u, counters(client_id::data)->get(queue_counters::l_qlen));
+
+  context.run_for(std::chrono::milliseconds(1));
+  EXPECT_TRUE(context.stopped());
+
+  ASSERT_TRUE(ec1);
+  EXPECT_EQ(boost::system::errc::success, *ec1);
+  ASSERT_TRUE(ec2);
+  EXPECT_EQ(boost::system::errc::success, *ec2);
+  ASSERT_TRUE(ec3);
+  EXPECT_EQ(boost::system::errc::success, *ec3);
+  EXPECT_EQ(0u, counters(client_id::data)->get(queue_counters::l_qlen));
+
+  ceph::JSONFormatter f;
+  std::stringstream errss;
+  ceph::bufferlist out;
+  ASSERT_EQ(0, stats.call("dmclock clients", {}, &f, errss, out));
+  std::stringstream ss;
+  f.flush(ss);
+  const auto dump = ss.str();
+  EXPECT_NE(dump.npos, dump.find(R"("name":"a","qlen":0,"requests":2)")) << dump;
+  EXPECT_NE(dump.npos, dump.find(R"("name":"b","qlen":0,"requests":1)")) << dump;
+}
+
+
+TEST(Queue, NamedClientsFull)
+{
+  g_ceph_context->_conf.set_val_or_die("rgw_dmclock_max_clients", "1");
+  boost::asio::io_context context;
+  ClientCounters counters(g_ceph_context);
+  ClientStats stats(g_ceph_context);
+  AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
+                  [] (const client_key& client) -> ClientInfo* {
+      static ClientInfo info{0, 1, 0};
+      return &info;
+    });
+  queue.set_client_stats(&stats);
+
+  std::optional<error_code> ec1, ec2;
+  std::optional<PhaseType> p1, p2;
+
+  auto now = get_time();
+  queue.async_request({client_id::data, "a"}, {}, now, 1, capture(ec1, p1));
+  // no room for "b", so it shares the data class client
+  queue.async_request({client_id::data, "b"}, {}, now, 1, capture(ec2, p2));
+  EXPECT_EQ(2u, counters(client_id::data)->get(queue_counters::l_qlen));
+
+  context.run_for(std::chrono::milliseconds(1));
+  EXPECT_TRUE(context.stopped());
+
+  ASSERT_TRUE(ec1);
+  EXPECT_EQ(boost::system::errc::success, *ec1);
+  ASSERT_TRUE(ec2);
+  EXPECT_EQ(boost::system::errc::success, *ec2);
+
+  ceph::JSONFormatter f;
+  std::stringstream errss;
+  ceph::bufferlist out;
+  ASSERT_EQ(0, stats.call("dmclock clients", {}, &f, errss, out));
+  std::stringstream ss;
+  f.flush(ss);
+  const auto dump = ss.str();
+  EXPECT_NE(dump.npos, dump.find(R"("name":"a")")) << dump;
+  EXPECT_EQ(dump.npos, dump.find(R"("name":"b")")) << dump;
+  g_ceph_context->_conf.rm_val("rgw_dmclock_max_clients");
+}
+
+
 TEST(Queue, Cancel)
 {
   boost::asio::io_context context;
   ClientCounters counters(g_ceph_context);
   AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                  [] (client_id client) -> ClientInfo* {
+                  [] (const client_key& client) -> ClientInfo* {
       static ClientInfo info{0, 1, 1};
       return &info;
     });
@@ -243,7 +333,7 @@ TEST(Queue, CancelClient)
   boost::asio::io_context context;
   ClientCounters counters(g_ceph_context);
   AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                  [] (client_id client) -> ClientInfo* {
+                  [] (const client_key& client) -> ClientInfo* {
       static ClientInfo info{0, 1, 1};
       return &info;
     });
@@ -299,7 +389,7 @@ TEST(Queue, CancelOnDestructor)
   ClientCounters counters(g_ceph_context);
   {
     AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                    [] (client_id client) -> ClientInfo* {
+                    [] (const client_key& client) -> ClientInfo* {
         static ClientInfo info{0, 1, 1};
         return &info;
       });
@@ -349,7 +439,7 @@ TEST(Queue, CrossExecutorRequest)
   boost::asio::io_context queue_context;
   ClientCounters counters(g_ceph_context);
   AsyncScheduler queue(g_ceph_context, queue_context, std::ref(counters), nullptr,
-                  [] (client_id client) -> ClientInfo* {
+                  [] (const client_key& client) -> ClientInfo* {
       static ClientInfo info{0, 1, 1};
       return &info;
     });
@@ -403,12 +493,12 @@ TEST(Queue, SpawnAsyncRequest)
   spawn::spawn(context, [&] (yield_context yield) {
     ClientCounters counters(g_ceph_context);
     AsyncScheduler queue(g_ceph_context, context, std::ref(counters), nullptr,
-                    [] (client_id client) -> ClientInfo* {
+                    [] (const client_key& client) -> ClientInfo* {
         static ClientInfo clients[] = {
           {1, 1, 1}, // admin: satisfy by reservation
           {0, 1, 1}, // auth: satisfy by priority
         };
-        return &clients[static_cast<size_t>(client)];
+        return &clients[static_cast<size_t>(client.id)];
       });
 
     error_code ec1, ec2;
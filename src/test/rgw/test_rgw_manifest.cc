@@ -333,6 +333,62 @@ TEST(TestRGWManifest, multipart) {
   ASSERT_EQ(m.get_obj_size(), num_parts * part_size);
 }
 
+TEST(TestRGWManifest, multipart_seek) {
+  test_rgw_env env;
+  // parts of different sizes don't share rules, so this manifest is large
+  // enough to be indexed
+  int num_parts = 200;
+  rgw_bucket bucket;
+  uint64_t stripe_size = 4 * 1024 * 1024;
+
+  string upload_id = "abc123";
+
+  RGWObjManifest m;
+  for (int i = 0; i < num_parts; ++i) {
+    uint64_t part_size = 5 * 1024 * 1024 + i * 4096;
+    RGWObjManifest manifest;
+    RGWObjManifest::generator gen;
+    manifest.set_prefix(upload_id);
+    manifest.set_multipart_part_rule(stripe_size, i + 1);
+
+    rgw_placement_rule rule(env.zonegroup.default_placement.name, RGW_STORAGE_CLASS_STANDARD);
+    rgw_obj head;
+    int r = gen.create_begin(g_ceph_context, &manifest, rule, nullptr, bucket, head);
+    ASSERT_EQ(r, 0);
+    for (uint64_t ofs = stripe_size; ofs < part_size; ofs += stripe_size) {
+      gen.create_next(ofs);
+    }
+    gen.create_next(part_size);
+
+    m.append(&dp, manifest, env.zonegroup, env.zone_params);
+  }
+
+  bufferlist bl;
+  encode(m, bl);
+  RGWObjManifest decoded;
+  auto p = bl.cbegin();
+  decode(decoded, p);
+  RGWObjManifest copied = decoded;
+
+  uint64_t num_stripes = 0;
+  RGWObjManifest::obj_iterator iter;
+  for (iter = m.obj_begin(&dp); iter != m.obj_end(&dp); ++iter, ++num_stripes) {
+    const auto location = env.get_raw(iter.get_location());
+    const uint64_t first = iter.get_stripe_ofs();
+    const uint64_t last = first + iter.get_stripe_size() - 1;
+    for (const auto* manifest : {&m, &decoded, &copied}) {
+      for (uint64_t ofs : {first, (first + last) / 2, last}) {
+        auto fiter = manifest->obj_find(&dp, ofs);
+        ASSERT_EQ(first, fiter.get_stripe_ofs());
+        ASSERT_EQ(iter.get_stripe_size(), fiter.get_stripe_size());
+        ASSERT_TRUE(location == env.get_raw(fiter.get_location()));
+      }
+    }
+  }
+  ASSERT_EQ(num_parts * 2, num_stripes);
+  ASSERT_TRUE(decoded.obj_find(&dp, m.get_obj_size()) == decoded.obj_end(&dp));
+}
+
 TEST(TestRGWManifest, old_obj_manifest) {
   test_rgw_env env;
   OldObjManifest old_manifest;
@@ -0,0 +1,37 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw/rgw_query_param.h"
+
+#include <string>
+#include <gtest/gtest.h>
+
+TEST(QueryParam, Lookup)
+{
+  for (size_t i = 0; i < RGW_QP_MAX; i++) {
+    const auto& name = rgw::query_param::names[i];
+    EXPECT_EQ(static_cast<RGWQueryParam>(i), rgw_query_param_lookup(name))
+        << name;
+  }
+  static_assert(rgw_query_param_lookup("uploadId") == RGW_QP_UPLOAD_ID);
+  static_assert(rgw_query_param_lookup("uploads") == RGW_QP_UPLOADS);
+}
+
+TEST(QueryParam, NotFound)
+{
+  // params that don't select an op, and near misses of ones that do
+  const char *others[] = {"", "a", "versionId", "partNumber", "list-type",
+                          "prefix", "max-keys", "X-Amz-Signature", "ACL",
+                          "acls", "ac", "upload", "uploadid", "policystatus",
+                          "tagging ", "response-content-type"};
+  for (const auto name : others) {
+    EXPECT_EQ(RGW_QP_MAX, rgw_query_param_lookup(name)) << name;
+  }
+  // names of the same length, first and last characters hash to the slot
+  // of a param
+  for (const auto& param : rgw::query_param::names) {
+    std::string name{param};
+    name.replace(1, name.size() - 2, name.size() - 2, '_');
+    EXPECT_EQ(RGW_QP_MAX, rgw_query_param_lookup(name)) << param;
+  }
+}
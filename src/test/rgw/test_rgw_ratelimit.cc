@@ -0,0 +1,153 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "rgw/rgw_ratelimit.h"
+
+#include <gtest/gtest.h>
+#include "global/global_context.h"
+
+namespace rgw {
+
+using namespace std::chrono_literals;
+using clock = RateLimiter::clock;
+
+TEST(RateLimiter, Ops)
+{
+  RateLimiter limiter(g_ceph_context);
+  RateLimits limits;
+  limits.read_ops = 60; // one per second
+
+  const auto t0 = clock::now();
+  for (int i = 0; i < 60; i++) {
+    EXPECT_TRUE(limiter.acquire("user:a", limits, true, t0));
+  }
+  EXPECT_FALSE(limiter.acquire("user:a", limits, true, t0));
+  // writes and other keys have their own buckets
+  EXPECT_TRUE(limiter.acquire("user:a", limits, false, t0));
+  EXPECT_TRUE(limiter.acquire("user:b", limits, true, t0));
+
+  // one token drains per second
+  EXPECT_TRUE(limiter.acquire("user:a", limits, true, t0 + 1s));
+  EXPECT_FALSE(limiter.acquire("user:a", limits, true, t0 + 1s));
+  for (int i = 0; i < 60; i++) {
+    EXPECT_TRUE(limiter.acquire("user:a", limits, true, t0 + 61s));
+  }
+}
+
+TEST(RateLimiter, Bytes)
+{
+  RateLimiter limiter(g_ceph_context);
+  RateLimits limits;
+  limits.write_bytes = 60 * 1024;
+
+  const auto t0 = clock::now();
+  // a request may go over the limit, but the next one has to wait for it
+  ASSERT_TRUE(limiter.acquire("bucket:b", limits, false, t0));
+  limiter.charge("bucket:b", false, 120 * 1024);
+  EXPECT_FALSE(limiter.acquire("bucket:b", limits, false, t0 + 30s));
+  EXPECT_FALSE(limiter.acquire("bucket:b", limits, false, t0 + 60s));
+  EXPECT_TRUE(limiter.acquire("bucket:b", limits, false, t0 + 61s));
+  // reads aren't limited
+  EXPECT_TRUE(limiter.acquire("bucket:b", limits, true, t0));
+}
+
+TEST(RateLimiter, Sync)
+{
+  RateLimiter local(g_ceph_context);
+  RateLimiter remote(g_ceph_context);
+  RateLimits limits;
+  limits.write_ops = 10;
+
+  const auto t0 = clock::now();
+  ASSERT_TRUE(local.acquire("user:a", limits, false, t0));
+  for (int i = 0; i < 6; i++) {
+    ASSERT_TRUE(remote.acquire("user:a", limits, false, t0));
+  }
+  remote.charge("user:a", false, 4096);
+
+  auto usage = remote.collect();
+  ASSERT_EQ(1u, usage.size());
+  EXPECT_EQ("user:a", usage[0].key);
+  EXPECT_EQ(6u, usage[0].write_ops);
+  EXPECT_EQ(4096u, usage[0].write_bytes);
+  EXPECT_EQ(0u, usage[0].read_ops);
+  // collect() resets what it returned
+  EXPECT_TRUE(remote.collect().empty());
+
+  using ceph::encode;
+  using ceph::decode;
+  bufferlist bl;
+  encode(usage, bl);
+  std::vector<RateLimitUsage> decoded;
+  auto p = bl.cbegin();
+  decode(decoded, p);
+  for (const auto& u : decoded) {
+    local.apply(u);
+  }
+  // 1 local + 6 remote leaves 3 of 10
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(local.acquire("user:a", limits, false, t0));
+  }
+  EXPECT_FALSE(local.acquire("user:a", limits, false, t0));
+
+  // keys that were never seen locally are ignored
+  local.apply({"user:c", 100, 100, 0, 0});
+  EXPECT_EQ(1u, local.size());
+}
+
+TEST(RateLimiter, Trim)
+{
+  RateLimiter limiter(g_ceph_context);
+  RateLimits limits;
+  limits.read_ops = 60;
+
+  const auto t0 = clock::now();
+  ASSERT_TRUE(limiter.acquire("user:a", limits, true, t0));
+  ASSERT_TRUE(limiter.acquire("user:b", limits, true, t0 + 90s));
+  EXPECT_EQ(2u, limiter.size());
+
+  // not trimmed while it has usage that wasn't synced
+  limiter.trim(t0 + 120s, 60s);
+  EXPECT_EQ(2u, limiter.size());
+
+  limiter.collect();
+  limiter.trim(t0 + 120s, 60s);
+  EXPECT_EQ(1u, limiter.size());
+  limiter.trim(t0 + 180s, 60s);
+  EXPECT_EQ(0u, limiter.size());
+}
+
+TEST(RateLimiter, TrimUnlimitedCounters)
+{
+  RateLimiter limiter(g_ceph_context);
+  RateLimits limits;
+  limits.write_ops = 60;
+
+  // bytes are counted (and synced) without a byte limit, but they must not
+  // keep the entry alive: there is no rate to drain them at
+  const auto t0 = clock::now();
+  ASSERT_TRUE(limiter.acquire("user:a", limits, false, t0));
+  limiter.charge("user:a", false, 1 << 20);
+  limiter.apply({"user:a", 0, 1, 0, 1 << 20});
+  auto usage = limiter.collect();
+  ASSERT_EQ(1u, usage.size());
+  EXPECT_EQ(1u << 20, usage[0].write_bytes);
+
+  limiter.trim(t0 + 120s, 60s);
+  EXPECT_EQ(0u, limiter.size());
+}
+
+TEST(RateLimiter, Enabled)
+{
+  RateLimiter limiter(g_ceph_context);
+  EXPECT_FALSE(limiter.enabled());
+  g_ceph_context->_conf.set_val_or_die("rgw_ratelimit_bucket_write_bytes", "1024");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  EXPECT_TRUE(limiter.enabled());
+  EXPECT_EQ(1024u, limiter.get_bucket_limits().write_bytes);
+  g_ceph_context->_conf.rm_val("rgw_ratelimit_bucket_write_bytes");
+  g_ceph_context->_conf.apply_changes(nullptr);
+  EXPECT_FALSE(limiter.enabled());
+}
+
+} // namespace rgw
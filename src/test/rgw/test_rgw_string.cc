@@ -13,6 +13,7 @@
  */
 
 #include "rgw/rgw_string.h"
+#include <map>
 #include <gtest/gtest.h>
 
 const std::string abc{"abc"};
@@ -74,3 +75,31 @@ TEST(string_join_reserve, delim)
   ASSERT_EQ("abc\ndef", string_join_reserve('\n', abc, def));
   ASSERT_EQ("abcfoodef", string_join_reserve(std::string{"foo"}, abc, def));
 }
+
+TEST(ltstr_nocase_transparent, order)
+{
+  // orders the same as ltstr_nocase
+  const std::string strs[] = {"", "a", "A", "ab", "aB", "abc", "ABD", "b",
+                              "_x", "Z"};
+  const ltstr_nocase_transparent lt;
+  const ltstr_nocase expected;
+  for (const auto& a : strs) {
+    for (const auto& b : strs) {
+      EXPECT_EQ(expected(a, b), lt(a, b)) << a << " < " << b;
+    }
+  }
+}
+
+TEST(ltstr_nocase_transparent, lookup)
+{
+  std::map<std::string, int, ltstr_nocase_transparent> m{
+    {"HTTP_HOST", 1}, {"HTTP_X_AMZ_DATE", 2}, {"HTTP_X_AMZ_CONTENT_SHA256", 3}};
+  auto i = m.find("http_x_amz_date");
+  ASSERT_NE(m.end(), i);
+  EXPECT_EQ(2, i->second);
+  EXPECT_EQ(1u, m.count(std::string_view{"HTTP_HOSTNAME", 9}));
+  EXPECT_EQ(m.end(), m.find("HTTP_X_AMZ"));
+  i = m.lower_bound("HTTP_X_AMZ_");
+  ASSERT_NE(m.end(), i);
+  EXPECT_EQ("HTTP_X_AMZ_CONTENT_SHA256", i->first);
+}